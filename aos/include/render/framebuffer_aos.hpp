@@ -0,0 +1,109 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "render/gamma.hpp"
+#include "render/image_aos.hpp"
+
+namespace render {
+
+  // Framebuffer HDR de acumulación, AoS: 16 bytes por píxel (suma r, g, b en float y nº de
+  // muestras en el cuarto carril, que si no sería relleno). Alineados: un píxel nunca cruza
+  // línea de caché y add() es una sola lectura-modificación-escritura. La cuenta es entera,
+  // como el plano N de FramebufferSOA, y las dos disposiciones dan los mismos resultados.
+  // Permite render progresivo / adaptativo: cada pasada suma muestras y resolve() da la media.
+  struct FramebufferAOS {
+    struct alignas(16) Texel {
+      float r{}, g{}, b{};
+      std::uint32_t n{};  // muestras acumuladas
+    };
+    static_assert(sizeof(Texel) == 16);
+
+    int width{}, height{};
+    std::vector<Texel> data;
+
+    explicit FramebufferAOS(int w, int h) : width(w), height(h) {
+      data.assign(static_cast<std::size_t>(w) * static_cast<std::size_t>(h), Texel{});
+    }
+
+    [[nodiscard]] std::size_t idx(int x, int y) const {
+      return static_cast<std::size_t>(y) * static_cast<std::size_t>(width) +
+             static_cast<std::size_t>(x);
+    }
+
+    // Suma de 'n' muestras de radiancia lineal (sin recortar)
+    void add(int x, int y, float r, float g, float b, std::uint32_t n = 1U) {
+      Texel & t = data[idx(x, y)];
+      t.r += r;
+      t.g += g;
+      t.b += b;
+      t.n += n;
+    }
+
+    [[nodiscard]] std::uint32_t samples(int x, int y) const { return data[idx(x, y)].n; }
+
+    // Media acumulada (0 si el píxel no tiene muestras)
+    void mean(int x, int y, float & r, float & g, float & b) const {
+      Texel const & t = data[idx(x, y)];
+      float const inv = (t.n > 0U) ? 1.0F / static_cast<float>(t.n) : 0.0F;
+      r               = t.r * inv;
+      g               = t.g * inv;
+      b               = t.b * inv;
+    }
+
+    void clear() { data.assign(data.size(), Texel{}); }
+
+    // Estado completo en bruto, para los checkpoints (render/checkpoint.hpp). Numeración
+    // compartida con FramebufferSOA: 1 era el texel AoS con la cuenta en float, 2 es el SoA y
+    // 3 es el texel actual de 16 bytes con la cuenta en uint32.
+    static constexpr std::uint32_t checkpoint_layout = 3U;
+
+    [[nodiscard]] std::array<std::span<std::byte const>, 1> bytes() const {
+      return {std::as_bytes(std::span{data})};
+    }
+
+    [[nodiscard]] std::array<std::span<std::byte>, 1> bytes() {
+      return {std::as_writable_bytes(std::span{data})};
+    }
+
+    // Muestras de todo el buffer (con muestreo adaptativo: el coste real del render)
+    [[nodiscard]] std::uint64_t total_samples() const {
+      std::uint64_t total = 0;
+      for (Texel const & t : data) {
+        total += t.n;
+      }
+      return total;
+    }
+
+    // Imagen de depuración en grises: muestras del píxel / max_n (blanco = max_n o más)
+    [[nodiscard]] ImageAOS samples_image(std::uint32_t max_n) const {
+      ImageAOS img(width, height);
+      for (std::size_t i = 0; i < data.size(); ++i) {
+        std::uint8_t const v = samples_level(data[i].n, max_n);
+        img.data[i]          = ImageAOS::Pixel{v, v, v};
+      }
+      return img;
+    }
+
+    // Media + gamma + cuantización en una pasada, fila a fila (ImageAOS::row)
+    [[nodiscard]] ImageAOS resolve(GammaLut const & lut) const {
+      ImageAOS img(width, height);
+      for (int y = 0; y < height; ++y) {
+        std::span<Texel const> const in{data.data() + idx(0, y), static_cast<std::size_t>(width)};
+        std::span<std::uint8_t> const out = img.row(y);
+        for (std::size_t x = 0; x < in.size(); ++x) {
+          Texel const & t = in[x];
+          float const inv = (t.n > 0U) ? 1.0F / static_cast<float>(t.n) : 0.0F;
+          out[3 * x]      = lut(t.r * inv);
+          out[3 * x + 1]  = lut(t.g * inv);
+          out[3 * x + 2]  = lut(t.b * inv);
+        }
+      }
+      return img;
+    }
+  };
+
+}  // namespace render
@@ -2,8 +2,13 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <span>
+#include <string>
 #include <vector>
 
+#include "render/ppm.hpp"
+#include "render/qoi.hpp"
+
 namespace render {
 
   struct ImageAOS {
@@ -44,6 +49,41 @@ namespace render {
     void set01(int x, int y, double r, double g, double b) {
       set(x, y, clamp01_to_u8(r), clamp01_to_u8(g), clamp01_to_u8(b));
     }
+
+    // Fila y como RGB intercalado (3 * width bytes): por aquí la llena FramebufferAOS::resolve
+    [[nodiscard]] std::span<std::uint8_t> row(int y) {
+      return bytes().subspan(3 * idx(0, y), 3 * static_cast<std::size_t>(width));
+    }
+
+    [[nodiscard]] std::span<std::uint8_t const> row(int y) const {
+      return bytes().subspan(3 * idx(0, y), 3 * static_cast<std::size_t>(width));
+    }
+
+    // Vista de los píxeles como RGB intercalado (Pixel no tiene relleno)
+    [[nodiscard]] std::span<std::uint8_t const> bytes() const {
+      static_assert(sizeof(Pixel) == 3);
+      return {reinterpret_cast<std::uint8_t const *>(data.data()), data.size() * 3};
+    }
+
+    [[nodiscard]] std::span<std::uint8_t> bytes() {
+      static_assert(sizeof(Pixel) == 3);
+      return {reinterpret_cast<std::uint8_t *>(data.data()), data.size() * 3};
+    }
   };
 
+  // Imagen entera en un solo write
+  inline bool write_ppm(std::string const & path, ImageAOS const & img,
+                        PpmFormat format = PpmFormat::P6) {
+    return write_ppm(path, img.width, img.height, img.bytes(), format);
+  }
+
+  // Según la extensión: ".qoi" en QOI (directamente desde las filas), el resto en PPM
+  inline bool write_image(std::string const & path, ImageAOS const & img,
+                          PpmFormat format = PpmFormat::P6) {
+    if (has_qoi_extension(path)) {
+      return write_qoi(path, img.width, img.height, img.bytes());
+    }
+    return write_ppm(path, img, format);
+  }
+
 }  // namespace render
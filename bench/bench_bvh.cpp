@@ -0,0 +1,91 @@
+// Coste por rayo del impacto más cercano: recorrido lineal vs BVH, para escenas de tamaño
+// creciente. Imprime una tabla y el tamaño de escena a partir del cual compensa el BVH.
+#include <cstdint>
+#include <cstdio>
+#include <print>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "render/bvh.hpp"
+#include "render/compiled_scene.hpp"
+#include "render/rng.hpp"
+#include "render/scene.hpp"
+
+namespace {
+
+  render::Scene make_scene(std::size_t n, std::uint64_t seed) {
+    render::counter_rng rng{seed, 0, 0, 0};
+    auto u = [&](double lo, double hi) { return lo + (hi - lo) * rng.next01(); };
+    render::Scene scn;
+    for (std::size_t i = 0; i < n; ++i) {
+      if (i % 4 == 3) {
+        render::Cylinder c;
+        c.base   = {u(-10, 10), u(-10, 10), u(-10, 10)};
+        c.axis   = render::vector{u(-1, 1), u(-1, 1), u(-1, 1)}.normalized();
+        c.height = u(0.1, 0.6);
+        c.radius = u(0.05, 0.3);
+        scn.cylinders.push_back(c);
+      } else {
+        render::Sphere s;
+        s.center = {u(-10, 10), u(-10, 10), u(-10, 10)};
+        s.radius = u(0.05, 0.3);
+        scn.spheres.push_back(s);
+      }
+    }
+    return scn;
+  }
+
+  std::vector<render::ray> make_rays(std::size_t n) {
+    render::counter_rng rng{99ULL, 0, 0, 0};
+    auto u = [&](double lo, double hi) { return lo + (hi - lo) * rng.next01(); };
+    std::vector<render::ray> rays;
+    rays.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      render::vector const target{u(-10, 10), u(-10, 10), u(-10, 10)};
+      render::vector const origin{0, 0, 30};
+      rays.emplace_back(origin, (target - origin).normalized());
+    }
+    return rays;
+  }
+
+}  // namespace
+
+int main() {
+  auto const rays = make_rays(20'000);
+  std::println("{:>8} {:>14} {:>14} {:>9}", "prims", "linear ns/ray", "bvh ns/ray", "speedup");
+
+  std::size_t crossover = 0;
+  for (std::size_t n = 1; n <= 65'536; n *= 2) {
+    auto const scn = render::CompiledScene::compile(make_scene(n, n));
+    auto const bvh = render::Bvh::build(scn);
+
+    // Menos rayos para lineal con escenas grandes: si no, tarda minutos
+    std::size_t const n_lin = (n > 4'096) ? rays.size() / 16 : rays.size();
+
+    double const t_lin = bench::best_of(3, [&] {
+      double acc = 0.0;
+      for (std::size_t i = 0; i < n_lin; ++i) {
+        render::Hit h;
+        acc += render::closest_hit_linear(scn, rays[i], 1e-6, 1e9, &h) ? h.t : 0.0;
+      }
+      bench::keep(acc);
+    });
+    double const t_bvh = bench::best_of(3, [&] {
+      double acc = 0.0;
+      for (auto const & r : rays) {
+        render::Hit h;
+        acc += bvh.closest_hit(scn, r, 1e-6, 1e9, &h) ? h.t : 0.0;
+      }
+      bench::keep(acc);
+    });
+
+    double const ns_lin = 1e9 * t_lin / static_cast<double>(n_lin);
+    double const ns_bvh = 1e9 * t_bvh / static_cast<double>(rays.size());
+    if (crossover == 0 and ns_bvh < ns_lin) {
+      crossover = n;
+    }
+    std::println("{:>8} {:>14.1f} {:>14.1f} {:>8.2f}x", n, ns_lin, ns_bvh, ns_lin / ns_bvh);
+  }
+  std::println("crossover: BVH faster from {} primitives", crossover);
+  return 0;
+}
@@ -0,0 +1,103 @@
+// Acumulación float en el framebuffer bajo el render por tiles: AoS de 16 bytes (float3 y la
+// cuenta en el cuarto carril), AoS float3 + cuenta aparte y SoA planar. Mide el coste por
+// muestra de add() con todos los hilos y el de resolve() a 8 bits.
+#include <cstdint>
+#include <print>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "render/framebuffer_aos.hpp"
+#include "render/framebuffer_soa.hpp"
+#include "render/gamma.hpp"
+#include "render/rng.hpp"
+#include "render/tiles.hpp"
+
+namespace {
+
+  constexpr int W      = 1'920;
+  constexpr int H      = 1'080;
+  constexpr int passes = 8;
+
+  // Variante de comparación: float[3] compacto (12 bytes) y la cuenta en otro array
+  struct FramebufferAOS3 {
+    struct Texel {
+      float r{}, g{}, b{};
+    };
+
+    std::vector<Texel> data;
+    std::vector<std::uint32_t> n;
+
+    FramebufferAOS3() : data(static_cast<std::size_t>(W) * H), n(data.size(), 0U) { }
+
+    void add(int x, int y, float r, float g, float b) {
+      std::size_t const i  = static_cast<std::size_t>(y) * W + static_cast<std::size_t>(x);
+      data[i].r           += r;
+      data[i].g           += g;
+      data[i].b           += b;
+      n[i]                += 1U;
+    }
+  };
+
+  // Muestra sintética barata: el coste lo domina la escritura en el framebuffer
+  inline void sample(int x, int y, int pass, float & r, float & g, float & b) {
+    render::counter_rng rng{1ULL, static_cast<std::uint32_t>(x), static_cast<std::uint32_t>(y),
+                            static_cast<std::uint32_t>(pass)};
+    r = static_cast<float>(rng.next01());
+    g = static_cast<float>(rng.next01());
+    b = static_cast<float>(rng.next01());
+  }
+
+  template <class Fb>
+  double accumulate(Fb & fb, render::TileOptions const & opts) {
+    return bench::best_of(3, [&] {
+      for (int p = 0; p < passes; ++p) {
+        render::render_tiles(W, H, opts, [&](render::Tile const & t) {
+          for (int y = t.y0; y < t.y1; ++y) {
+            for (int x = t.x0; x < t.x1; ++x) {
+              float r{}, g{}, b{};
+              sample(x, y, p, r, g, b);
+              fb.add(x, y, r, g, b);
+            }
+          }
+        });
+      }
+    });
+  }
+
+}  // namespace
+
+int main() {
+  render::TileOptions const opts{32, 0};
+  double const samples = static_cast<double>(W) * H * passes;
+  std::println("{}x{}, {} passes, {} threads", W, H, passes,
+               render::resolve_thread_count(opts.threads));
+
+  render::FramebufferAOS aos4(W, H);
+  FramebufferAOS3 aos3;
+  render::FramebufferSOA soa(W, H);
+
+  // Referencia: solo generar las muestras, sin framebuffer
+  struct Null {
+    static void add(int, int, float r, float, float) { bench::keep(r); }
+  } null;
+
+  double const t_null = accumulate(null, opts);
+  double const t_aos4 = accumulate(aos4, opts);
+  double const t_aos3 = accumulate(aos3, opts);
+  double const t_soa  = accumulate(soa, opts);
+
+  std::println("{:<22} {:>12}", "accumulate", "ns/sample");
+  std::println("{:<22} {:>12.2f}", "samples only", 1e9 * t_null / samples);
+  std::println("{:<22} {:>12.2f}", "AoS float4 (+count)", 1e9 * t_aos4 / samples);
+  std::println("{:<22} {:>12.2f}", "AoS float3 + count[]", 1e9 * t_aos3 / samples);
+  std::println("{:<22} {:>12.2f}", "SoA planes + count[]", 1e9 * t_soa / samples);
+
+  render::GammaLut const lut{2.2};
+  double const px     = static_cast<double>(W) * H;
+  double const r_aos4 = bench::best_of(3, [&] { bench::keep(aos4.resolve(lut).data[7].r); });
+  double const r_soa  = bench::best_of(3, [&] { bench::keep(soa.resolve(lut).R[7]); });
+  std::println("{:<22} {:>12}", "resolve", "ns/pixel");
+  std::println("{:<22} {:>12.2f}", "AoS float4", 1e9 * r_aos4 / px);
+  std::println("{:<22} {:>12.2f}", "SoA planes", 1e9 * r_soa / px);
+  return 0;
+}
@@ -0,0 +1,44 @@
+// Coste de pasar un framebuffer float a 8 bits con gamma: std::pow por canal (como
+// write_ppm_gamma) frente a GammaLut, para una imagen 4K.
+#include <cmath>
+#include <cstdint>
+#include <print>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "render/gamma.hpp"
+#include "render/rng.hpp"
+
+int main() {
+  std::size_t const n = 3840UL * 2160UL * 3UL;
+  std::vector<float> hdr(n);
+  render::counter_rng rng{7ULL, 0, 0, 0};
+  for (auto & v : hdr) {
+    v = static_cast<float>(1.1 * rng.next01());
+  }
+  std::vector<std::uint8_t> out(n);
+
+  double const t_pow = bench::best_of(3, [&] {
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = render::gamma_encode_exact(hdr[i], 2.2);
+    }
+    bench::keep(out[n / 2]);
+  });
+
+  double t_build   = 0.0;
+  double const t_lut = bench::best_of(3, [&] {
+    bench::stopwatch sw;
+    render::GammaLut const lut{2.2};
+    t_build = sw.seconds();
+    lut.resolve(hdr, out);
+    bench::keep(out[n / 2]);
+  });
+
+  double const mb = static_cast<double>(n) / 1e6;
+  std::println("4K RGB ({:.1f} M values)", mb);
+  std::println("  pow per value : {:8.2f} ms  ({:.2f} ns/value)", 1e3 * t_pow, 1e3 * t_pow / mb);
+  std::println("  GammaLut      : {:8.2f} ms  ({:.2f} ns/value, table build {:.2f} ms)",
+               1e3 * t_lut, 1e3 * t_lut / mb, 1e3 * t_build);
+  std::println("  speedup       : {:.1f}x", t_pow / t_lut);
+  return 0;
+}
@@ -0,0 +1,145 @@
+// Rendimiento del parser de escenas: el de referencia (getline + istringstream por línea)
+// contra el de render (mmap + string_view + from_chars), en secuencial y troceando la sección
+// de objetos entre hilos, sobre una escena sintética con materiales, esferas en los tres
+// formatos y cilindros. Imprime MB/s y objetos/s, y lo que cuesta cargar la misma escena
+// (compilada y con BVH) desde la caché binaria, comprobación del hash del texto incluida.
+//
+// Uso: bench-parse [objetos] [hilos]   (por defecto 1'000'000 y los del hardware)
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <print>
+#include <string>
+#include <utility>
+
+#include "bench_util.hpp"
+#include "render/bvh.hpp"
+#include "render/compiled_scene.hpp"
+#include "render/hash.hpp"
+#include "render/mapped_file.hpp"
+#include "render/parser.hpp"
+#include "render/rng.hpp"
+#include "render/scene.hpp"
+#include "render/scene_cache.hpp"
+#include "render/tiles.hpp"
+
+namespace {
+
+  std::string make_scene_file(std::size_t objects) {
+    auto const path = std::filesystem::temp_directory_path() / "bench_parse_scene.txt";
+    std::FILE * out = std::fopen(path.c_str(), "wb");
+    render::counter_rng rng{7ULL, 0, 0, 0};
+    auto u = [&](double lo, double hi) { return lo + (hi - lo) * rng.next01(); };
+    std::print(out, "# escena sintética de bench-parse\n"
+                    "matte ground color 0.8 0.8 0.8\n"
+                    "metal steel color=0.9,0.9,0.9 fuzz=0.1\n"
+                    "refractive glass ior 1.5\n");
+    for (std::size_t i = 0; i < objects; ++i) {
+      switch (i % 4) {
+        case 0:
+          std::println(out, "sphere s{} center={:.6f},{:.6f},{:.6f} radius={:.4f} mat=steel", i,
+                       u(-50, 50), u(-50, 50), u(-50, 50), u(0.05, 0.5));
+          break;
+        case 1:
+          std::println(out, "sphere s{} {:.6f} {:.6f} {:.6f} {:.4f} ground  # n.{}", i,
+                       u(-50, 50), u(-50, 50), u(-50, 50), u(0.05, 0.5), i);
+          break;
+        case 2:
+          std::println(out,
+                       "cylinder c{} {:.6f} {:.6f} {:.6f} {:.4f} {:.4f} {:.4f} {:.3f} {:.3f} glass",
+                       i, u(-50, 50), u(-50, 50), u(-50, 50), u(-1, 1), u(-1, 1), u(-1, 1),
+                       u(0.1, 2.0), u(0.05, 0.5));
+          break;
+        default:
+          std::println(out, "sphere {:.6f} {:.6f} {:.6f} {:.4f}", u(-50, 50), u(-50, 50),
+                       u(-50, 50), u(0.05, 0.5));
+          break;
+      }
+    }
+    std::fclose(out);
+    return path.string();
+  }
+
+}  // namespace
+
+int main(int argc, char * argv[]) {
+  std::size_t const objects =
+      (argc > 1) ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 1'000'000U;
+  unsigned const threads = render::resolve_thread_count(
+      (argc > 2) ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 0U);
+  std::string const path = make_scene_file(objects);
+  double const mb        = static_cast<double>(std::filesystem::file_size(path)) / 1e6;
+  std::println("scene: {} objects, {:.1f} MB, {} threads", objects, mb, threads);
+
+  std::size_t parsed_ref = 0, parsed_fast = 0, parsed_par = 0;
+  double const t_ref = bench::best_of(3, [&] {
+    std::string err;
+    auto const scn = render::try_parse_scene_stream(path, &err);
+    parsed_ref     = scn ? scn->spheres.size() + scn->cylinders.size() : 0U;
+  });
+  double const t_fast = bench::best_of(3, [&] {
+    std::string err;
+    auto const file = render::MappedFile::open(path);
+    auto const scn  = render::try_parse_scene_text(file->text(), path, &err);
+    parsed_fast     = scn ? scn->spheres.size() + scn->cylinders.size() : 0U;
+  });
+  double const t_par = bench::best_of(3, [&] {
+    std::string err;
+    auto const file = render::MappedFile::open(path);
+    auto const scn  = render::try_parse_scene_text_parallel(file->text(), path, &err, threads);
+    parsed_par      = scn ? scn->spheres.size() + scn->cylinders.size() : 0U;
+  });
+  if (parsed_ref != objects or parsed_fast != objects or parsed_par != objects) {
+    std::println(stderr, "parse mismatch: stream {} / mmap {} / parallel {} / expected {}",
+                 parsed_ref, parsed_fast, parsed_par, objects);
+    return 1;
+  }
+
+  // Caché: parse + compile + BVH una vez, luego solo hash + mmap + reparto de spans
+  std::string const cache = path + ".rsc";
+  double t_build          = 0.0;
+  {
+    std::string err;
+    auto const scn = render::try_parse_scene(path, &err);
+    t_build        = bench::best_of(1, [&] {
+      render::CompiledScene const cs = render::CompiledScene::compile(*scn);
+      render::Bvh const bvh          = render::Bvh::build(cs);
+      if (!render::write_scene_cache(cache, *render::hash_file(path), cs, &bvh, &err)) {
+        std::println(stderr, "{}", err);
+      }
+    });
+  }
+  std::size_t cached = 0;
+  double const t_cache = bench::best_of(3, [&] {
+    std::string err;
+    auto const scn = render::load_scene(path, cache, false, &err, nullptr);
+    cached         = (scn and scn->from_cache)
+                         ? scn->scene.spheres().size() + scn->scene.cylinders().size()
+                         : 0U;
+  });
+  if (cached != objects) {
+    std::println(stderr, "scene cache mismatch: {} / expected {}", cached, objects);
+    return 1;
+  }
+
+  std::println("{:>8} {:>10} {:>10} {:>12}", "parser", "ms", "MB/s", "Mobj/s");
+  for (auto const & [name, t] : {
+         std::pair{"stream",   t_ref  },
+         std::pair{"mmap",     t_fast },
+         std::pair{"parallel", t_par  },
+         std::pair{"cache",    t_cache}
+  }) {
+    std::println("{:>8} {:>10.1f} {:>10.1f} {:>12.2f}", name, t * 1e3, mb / t,
+                 static_cast<double>(objects) / t / 1e6);
+  }
+  std::println("speedup: mmap {:.2f}x, parallel {:.2f}x (vs mmap {:.2f}x)", t_ref / t_fast,
+               t_ref / t_par, t_fast / t_par);
+  std::println("cache: {:.1f} ms to load vs {:.1f} ms to parse + {:.1f} ms to compile and "
+               "build the BVH",
+               t_cache * 1e3, t_par * 1e3, t_build * 1e3);
+  std::filesystem::remove(cache);
+  std::filesystem::remove(path);
+  return 0;
+}
@@ -0,0 +1,97 @@
+// Rendimiento del path tracer en Mrays/s (segmentos trazados por segundo) según max_depth,
+// sobre una escena con suelo y esferas de los tres materiales. Un hilo: mide el coste del
+// bucle de rebotes, no el reparto en tiles.
+#include <cstdint>
+#include <cstdio>
+#include <print>
+
+#include "bench_util.hpp"
+#include "render/bvh.hpp"
+#include "render/camera.hpp"
+#include "render/compiled_scene.hpp"
+#include "render/kernel.hpp"
+#include "render/rng.hpp"
+#include "render/scene.hpp"
+
+namespace {
+
+  render::Scene make_scene(std::uint64_t seed) {
+    render::counter_rng rng{seed, 0, 0, 0};
+    auto u = [&](double lo, double hi) { return lo + (hi - lo) * rng.next01(); };
+
+    render::Scene scn;
+    render::Material m;
+    m.name  = "ground";
+    m.color = {0.5, 0.5, 0.5};
+    scn.materials.push_back(m);
+    m.name  = "matte";
+    m.color = {0.7, 0.3, 0.3};
+    scn.materials.push_back(m);
+    m.name  = "metal";
+    m.kind  = render::MaterialKind::Metal;
+    m.color = {0.8, 0.8, 0.9};
+    m.fuzz  = 0.1;
+    scn.materials.push_back(m);
+    m.name = "glass";
+    m.kind = render::MaterialKind::Refractive;
+    m.ior  = 1.5;
+    scn.materials.push_back(m);
+
+    render::Sphere ground;
+    ground.center = {0, -1000, 0};
+    ground.radius = 1000;
+    ground.mat    = 0;
+    scn.spheres.push_back(ground);
+
+    for (int i = 0; i < 300; ++i) {
+      render::Sphere s;
+      s.radius = u(0.15, 0.4);
+      s.center = {u(-10, 10), s.radius, u(-10, 2)};
+      s.mat    = static_cast<std::uint32_t>(1 + i % 3);  // matte, metal, glass
+      scn.spheres.push_back(s);
+    }
+    return scn;
+  }
+
+}  // namespace
+
+int main() {
+  constexpr std::uint32_t width  = 160;
+  constexpr std::uint32_t height = 90;
+  constexpr std::uint32_t spp    = 4;
+
+  auto const scn = render::CompiledScene::compile(make_scene(5ULL));
+  auto const bvh = render::Bvh::build(scn);
+  render::camera const cam{
+    width, height, 40.0, {0, 2, 6},
+      {0, 0.5, -2},
+      {0, 1, 0},
+      spp, 1ULL
+  };
+
+  std::println("{:>6} {:>12} {:>10} {:>10}", "depth", "rays/path", "Mrays/s", "ns/path");
+  for (int depth : {1, 2, 4, 8, 16, 32}) {
+    std::uint64_t segments = 0;
+    double const t         = bench::best_of(3, [&] {
+      double acc = 0.0;
+      segments   = 0;
+      for (std::uint32_t y = 0; y < height; ++y) {
+        for (std::uint32_t x = 0; x < width; ++x) {
+          for (std::uint32_t s = 0; s < spp; ++s) {
+            render::counter_rng rng{1ULL ^ render::path_stream, x, y, s};
+            auto const p = render::trace_path(cam.get_ray<render::Lens::Pinhole>(x, y, s), scn,
+                                              bvh, depth, depth, rng);
+            acc += p.color.x;
+            segments += p.segments;
+          }
+        }
+      }
+      bench::keep(acc);
+    });
+    double const paths = static_cast<double>(width * height * spp);
+    std::println("{:>6} {:>12.2f} {:>10.2f} {:>10.1f}", depth,
+                 static_cast<double>(segments) / paths, static_cast<double>(segments) / t * 1e-6,
+                 1e9 * t / paths);
+  }
+  return 0;
+}
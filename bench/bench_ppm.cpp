@@ -0,0 +1,81 @@
+// Formateo del cuerpo P3 de una imagen 4K: ostream con locale (como el write_ppm_gamma
+// original), to_chars píxel a píxel (la versión anterior de write_ppm) y encode_p3 (tabla de
+// dígitos, trozos en su sitio) con 1 hilo y con N. Uso: bench-ppm [hilos]
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "render/ppm.hpp"
+#include "render/rng.hpp"
+#include "render/tiles.hpp"
+
+namespace {
+
+  std::string ostream_p3(std::vector<std::uint8_t> const & rgb) {
+    std::ostringstream out;
+    for (std::size_t i = 0; i < rgb.size(); i += 3) {
+      out << int{rgb[i]} << ' ' << int{rgb[i + 1]} << ' ' << int{rgb[i + 2]} << '\n';
+    }
+    return out.str();
+  }
+
+  std::string to_chars_p3(std::vector<std::uint8_t> const & rgb) {
+    std::string body;
+    body.reserve(rgb.size() * 4);
+    std::array<char, 4> tmp{};
+    for (std::size_t i = 0; i < rgb.size(); ++i) {
+      auto const res = std::to_chars(tmp.data(), tmp.data() + tmp.size(), int{rgb[i]});
+      body.append(tmp.data(), res.ptr);
+      body += (i % 3 == 2) ? '\n' : ' ';
+    }
+    return body;
+  }
+
+}  // namespace
+
+int main(int argc, char * argv[]) {
+  unsigned const threads =
+      render::resolve_thread_count((argc > 1) ? static_cast<unsigned>(std::atoi(argv[1])) : 0U);
+
+  std::size_t const n = 3840UL * 2160UL * 3UL;
+  std::vector<std::uint8_t> rgb(n);
+  render::counter_rng rng{11ULL, 0, 0, 0};
+  for (auto & v : rgb) {
+    v = static_cast<std::uint8_t>(256.0 * rng.next01());
+  }
+
+  std::string const ref = ostream_p3(rgb);
+  std::string out;
+  bool same = true;
+  auto run  = [&](auto && encode) {
+    return bench::best_of(3, [&] {
+      out  = encode();
+      same = same and out == ref;
+      bench::keep(static_cast<double>(out.size()));
+    });
+  };
+  double const t_stream = run([&] { return ostream_p3(rgb); });
+  double const t_chars  = run([&] { return to_chars_p3(rgb); });
+  double const t_one    = run([&] { return render::encode_p3(rgb, 1U); });
+  // Con un solo hilo la versión paralela es la secuencial: no se repite
+  double const t_par = (threads > 1U) ? run([&] { return render::encode_p3(rgb, threads); })
+                                      : t_one;
+
+  double const mb = static_cast<double>(ref.size()) / 1e6;
+  std::println("4K P3 body: {:.1f} MB of text, {} threads, identical: {}", mb, threads, same);
+  std::println("  ostream              : {:8.2f} ms  ({:7.1f} MB/s)", 1e3 * t_stream,
+               mb / t_stream);
+  std::println("  to_chars             : {:8.2f} ms  ({:7.1f} MB/s)", 1e3 * t_chars, mb / t_chars);
+  std::println("  encode_p3 sequential : {:8.2f} ms  ({:7.1f} MB/s)", 1e3 * t_one, mb / t_one);
+  if (threads > 1U) {
+    std::println("  encode_p3 parallel   : {:8.2f} ms  ({:7.1f} MB/s)", 1e3 * t_par, mb / t_par);
+  }
+  std::println("  speedup vs ostream: {:.1f}x", t_stream / t_par);
+  return same ? 0 : 1;
+}
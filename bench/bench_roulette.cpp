@@ -0,0 +1,191 @@
+// Ruleta rusa vs profundidad fija a igualdad de ruido. Para cada escena y modo se mide el
+// tiempo por muestra (t) y la varianza por muestra del estimador (v, media sobre píxeles de
+// la luminancia). Con N muestras el ruido es v / N, así que el tiempo para llegar a un ruido
+// dado es proporcional a v * t: eso es lo que se compara (menor = mejor).
+//
+// Uso: bench-roulette [escena...]   (por defecto functional/scenes/minimal.txt); las escenas
+// que no se pueden leer se avisan y se saltan. Siempre se añade una escena interna con suelo
+// mate y esferas de los tres materiales, y una espuma de esferas con caminos largos.
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <print>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+#include "render/bvh.hpp"
+#include "render/camera.hpp"
+#include "render/compiled_scene.hpp"
+#include "render/config.hpp"
+#include "render/kernel.hpp"
+#include "render/parser.hpp"
+#include "render/rng.hpp"
+#include "render/scene.hpp"
+
+namespace {
+
+  constexpr std::uint32_t width     = 64;
+  constexpr std::uint32_t height    = 48;
+  constexpr std::uint32_t spp       = 32;
+  constexpr int max_depth           = 32;
+
+  struct Case {
+    std::string name;
+    render::Scene scene;
+    render::Config cfg;
+  };
+
+  render::Scene builtin_scene() {
+    render::Scene scn;
+    render::Material m;
+    m.name  = "ground";
+    m.color = {0.8, 0.8, 0.8};
+    scn.materials.push_back(m);
+    m.name  = "metal";
+    m.kind  = render::MaterialKind::Metal;
+    m.color = {0.9, 0.9, 0.9};
+    m.fuzz  = 0.05;
+    scn.materials.push_back(m);
+    m.name = "glass";
+    m.kind = render::MaterialKind::Refractive;
+    scn.materials.push_back(m);
+
+    render::Sphere s;
+    s.center = {0, -1000, 0};
+    s.radius = 1000;
+    s.mat    = 0;  // ground
+    scn.spheres.push_back(s);
+    s.center = {-1.1, 1, -1};
+    s.radius = 1;
+    s.mat    = 1;  // metal
+    scn.spheres.push_back(s);
+    s.center = {1.1, 1, -1};
+    s.mat    = 2;  // glass
+    scn.spheres.push_back(s);
+    return scn;
+  }
+
+  // Espuma: rejilla densa de esferas mate muy claras alrededor de la cámara; la luz del cielo
+  // entra por los huecos y los caminos rebotan muchas veces antes de salir
+  render::Scene foam_scene() {
+    render::Scene scn;
+    render::Material m;
+    m.name  = "foam";
+    m.color = {0.9, 0.9, 0.9};
+    scn.materials.push_back(m);
+    for (int i = -4; i <= 4; ++i) {
+      for (int j = -4; j <= 4; ++j) {
+        for (int k = -4; k <= 4; ++k) {
+          render::Sphere s;
+          s.center = {2.0 * i + 1.0, 2.0 * j + 1.0, 2.0 * k + 1.0};
+          s.radius = 0.95;
+          s.mat    = 0;  // foam
+          scn.spheres.push_back(s);
+        }
+      }
+    }
+    return scn;
+  }
+
+  // Config hermano en functional/configs con el mismo nombre, si existe y se puede leer
+  render::Config sibling_config(std::filesystem::path const & scene) {
+    auto const cfg_path = scene.parent_path().parent_path() / "configs" / scene.filename();
+    std::string err;
+    if (std::filesystem::exists(cfg_path)) {
+      if (auto cfg = render::try_parse_config(cfg_path.string(), &err)) {
+        return *cfg;
+      }
+      std::println(stderr, "{}: using default camera ({})", cfg_path.string(), err);
+    }
+    return render::Config{};
+  }
+
+  struct Stats {
+    double seconds_per_sample{};
+    double variance{};  // varianza por muestra, media de píxeles
+    double segments{};  // segmentos por camino
+  };
+
+  Stats measure(render::CompiledScene const & scn, render::Bvh const & bvh,
+                render::camera const & cam, int rr_depth) {
+    std::uint64_t segments = 0;
+    double var_sum         = 0.0;
+    double const t         = bench::best_of(2, [&] {
+      segments = 0;
+      var_sum  = 0.0;
+      for (std::uint32_t y = 0; y < height; ++y) {
+        for (std::uint32_t x = 0; x < width; ++x) {
+          double mean = 0.0, m2 = 0.0;  // Welford
+          for (std::uint32_t s = 0; s < spp; ++s) {
+            render::counter_rng rng{7ULL ^ render::path_stream, x, y, s};
+            auto const p = render::trace_path(cam.get_ray(x, y, s), scn, bvh, max_depth,
+                                              rr_depth, rng);
+            double const lum = 0.2126 * p.color.x + 0.7152 * p.color.y + 0.0722 * p.color.z;
+            double const d   = lum - mean;
+            mean += d / static_cast<double>(s + 1U);
+            m2 += d * (lum - mean);
+            segments += p.segments;
+          }
+          var_sum += m2 / static_cast<double>(spp - 1U);
+        }
+      }
+      bench::keep(var_sum);
+    });
+    double const paths = static_cast<double>(width) * height * spp;
+    return {t / paths, var_sum / (static_cast<double>(width) * height),
+            static_cast<double>(segments) / paths};
+  }
+
+}  // namespace
+
+int main(int argc, char ** argv) {
+  std::vector<std::filesystem::path> files;
+  for (int i = 1; i < argc; ++i) {
+    files.emplace_back(argv[i]);
+  }
+  if (files.empty()) {
+    files.emplace_back("functional/scenes/minimal.txt");
+  }
+
+  std::vector<Case> cases;
+  for (auto const & f : files) {
+    std::string err;
+    if (auto scn = render::try_parse_scene(f.string(), &err)) {
+      cases.push_back({f.filename().string(), std::move(*scn), sibling_config(f)});
+    } else {
+      std::println(stderr, "skipping {}: {}", f.string(), err);
+    }
+  }
+  render::Config builtin;
+  builtin.lookfrom = {0, 2, 5};
+  builtin.lookat   = {0, 0.8, -1};
+  cases.push_back({"builtin", builtin_scene(), builtin});
+  render::Config foam;
+  foam.lookfrom = {0, 0, 0};
+  foam.lookat   = {1, 1, -1};
+  cases.push_back({"foam", foam_scene(), foam});
+
+  std::println("{:>12} {:>10} {:>10} {:>12} {:>10} {:>12}", "scene", "mode", "rays/path",
+               "ns/sample", "variance", "rel. time");
+  for (auto const & c : cases) {
+    auto const scn = render::CompiledScene::compile(c.scene);
+    auto const bvh = render::Bvh::build(scn);
+    render::camera const cam{width,    height, c.cfg.vertical_fov_deg, c.cfg.lookfrom,
+                             c.cfg.lookat, c.cfg.vup, spp, c.cfg.seed};
+
+    Stats const fixed = measure(scn, bvh, cam, max_depth);
+    double const cost = fixed.variance * fixed.seconds_per_sample;
+    auto row          = [&](char const * mode, Stats const & s) {
+      std::println("{:>12} {:>10} {:>10.2f} {:>12.1f} {:>10.5f} {:>12.3f}", c.name, mode,
+                   s.segments, 1e9 * s.seconds_per_sample, s.variance,
+                   (cost > 0.0) ? s.variance * s.seconds_per_sample / cost : 0.0);
+    };
+    row("fixed", fixed);
+    for (int rr : {1, 3, 5}) {
+      std::string const mode = "rr@" + std::to_string(rr);
+      row(mode.c_str(), measure(scn, bvh, cam, rr));
+    }
+  }
+  return 0;
+}
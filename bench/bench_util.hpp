@@ -0,0 +1,39 @@
+#pragma once
+#include <chrono>
+
+namespace bench {
+
+  // Cronómetro de pared en segundos
+  class stopwatch {
+  public:
+    stopwatch() : m_start(std::chrono::steady_clock::now()) { }
+
+    [[nodiscard]] double seconds() const {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+  private:
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+  // Ejecuta fn() 'reps' veces y devuelve el mejor tiempo (s): menos ruido que la media
+  template <class F>
+  double best_of(int reps, F && fn) {
+    double best = 1e300;
+    for (int i = 0; i < reps; ++i) {
+      stopwatch sw;
+      fn();
+      double const s = sw.seconds();
+      best           = (s < best) ? s : best;
+    }
+    return best;
+  }
+
+  // Evita que el optimizador elimine un resultado que no se usa
+  inline volatile double sink = 0.0;
+
+  inline void keep(double v) {
+    sink = v;
+  }
+
+}  // namespace bench
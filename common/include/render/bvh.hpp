@@ -0,0 +1,107 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "render/compiled_scene.hpp"
+#include "render/ray.hpp"
+#include "render/scene.hpp"
+#include "render/vector.hpp"
+
+namespace render {
+
+  // Caja alineada con los ejes
+  struct Aabb {
+    vector lo{+1e300, +1e300, +1e300};
+    vector hi{-1e300, -1e300, -1e300};
+
+    void grow(vector const & p);
+    void grow(Aabb const & b);
+
+    [[nodiscard]] vector centroid() const { return (lo + hi) * 0.5; }
+
+    [[nodiscard]] double surface_area() const;
+
+    [[nodiscard]] bool empty() const { return lo.x > hi.x; }
+  };
+
+  [[nodiscard]] Aabb bounds_of(Sphere const & s);
+  [[nodiscard]] Aabb bounds_of(Cylinder const & c);  // cilindro con tapas (axis normalizado)
+  [[nodiscard]] Aabb bounds_of(CylinderPre const & c, double radius);
+
+  enum class PrimKind : std::uint8_t { Sphere, Cylinder };
+
+  // Resultado de una consulta de impacto más cercano
+  struct Hit {
+    double t{};
+    vector normal;
+    PrimKind kind{PrimKind::Sphere};
+    std::uint32_t index{};  // índice en spheres() o cylinders() según kind
+  };
+
+  // BVH binaria construida con SAH por bins sobre esferas y cilindros de una CompiledScene.
+  // Guarda índices a la escena, así que la escena debe sobrevivir al BVH y no cambiar.
+  class Bvh {
+  public:
+    static constexpr int num_bins      = 16;
+    static constexpr int max_leaf_size = 4;
+
+    [[nodiscard]] static Bvh build(CompiledScene const & scn);
+
+    // Impacto más cercano en [t_min, t_max]. Misma semántica que el bucle lineal sobre
+    // hit_sphere / hit_cylinder. Devuelve false si el rayo no toca nada.
+    [[nodiscard]] bool closest_hit(CompiledScene const & scn, ray const & r, double t_min,
+                                   double t_max, Hit * out) const;
+
+    [[nodiscard]] std::size_t node_count() const { return m_nodes.size(); }
+
+    [[nodiscard]] std::size_t prim_count() const { return m_prim_ids.size(); }
+
+    // Volcado crudo para la caché de escena (scene_cache.hpp): los nodos tal cual están en
+    // memoria (node_size bytes cada uno) y los índices de primitiva de las hojas
+    [[nodiscard]] std::span<std::byte const> node_bytes() const {
+      return std::as_bytes(std::span{m_nodes});
+    }
+
+    [[nodiscard]] std::span<std::uint32_t const> prim_ids() const { return m_prim_ids; }
+
+    // Inverso de node_bytes() / prim_ids() para una escena con esas cantidades. Comprueba que
+    // la estructura es recorrible (hijos e índices en rango, profundidad acotada); si no,
+    // nullopt.
+    [[nodiscard]] static std::optional<Bvh> from_bytes(std::span<std::byte const> nodes,
+                                                       std::span<std::uint32_t const> prim_ids,
+                                                       std::size_t spheres,
+                                                       std::size_t cylinders);
+
+  private:
+    struct PrimRef {
+      PrimKind kind;
+      std::uint32_t index;
+    };
+
+    // Nodo interior: count == 0 y los hijos son 'first' y 'first + 1'.
+    // Hoja: m_prim_ids[first, first + count); las 'spheres' primeras son esferas (se prueban
+    // juntas con hit_spheres_wide) y el resto cilindros.
+    struct Node {
+      Aabb box;
+      std::uint32_t first{0};
+      std::uint32_t count{0};
+      std::uint32_t spheres{0};
+    };
+
+    std::vector<Node> m_nodes;
+    std::vector<std::uint32_t> m_prim_ids;
+
+    friend struct BvhBuilder;
+
+  public:
+    static constexpr std::size_t node_size = sizeof(Node);
+  };
+
+  // Referencia de fuerza bruta: recorre todas las esferas y luego todos los cilindros.
+  [[nodiscard]] bool closest_hit_linear(CompiledScene const & scn, ray const & r, double t_min,
+                                        double t_max, Hit * out);
+
+}  // namespace render
@@ -1,13 +1,16 @@
 #pragma once
 
 #include <cstdint>
-#include <random>
 
 #include "render/ray.hpp"
+#include "render/sampler.hpp"
 #include "render/vector.hpp"
 
 namespace render {
 
+  // Modelo de lente: pinhole (aperture 0) o lente fina con desenfoque (DOF)
+  enum class Lens : std::uint8_t { Pinhole, Thin };
+
   class camera {
   public:
     // EXISTENTE: pinhole (compatibilidad).
@@ -19,9 +22,21 @@ namespace render {
     camera(std::uint32_t image_width, std::uint32_t image_height, double vfov_deg,
            vector const & lookfrom, vector const & lookat, vector const & vup,
            std::uint32_t samples_per_pixel, std::uint64_t seed, double aperture,
-           double focus_dist);  // <-- NUEVO
+           double focus_dist,  // <-- NUEVO
+           SamplerKind sampler = SamplerKind::Random);
+
+    // Sin estado mutable: el jitter del píxel y el punto de la lente salen del sampler
+    // (dimensiones dim_pixel y dim_lens) con clave (seed, px, py, sample_id), así que se puede
+    // llamar desde varios hilos a la vez y la muestra no depende del orden en que se recorren
+    // los píxeles. Con SamplerKind::Random el jitter es el mismo counter_rng de siempre.
+    [[nodiscard]] ray get_ray(std::uint32_t px, std::uint32_t py, std::uint32_t sample_id) const;
+
+    // Igual que get_ray pero con la lente fijada al compilar (sin la rama por rayo). Con
+    // Lens::Pinhole se ignora la apertura; usar lens() para elegir la especialización.
+    template <Lens L>
+    [[nodiscard]] ray get_ray(std::uint32_t px, std::uint32_t py, std::uint32_t sample_id) const;
 
-    [[nodiscard]] ray get_ray(std::uint32_t px, std::uint32_t py, std::uint32_t sample_id);
+    [[nodiscard]] Lens lens() const { return (m_lens_radius <= 0.0) ? Lens::Pinhole : Lens::Thin; }
 
     [[nodiscard]] std::uint32_t image_width() const { return m_image_width; }
 
@@ -29,6 +44,11 @@ namespace render {
 
     [[nodiscard]] std::uint32_t spp() const { return m_samples_per_pixel; }
 
+    // Rejilla de Stratified para spp(), calculada al construir la cámara
+    [[nodiscard]] StrataGrid strata() const { return m_strata; }
+
+    [[nodiscard]] SamplerKind sampler() const { return m_sampler; }
+
     [[nodiscard]] vector origin() const { return m_origin; }
 
   private:
@@ -38,6 +58,7 @@ namespace render {
 
     // Config de muestreo
     std::uint32_t m_samples_per_pixel;
+    StrataGrid m_strata;
 
     // Base geométrica de la cámara
     vector m_origin;             // O
@@ -49,13 +70,18 @@ namespace render {
     vector m_pixel_delta_u;
     vector m_pixel_delta_v;
 
-    // RNG por cámara (reproducible)
-    std::mt19937_64 m_rng;
-    std::uniform_real_distribution<double> m_dist;
+    // Semilla del RNG por muestra (reproducible) y secuencia de puntos
+    std::uint64_t m_seed;
+    SamplerKind m_sampler{SamplerKind::Random};
 
     // ===== NUEVO (para DOF) =====
     double m_lens_radius{0.0};  // = aperture/2, 0 => pinhole
     vector m_u, m_v, m_w;       // base de cámara para desplazar el origen en la lente
   };
 
+  extern template ray camera::get_ray<Lens::Pinhole>(std::uint32_t, std::uint32_t,
+                                                     std::uint32_t) const;
+  extern template ray camera::get_ray<Lens::Thin>(std::uint32_t, std::uint32_t,
+                                                  std::uint32_t) const;
+
 }  // namespace render
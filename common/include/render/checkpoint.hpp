@@ -0,0 +1,71 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include "render/settings.hpp"
+
+namespace render {
+
+  // Checkpoint del render progresivo: el framebuffer de acumulación tal cual (sumas y nº de
+  // muestras de cada píxel). No hace falta guardar el estado del RNG: counter_rng y los
+  // samplers no tienen estado y la muestra siguiente de un píxel es la nº samples(x, y), así
+  // que el contador del píxel ES su posición en la secuencia. Seguir desde un checkpoint da
+  // bit a bit la misma imagen que no haber parado.
+  //
+  // Fichero: CheckpointHeader y detrás las partes del framebuffer (framebuffer.bytes()) una
+  // tras otra, en el orden de bytes de la máquina.
+  struct CheckpointHeader {
+    std::array<char, 4> magic{'R', 'C', 'K', 'P'};
+    std::uint32_t version{1};
+    std::uint32_t layout{};  // Framebuffer::checkpoint_layout del que lo escribió
+    std::uint32_t width{}, height{};
+    std::uint32_t reserved{};
+    std::uint64_t fingerprint{};  // checkpoint_fingerprint(): ajustes + escena
+    std::uint64_t payload_bytes{};
+  };
+  static_assert(sizeof(CheckpointHeader) == 40);
+
+  // Lo que tiene que coincidir para poder seguir
+  struct CheckpointKey {
+    std::uint32_t layout{};
+    std::uint64_t fingerprint{};
+    int width{}, height{};
+  };
+
+  // Huella de todo lo que cambia las muestras (cámara, spp, semilla, sampler, profundidad)
+  // más la de la escena. Gamma, formato, tiles o hilos no entran: no cambian la suma.
+  [[nodiscard]] std::uint64_t checkpoint_fingerprint(RenderSettings const & s,
+                                                     std::uint64_t scene_hash);
+
+  // Escribe en path + ".tmp" y renombra: si el proceso muere a mitad, el checkpoint anterior
+  // sigue intacto. false (y el motivo en *err) si falla.
+  [[nodiscard]] bool write_checkpoint(std::string const & path, CheckpointKey const & key,
+                                      std::span<std::span<std::byte const> const> parts,
+                                      std::string * err);
+
+  // Rellena 'parts' desde el fichero si la cabecera coincide con 'key' y el tamaño cuadra (se
+  // comprueba todo antes de leer el primer byte de datos); si no, false y el motivo en *err
+  [[nodiscard]] bool read_checkpoint(std::string const & path, CheckpointKey const & key,
+                                     std::span<std::span<std::byte> const> parts,
+                                     std::string * err);
+
+  template <class Framebuffer>
+  [[nodiscard]] bool save_checkpoint(std::string const & path, std::uint64_t fingerprint,
+                                     Framebuffer const & fb, std::string * err) {
+    auto const parts = fb.bytes();
+    CheckpointKey const key{Framebuffer::checkpoint_layout, fingerprint, fb.width, fb.height};
+    return write_checkpoint(path, key, parts, err);
+  }
+
+  template <class Framebuffer>
+  [[nodiscard]] bool load_checkpoint(std::string const & path, std::uint64_t fingerprint,
+                                     Framebuffer & fb, std::string * err) {
+    auto const parts = fb.bytes();
+    CheckpointKey const key{Framebuffer::checkpoint_layout, fingerprint, fb.width, fb.height};
+    return read_checkpoint(path, key, parts, err);
+  }
+
+}  // namespace render
@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+#include "render/hits.hpp"
+#include "render/scene.hpp"
+#include "render/vector.hpp"
+
+namespace render {
+
+  // Material listo para el bucle de rebotes: sin nombre, indexado por el id de la primitiva
+  struct MaterialPre {
+    MaterialKind kind{MaterialKind::Matte};
+    vector albedo{1.0, 1.0, 1.0};
+    double fuzz{0.0};
+    double ior{1.5};
+  };
+
+  // Lo que usan las primitivas sin material (no_material): mate gris
+  inline constexpr MaterialPre default_material{
+    MaterialKind::Matte, {0.5, 0.5, 0.5},
+     0.0, 1.5
+  };
+
+  // Vista de uno de los arrays del bloque: de solo lectura salvo para quien lo rellena
+  // (CompiledScene::compile), que usa la variante Writable
+  template <class T, bool Writable>
+  using ArenaSpan = std::span<std::conditional_t<Writable, T, T const>>;
+
+  // Esferas en SoA. Cada array empieza en un límite de 64 bytes (línea de caché).
+  template <bool Writable = false>
+  struct BasicSphereArrays {
+    ArenaSpan<double, Writable> cx, cy, cz;
+    ArenaSpan<double, Writable> radius;
+    ArenaSpan<double, Writable> r2;     // radius²
+    ArenaSpan<double, Writable> inv_r;  // 1 / radius
+    ArenaSpan<std::uint32_t, Writable> mat;
+
+    [[nodiscard]] std::size_t size() const { return cx.size(); }
+
+    [[nodiscard]] vector center(std::size_t i) const { return {cx[i], cy[i], cz[i]}; }
+  };
+
+  using SphereArrays = BasicSphereArrays<>;
+
+  // Cilindros con tapas en SoA, con el eje ya normalizado y el centro de ambas tapas.
+  template <bool Writable = false>
+  struct BasicCylinderArrays {
+    ArenaSpan<double, Writable> p0x, p0y, p0z;  // centro tapa inferior (base)
+    ArenaSpan<double, Writable> p1x, p1y, p1z;  // centro tapa superior (base + height * ax)
+    ArenaSpan<double, Writable> axx, axy, axz;  // eje normalizado
+    ArenaSpan<double, Writable> height;
+    ArenaSpan<double, Writable> radius;
+    ArenaSpan<double, Writable> r2;  // radius²
+    ArenaSpan<std::uint32_t, Writable> mat;
+
+    [[nodiscard]] std::size_t size() const { return p0x.size(); }
+
+    [[nodiscard]] CylinderPre pre(std::size_t i) const {
+      return CylinderPre{
+        {p0x[i], p0y[i], p0z[i]},
+        {p1x[i], p1y[i], p1z[i]},
+        {axx[i], axy[i], axz[i]},
+        height[i], r2[i]
+      };
+    }
+  };
+
+  using CylinderArrays = BasicCylinderArrays<>;
+
+  // Representación de la escena que usa el bucle de render: solo datos de intersección, sin
+  // nombres ni strings, con todo lo que no depende del rayo ya precalculado. Se genera una vez
+  // tras try_parse_scene. Todos los arrays viven en un único bloque alineado a 64 bytes; las
+  // copias comparten ese bloque (es inmutable una vez compilado: las vistas que da son de
+  // solo lectura y el bloque puede ser una proyección de la caché).
+  class CompiledScene {
+  public:
+    static constexpr std::size_t alignment = 64;
+
+    [[nodiscard]] static CompiledScene compile(Scene const & scn);
+
+    [[nodiscard]] SphereArrays const & spheres() const { return m_spheres; }
+
+    [[nodiscard]] CylinderArrays const & cylinders() const { return m_cylinders; }
+
+    [[nodiscard]] std::span<MaterialPre const> materials() const { return m_materials; }
+
+    // Material por id (el de spheres().mat / cylinders().mat); no_material -> default_material
+    [[nodiscard]] MaterialPre const & material(std::uint32_t id) const {
+      return (id < m_materials.size()) ? m_materials[id] : default_material;
+    }
+
+    // Tamaño en bytes del bloque de datos
+    [[nodiscard]] std::size_t bytes() const { return m_bytes; }
+
+    // El bloque de datos tal cual (lo que guarda la caché de escena)
+    [[nodiscard]] std::span<std::byte const> data() const { return {m_storage.get(), m_bytes}; }
+
+    // Tamaño del bloque para esas cantidades de esferas, cilindros y materiales
+    [[nodiscard]] static std::size_t bytes_for(std::size_t spheres, std::size_t cylinders,
+                                               std::size_t materials);
+
+    // Escena sobre un bloque ya relleno (el data() de otra con las mismas cantidades, p. ej.
+    // proyectado desde la caché): no copia nada, solo vuelve a repartir los arrays sobre él.
+    // nullopt si el bloque no está alineado a 'alignment' o no mide bytes_for(...).
+    [[nodiscard]] static std::optional<CompiledScene>
+        adopt(std::shared_ptr<std::byte const> block, std::size_t bytes, std::size_t spheres,
+              std::size_t cylinders, std::size_t materials);
+
+  private:
+    std::shared_ptr<std::byte const> m_storage;
+    std::size_t m_bytes{0};
+    SphereArrays m_spheres;
+    CylinderArrays m_cylinders;
+    std::span<MaterialPre const> m_materials;
+  };
+
+}  // namespace render
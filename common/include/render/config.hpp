@@ -1,5 +1,6 @@
 #pragma once
 
+#include "render/sampler.hpp"
 #include "render/vector.hpp"
 #include <cstdint>
 
@@ -27,10 +28,27 @@ namespace render {
     double aperture{0.0};    // diámetro efectivo del diafragma (0 => pinhole)
     double focus_dist{1.0};  // distancia de enfoque ( > 0 )
     int max_depth{5};        // rebotes máximos del path ( >= 1 )
+    int rr_depth{5};         // rebotes antes de la ruleta rusa ( >= 0; >= max_depth: sin ruleta)
 
     // Muestreo y RNG
-    std::uint32_t samples_per_pixel{4};
+    std::uint32_t samples_per_pixel{4};  // máximo por píxel si el muestreo es adaptativo
+
+    // Muestreo adaptativo: se para cuando el error estándar relativo de la luminancia del
+    // píxel baja de adaptive_threshold (0 => desactivado, todas las muestras)
+    double adaptive_threshold{0.0};
+    std::uint32_t min_samples{4};  // mínimo por píxel antes de poder parar
     std::uint64_t seed{42ULL};
+    SamplerKind sampler{SamplerKind::Sobol};  // jitter del píxel y punto de la lente
+
+    // Render progresivo: pasadas de 1 muestra por píxel hasta samples_per_pixel o hasta
+    // agotar time_budget segundos, con una salida intermedia cada preview_interval segundos
+    // (0 => sin límite / sin salidas intermedias; ambos a 0 => render normal)
+    double time_budget{0.0};
+    double preview_interval{0.0};
+
+    // Checkpoint del framebuffer cada checkpoint_interval segundos (0 => ninguno; implica
+    // render progresivo) para poder seguir con --resume
+    double checkpoint_interval{0.0};
 
     // --- NUEVO: gamma configurable (default 2.2) ---
     // De momento no lo usamos; más adelante conectaremos parser -> writer PPM.
@@ -0,0 +1,67 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace render {
+
+  // Codificación gamma + cuantización a 8 bits sin std::pow por muestra.
+  //
+  // Referencia exacta: lround(pow(clamp(v, 0, 1), 1 / gamma) * 255). Como es monótona, basta
+  // con guardar para cada nivel k el menor float que ya da k (umbral) y, para arrancar cerca,
+  // una tabla de 'buckets' uniformes en [0, 1] con el nivel de su extremo inferior. Resolver
+  // un valor es un índice + uno o dos avances sobre los umbrales: el resultado es idéntico al
+  // de la referencia para cualquier float (error acotado a 0, ver test_gamma.cpp).
+  class GammaLut {
+  public:
+    static constexpr std::size_t buckets = 4'096;
+
+    // gamma <= 0 usa 2.2, igual que write_ppm_gamma
+    explicit GammaLut(double gamma);
+
+    [[nodiscard]] double gamma() const { return m_gamma; }
+
+    // NaN y negativos -> 0, >= 1 -> 255
+    [[nodiscard]] std::uint8_t operator()(float v) const {
+      if (!(v > 0.0F)) {
+        return 0;
+      }
+      if (v >= 1.0F) {
+        return 255;
+      }
+      auto const b  = static_cast<std::size_t>(v * static_cast<float>(buckets));
+      std::size_t k = m_start[b];
+      // Casi siempre basta un paso (sin rama); solo los buckets más oscuros avanzan más
+      k += static_cast<std::size_t>(v >= m_threshold[k + 1]);
+      while (v >= m_threshold[k + 1]) {
+        ++k;
+      }
+      return static_cast<std::uint8_t>(k);
+    }
+
+    // out[i] = (*this)(in[i]). Sirve tanto para RGB intercalado como para un plano SoA.
+    void resolve(std::span<float const> in, std::span<std::uint8_t> out) const;
+
+  private:
+    double m_gamma;
+    // Menor v con nivel >= k (m_threshold[0] = 0, m_threshold[256] = +inf como centinela)
+    std::array<float, 257> m_threshold{};
+    std::array<std::uint8_t, buckets> m_start{};
+  };
+
+  // Referencia exacta (lenta) con la que se construye y valida la tabla
+  [[nodiscard]] std::uint8_t gamma_encode_exact(double v, double gamma);
+
+  // Gris de la imagen de muestras: n / max_n a 0..255, redondeando las mitades hacia arriba
+  // (n >= max_n -> 255; max_n == 0 -> 0). En enteros, para que FramebufferAOS y
+  // FramebufferSOA den los mismos bytes.
+  [[nodiscard]] constexpr std::uint8_t samples_level(std::uint32_t n, std::uint32_t max_n) {
+    if (max_n == 0U) {
+      return 0;
+    }
+    std::uint64_t const c = (n < max_n) ? n : max_n;
+    return static_cast<std::uint8_t>((c * 255U + max_n / 2U) / max_n);
+  }
+
+}  // namespace render
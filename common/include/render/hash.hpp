@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace render {
+
+  // FNV-1a de 64 bits: huella barata (no criptográfica) para saber si un fichero o unos
+  // ajustes han cambiado. Encadenable: el resultado de una llamada es el 'h' de la siguiente.
+  inline constexpr std::uint64_t fnv1a_basis = 0xCBF2'9CE4'8422'2325ULL;
+
+  [[nodiscard]] constexpr std::uint64_t fnv1a64(std::span<std::byte const> bytes,
+                                                std::uint64_t h = fnv1a_basis) {
+    for (std::byte const b : bytes) {
+      h ^= static_cast<std::uint64_t>(b);
+      h *= 0x0000'0100'0000'01B3ULL;
+    }
+    return h;
+  }
+
+  [[nodiscard]] inline std::uint64_t fnv1a64(std::string_view s,
+                                             std::uint64_t h = fnv1a_basis) {
+    return fnv1a64(std::as_bytes(std::span{s.data(), s.size()}), h);
+  }
+
+  // Huella del contenido de un fichero; nullopt si no se puede leer
+  [[nodiscard]] std::optional<std::uint64_t> hash_file(std::string const & path);
+
+}  // namespace render
@@ -12,4 +12,25 @@ namespace render {
   bool hit_cylinder(ray const & r, vector const & base, vector const & axis, double height,
                     double radius, double t_min, double t_max, double * t_out, vector * normal_out);
 
+  // ── Variantes con datos precalculados (escena compilada) ──────────────────────
+  // Dan exactamente el mismo resultado (bit a bit) que hit_sphere / hit_cylinder, pero sin
+  // recalcular r², 1/r, el eje normalizado ni el centro de la tapa superior en cada rayo.
+
+  bool hit_sphere_pre(ray const & r, vector const & center, double r2, double inv_r, double t_min,
+                      double t_max, double * t_out, vector * normal_out);
+
+  struct CylinderPre {
+    vector p0;  // centro de la tapa inferior (= base)
+    vector p1;  // centro de la tapa superior (= base + height * ax)
+    vector ax;  // eje normalizado
+    double height{};
+    double r2{};
+  };
+
+  [[nodiscard]] CylinderPre precompute_cylinder(vector const & base, vector const & axis,
+                                                double height, double radius);
+
+  bool hit_cylinder_pre(ray const & r, CylinderPre const & c, double t_min, double t_max,
+                        double * t_out, vector * normal_out);
+
 }  // namespace render
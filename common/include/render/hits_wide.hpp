@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "render/compiled_scene.hpp"
+#include "render/ray.hpp"
+#include "render/simd.hpp"
+#include "render/vector.hpp"
+
+namespace render {
+
+  // Primitivas que se prueban por instrucción (1 con el respaldo escalar)
+  inline constexpr std::size_t sphere_lanes   = simd::lanes;
+  inline constexpr std::size_t cylinder_lanes = simd::lanes;
+
+  // Impacto más cercano contra varias esferas de una escena compilada a la vez.
+  // Equivale exactamente (t, normal e índice, bit a bit) a llamar a hit_sphere en orden sobre
+  // cada esfera reduciendo t_max con cada impacto: ante un empate en t gana la última.
+  // Devuelve false si no hay impacto en [t_min, t_max].
+
+  // Esferas contiguas [first, last)
+  bool hit_spheres_wide(SphereArrays const & s, std::size_t first, std::size_t last,
+                        ray const & r, double t_min, double t_max, double * t_out,
+                        vector * normal_out, std::uint32_t * index_out);
+
+  // Esferas por índice (hojas del BVH)
+  bool hit_spheres_wide(SphereArrays const & s, std::span<std::uint32_t const> ids,
+                        ray const & r, double t_min, double t_max, double * t_out,
+                        vector * normal_out, std::uint32_t * index_out);
+
+  // Lo mismo para cilindros con tapas: equivale bit a bit a hit_cylinder_pre en orden sobre
+  // cada cilindro. Lateral y tapas se evalúan sin ramas con máscaras.
+  bool hit_cylinders_wide(CylinderArrays const & c, std::size_t first, std::size_t last,
+                          ray const & r, double t_min, double t_max, double * t_out,
+                          vector * normal_out, std::uint32_t * index_out);
+
+  bool hit_cylinders_wide(CylinderArrays const & c, std::span<std::uint32_t const> ids,
+                          ray const & r, double t_min, double t_max, double * t_out,
+                          vector * normal_out, std::uint32_t * index_out);
+
+}  // namespace render
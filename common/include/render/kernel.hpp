@@ -0,0 +1,177 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+
+#include "render/bvh.hpp"
+#include "render/camera.hpp"
+#include "render/compiled_scene.hpp"
+#include "render/material.hpp"
+#include "render/ray.hpp"
+#include "render/rng.hpp"
+#include "render/sampler.hpp"
+#include "render/settings.hpp"
+#include "render/vector.hpp"
+
+namespace render {
+
+  // Degradado de cielo (lo que devuelve un rayo que no toca nada)
+  [[nodiscard]] inline vector sky(ray const & r) {
+    double const t = 0.5 * (r.direction.y + 1.0);
+    return vector{(1.0 - t) * 1.0 + t * 0.5, (1.0 - t) * 1.0 + t * 0.7, (1.0 - t) * 1.0 + t * 1.0};
+  }
+
+  // Flujo del counter_rng de los rebotes, distinto del de la cámara con la misma semilla
+  inline constexpr std::uint64_t path_stream = 0xC2B2'AE3D'27D4'EB4FULL;
+
+  struct PathSample {
+    vector color;
+    std::uint32_t segments{0};  // rayos trazados (consultas al BVH)
+  };
+
+  // Camino de hasta max_depth segmentos desde r. En cada impacto se busca el material por
+  // índice (Hit -> id en la SoA -> materials()) y se rebota con scatter(); si se agota la
+  // profundidad o el material absorbe, el camino no aporta luz.
+  //
+  // Ruleta rusa: a partir de rr_depth rebotes, si max(throughput) = q < 1 el camino sigue con
+  // probabilidad q y, si sigue, el throughput se divide por q. El valor esperado no cambia
+  // (sin sesgo) y los caminos que ya casi no llevan energía se cortan pronto; los que aún
+  // llevan toda (vidrio, espejos) no se tocan. Con rr_depth >= max_depth no hay ruleta.
+  [[nodiscard]] inline PathSample trace_path(ray r, CompiledScene const & scn, Bvh const & bvh,
+                                             int max_depth, int rr_depth, PathSampler rng) {
+    PathSample out;
+    vector throughput{1.0, 1.0, 1.0};
+    for (int depth = 0; depth < max_depth; ++depth) {
+      ++out.segments;
+      Hit h;
+      if (not bvh.closest_hit(scn, r, EPS_HIT, 1e9, &h)) {
+        vector const s = sky(r);
+        out.color      = vector{throughput.x * s.x, throughput.y * s.y, throughput.z * s.z};
+        return out;
+      }
+      std::uint32_t const id = (h.kind == PrimKind::Sphere) ? scn.spheres().mat[h.index]
+                                                            : scn.cylinders().mat[h.index];
+      Scatter sc;
+      if (not scatter(scn.material(id), r, r.at(h.t), h.normal, rng.bounce(depth), sc)) {
+        return out;
+      }
+      throughput = vector{throughput.x * sc.attenuation.x, throughput.y * sc.attenuation.y,
+                          throughput.z * sc.attenuation.z};
+      r = sc.scattered;
+
+      if (depth + 1 >= rr_depth and depth + 1 < max_depth) {
+        double const q = std::max({throughput.x, throughput.y, throughput.z});
+        if (q < 1.0) {
+          if (rng.next01() >= q) {
+            return out;
+          }
+          throughput = throughput / q;
+        }
+      }
+    }
+    return out;
+  }
+
+  // Luminancia Rec. 709 (lineal): la magnitud sobre la que se mide el ruido del píxel
+  [[nodiscard]] constexpr double luminance(vector const & c) {
+    return 0.2126 * c.x + 0.7152 * c.y + 0.0722 * c.z;
+  }
+
+  // Cómo se reparten las muestras del píxel
+  enum class SampleMode : std::uint8_t {
+    One,       // spp == 1
+    Fixed,     // siempre spp
+    Adaptive,  // entre min_spp y spp según la varianza
+  };
+
+  // Especialización del kernel: lente y modo de muestreo
+  template <Lens L, SampleMode M>
+  struct KernelTag {
+    static constexpr Lens lens       = L;
+    static constexpr SampleMode mode = M;
+  };
+
+  // Radiancia de la muestra nº sample_id del píxel (x, y). Es la que suman trace_pixel y el
+  // render progresivo, así que ambos dan las mismas muestras.
+  template <Lens L>
+  [[nodiscard]] inline vector trace_sample(camera const & cam, CompiledScene const & scn,
+                                           Bvh const & bvh, RenderSettings const & s, int x,
+                                           int y, std::uint32_t sample_id) {
+    auto const px = static_cast<std::uint32_t>(x);
+    auto const py = static_cast<std::uint32_t>(y);
+    PathSampler const ps{
+      counter_rng{s.seed ^ path_stream, px, py, sample_id},
+      s.sampler, PixelKey{s.seed, px, py, cam.strata()},
+      sample_id
+    };
+    ray const r = cam.get_ray<L>(px, py, sample_id);
+    return trace_path(r, scn, bvh, s.max_depth, s.rr_depth, ps).color;
+  }
+
+  // Suma de las muestras del píxel (x, y) en 'sum'; devuelve cuántas son. Con la lente y el
+  // modo fijados al compilar, el bucle no tiene ni consultas ni ramas muertas.
+  //
+  // Adaptativo: media y varianza de la luminancia por Welford mientras se muestrea; a partir
+  // de min_spp se para en cuanto el error estándar de la media es <= adaptive_threshold veces
+  // la media (con un suelo de un nivel de 8 bits, para que el negro no pida precisión
+  // infinita). Las muestras son las mismas 0..n-1 que usaría el modo fijo.
+  template <Lens L, SampleMode M>
+  inline std::uint32_t trace_pixel(camera const & cam, CompiledScene const & scn,
+                                   Bvh const & bvh, RenderSettings const & s, int x, int y,
+                                   vector & sum) {
+    auto sample = [&](std::uint32_t i) { return trace_sample<L>(cam, scn, bvh, s, x, y, i); };
+    if constexpr (M == SampleMode::One) {
+      sum = sample(0U);
+      return 1U;
+    } else if constexpr (M == SampleMode::Fixed) {
+      sum = vector{};
+      for (std::uint32_t i = 0; i < s.spp; ++i) {
+        sum = sum + sample(i);
+      }
+      return s.spp;
+    } else {
+      constexpr double floor = 1.0 / 256.0;
+      double const thr2      = s.adaptive_threshold * s.adaptive_threshold;
+      sum                    = vector{};
+      double mean = 0.0, m2 = 0.0;
+      std::uint32_t n = 0;
+      while (n < s.spp) {
+        vector const c = sample(n);
+        sum            = sum + c;
+        ++n;
+        double const l = luminance(c);
+        double const d = l - mean;
+        mean += d / static_cast<double>(n);
+        m2 += d * (l - mean);
+        if (n >= s.min_spp) {
+          // err² = var / n = m2 / ((n - 1) n) <= (thr * ref)²
+          double const ref = std::max(mean, floor);
+          double const dn  = static_cast<double>(n);
+          if (m2 <= thr2 * ref * ref * (dn - 1.0) * dn) {
+            break;
+          }
+        }
+      }
+      return n;
+    }
+  }
+
+  // Llama a fn(KernelTag<...>{}) con la especialización que corresponde a los ajustes. Se
+  // decide una vez por imagen, fuera del bucle de píxeles.
+  template <class Fn>
+  decltype(auto) with_kernel(RenderSettings const & s, Fn && fn) {
+    auto with_mode = [&]<Lens L>() -> decltype(auto) {
+      if (s.adaptive()) {
+        return fn(KernelTag<L, SampleMode::Adaptive>{});
+      }
+      if (s.spp == 1U) {
+        return fn(KernelTag<L, SampleMode::One>{});
+      }
+      return fn(KernelTag<L, SampleMode::Fixed>{});
+    };
+    if (s.lens() == Lens::Pinhole) {
+      return with_mode.template operator()<Lens::Pinhole>();
+    }
+    return with_mode.template operator()<Lens::Thin>();
+  }
+
+}  // namespace render
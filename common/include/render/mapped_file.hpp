@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace render {
+
+  // Fichero de solo lectura proyectado en memoria (mmap). Lo que no se puede proyectar (una
+  // tubería, /dev/stdin, ...) se lee entero a un buffer: para quien lo usa es lo mismo, una
+  // vista de los bytes válida mientras viva el objeto.
+  class MappedFile {
+  public:
+    // nullopt si el fichero no se puede abrir
+    [[nodiscard]] static std::optional<MappedFile> open(std::string const & path);
+
+    MappedFile(MappedFile && other) noexcept;
+    MappedFile & operator=(MappedFile && other) noexcept;
+    MappedFile(MappedFile const &)             = delete;
+    MappedFile & operator=(MappedFile const &) = delete;
+    ~MappedFile();
+
+    [[nodiscard]] std::string_view text() const { return {m_data, m_size}; }
+
+    [[nodiscard]] std::span<std::byte const> bytes() const {
+      return std::as_bytes(std::span{m_data, m_size});
+    }
+
+    [[nodiscard]] std::size_t size() const { return m_size; }
+
+    // true si es una proyección (false: copia leída con read)
+    [[nodiscard]] bool mapped() const { return m_mapped; }
+
+  private:
+    MappedFile() = default;
+    void release() noexcept;
+
+    char const * m_data{nullptr};
+    std::size_t m_size{0};
+    bool m_mapped{false};
+    std::string m_fallback;
+  };
+
+}  // namespace render
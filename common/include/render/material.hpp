@@ -0,0 +1,98 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include "render/compiled_scene.hpp"
+#include "render/ray.hpp"
+#include "render/sampler.hpp"
+#include "render/scene.hpp"
+#include "render/vector.hpp"
+
+namespace render {
+
+  // [0, 1)² -> dirección uniforme en la esfera unidad, sin bucle de rechazo (conserva la
+  // estratificación del punto de entrada)
+  [[nodiscard]] inline vector random_unit_vector(Sample2D const & xi) {
+    double const z   = 1.0 - 2.0 * xi.u;
+    double const r   = std::sqrt(std::max(0.0, 1.0 - z * z));
+    double const phi = 2.0 * std::numbers::pi * xi.v;
+    return {r * std::cos(phi), r * std::sin(phi), z};
+  }
+
+  [[nodiscard]] constexpr vector reflect(vector const & d, vector const & n) {
+    return d - n * (2.0 * d.dot(n));
+  }
+
+  // Refracción de d (unitario) por la normal n del lado de d, con eta = n_origen / n_destino
+  [[nodiscard]] inline vector refract(vector const & d, vector const & n, double eta) {
+    double const cos_theta = std::min(-d.dot(n), 1.0);
+    vector const perp      = (d + n * cos_theta) * eta;
+    vector const para      = n * -std::sqrt(std::abs(1.0 - perp.dot(perp)));
+    return perp + para;
+  }
+
+  // Aproximación de Schlick a la reflectancia de Fresnel
+  [[nodiscard]] inline double schlick(double cosine, double eta) {
+    double r0 = (1.0 - eta) / (1.0 + eta);
+    r0        = r0 * r0;
+    return r0 + (1.0 - r0) * std::pow(1.0 - cosine, 5.0);
+  }
+
+  // Resultado de un rebote: rayo nuevo (dirección unitaria) y atenuación
+  struct Scatter {
+    ray scattered;
+    vector attenuation;
+  };
+
+  // Rebote en el punto p con normal exterior n_out (unitaria) del rayo 'in' (dirección unitaria).
+  // 'xi' es el punto 2D del rebote (del sampler): la dirección en mate/metal y, en vidrio, la
+  // elección reflexión/refracción. Devuelve false si el material absorbe el rayo. Todo en la
+  // pila: ni heap ni virtuales, un switch por MaterialKind.
+  [[nodiscard]] inline bool scatter(MaterialPre const & m, ray const & in, vector const & p,
+                                    vector const & n_out, Sample2D const & xi, Scatter & out) {
+    vector const & d = in.direction;
+    // Normal del lado por el que llega el rayo (la de Hit siempre apunta hacia fuera)
+    bool const front = d.dot(n_out) < 0.0;
+    vector const n   = front ? n_out : n_out * -1.0;
+    switch (m.kind) {
+      case MaterialKind::Matte: {
+        vector dir = n + random_unit_vector(xi);
+        if (dir.dot(dir) < EPS_TINY * EPS_TINY) {
+          dir = n;  // el aleatorio ha caído justo en -n
+        }
+        out = Scatter{
+          ray{p, dir.normalized()},
+          m.albedo
+        };
+        return true;
+      }
+      case MaterialKind::Metal: {
+        vector const dir = reflect(d, n) + random_unit_vector(xi) * m.fuzz;
+        if (dir.dot(n) <= 0.0) {
+          return false;  // el fuzz lo ha metido bajo la superficie
+        }
+        out = Scatter{
+          ray{p, dir.normalized()},
+          m.albedo
+        };
+        return true;
+      }
+      case MaterialKind::Refractive: {
+        double const eta   = front ? 1.0 / m.ior : m.ior;
+        double const cos_t = std::min(-d.dot(n), 1.0);
+        double const sin_t = std::sqrt(std::max(0.0, 1.0 - cos_t * cos_t));
+        bool const total   = eta * sin_t > 1.0;
+        vector const dir =
+            (total or schlick(cos_t, eta) > xi.u) ? reflect(d, n) : refract(d, n, eta);
+        out = Scatter{
+          ray{p, dir.normalized()},
+          vector{1.0, 1.0, 1.0}
+        };
+        return true;
+      }
+    }
+    return false;
+  }
+
+}  // namespace render
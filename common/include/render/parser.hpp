@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <optional>
 #include <string>
+#include <string_view>
 
 #include "render/config.hpp"
 #include "render/scene.hpp"
@@ -15,7 +17,33 @@ namespace render {
 
   // Parseo de escena (se usará plenamente en TA3, pero ya lo exponemos)
   // Mismo contrato: std::nullopt si error, mensaje en *err.
+  // El fichero se proyecta en memoria (MappedFile) y se parsea con
+  // try_parse_scene_text_parallel.
   [[nodiscard]] std::optional<Scene> try_parse_scene(std::string const & filename,
                                                      std::string * err);
 
+  // Parseo de una escena ya en memoria: string_view + from_chars, sin copiar líneas ni
+  // tokens (solo los nombres que acaban en la Scene). 'filename' solo se usa en los mensajes.
+  // Mismos resultados y mismos mensajes (texto y línea) que try_parse_scene_stream.
+  [[nodiscard]] std::optional<Scene> try_parse_scene_text(std::string_view text,
+                                                          std::string const & filename,
+                                                          std::string * err);
+
+  // A partir de este tamaño de sección de objetos compensa trocearla entre hilos
+  inline constexpr std::size_t parallel_parse_min_bytes = std::size_t{1} << 20U;
+
+  // Como try_parse_scene_text, pero la sección de objetos (lo que sigue al primer objeto) se
+  // parte en trozos por saltos de línea que parsean 'threads' hilos (0 => los del hardware)
+  // contra la tabla de materiales ya cerrada, y se unen en orden. Mismo resultado y mismos
+  // mensajes que el secuencial: si hay algún error se repite en secuencial para dar el
+  // primero. Por debajo de 'min_bytes' (o con un hilo) es directamente el secuencial.
+  [[nodiscard]] std::optional<Scene> try_parse_scene_text_parallel(
+      std::string_view text, std::string const & filename, std::string * err,
+      unsigned threads = 0, std::size_t min_bytes = parallel_parse_min_bytes);
+
+  // Referencia: el parser original con std::getline + std::istringstream por línea. Lo usan
+  // los tests y bench-parse para comparar con try_parse_scene.
+  [[nodiscard]] std::optional<Scene> try_parse_scene_stream(std::string const & filename,
+                                                            std::string * err);
+
 }  // namespace render
@@ -1,9 +1,16 @@
 #pragma once
+#include <array>
+#include <cstdint>
+#include <fstream>
 #include <functional>
+#include <span>
 #include <string>
 
 namespace render {
 
+  // P3: texto ASCII (formato histórico). P6: binario, 3 bytes por píxel (~3x menos)
+  enum class PpmFormat : std::uint8_t { P3, P6 };
+
   // ── Versión ORIGINAL (4 parámetros) que usan los tests ──────────────────────
   bool write_ppm_gamma(std::string const & path, int width, int height,
                        std::function<void(int, int, double &, double &, double &)> const & sampler);
@@ -12,4 +19,64 @@ namespace render {
   bool write_ppm_gamma(std::string const & path, int width, int height, double gamma,
                        std::function<void(int, int, double &, double &, double &)> const & sampler);
 
+  // Igual, eligiendo P3 o P6
+  bool write_ppm_gamma(std::string const & path, int width, int height, double gamma,
+                       std::function<void(int, int, double &, double &, double &)> const & sampler,
+                       PpmFormat format);
+
+  // ── Escritura en bloque de una imagen ya cuantizada ─────────────────────────
+  // Sin callbacks por píxel: el fichero se compone en memoria y se vuelca con un único write.
+  // Devuelve false si las dimensiones no cuadran con el tamaño de los datos o si falla la E/S.
+
+  // RGB intercalado: width * height * 3 bytes, fila a fila
+  bool write_ppm(std::string const & path, int width, int height,
+                 std::span<std::uint8_t const> rgb, PpmFormat format = PpmFormat::P6);
+
+  // Planos separados (SoA): width * height bytes cada uno
+  bool write_ppm(std::string const & path, int width, int height, std::span<std::uint8_t const> r,
+                 std::span<std::uint8_t const> g, std::span<std::uint8_t const> b,
+                 PpmFormat format = PpmFormat::P6);
+
+  // Cuerpo P3 ("R G B\n" por píxel, sin cabecera), el que escriben write_ppm y
+  // write_ppm_gamma. Se formatea con una tabla de dígitos por trozos de píxeles en paralelo
+  // (threads = 0: los del hardware), cada trozo directamente en su sitio del resultado; el
+  // texto no depende del nº de hilos.
+  [[nodiscard]] std::string encode_p3(std::span<std::uint8_t const> rgb, unsigned threads = 0);
+
+  // Igual desde planos separados (SoA), sin intercalarlos antes
+  [[nodiscard]] std::string encode_p3(std::span<std::uint8_t const> r,
+                                      std::span<std::uint8_t const> g,
+                                      std::span<std::uint8_t const> b, unsigned threads = 0);
+
+  // ── Escritura incremental ───────────────────────────────────────────────────
+  // Cabecera al abrir y después filas RGB intercaladas, en orden, según van llegando: para
+  // imágenes que no se quieren enteras en memoria (render por bandas, render/stream.hpp).
+  // El fichero final es byte a byte el mismo que daría write_ppm con la imagen completa.
+  class PpmStreamWriter {
+  public:
+    PpmStreamWriter(std::string const & path, int width, int height, PpmFormat format);
+
+    // false si no se pudo abrir o si ya ha fallado alguna escritura
+    [[nodiscard]] bool ok() const { return m_ok; }
+
+    // Filas completas (múltiplo de width * 3 bytes); false si no lo son o falla la E/S
+    bool write_rows(std::span<std::uint8_t const> rgb);
+
+    // Cierra el fichero; false si no han llegado exactamente height filas o algo falló
+    [[nodiscard]] bool finish();
+
+  private:
+    std::ofstream m_out;
+    int m_width{}, m_height{};
+    int m_rows{};
+    PpmFormat m_format{};
+    bool m_ok{false};
+  };
+
+  // Tabla byte lineal -> byte con gamma, con el mismo redondeo que write_ppm_gamma
+  [[nodiscard]] std::array<std::uint8_t, 256> gamma_table_u8(double gamma);
+
+  // "p3" / "p6" (sin distinguir mayúsculas); cualquier otro valor -> fallback
+  [[nodiscard]] PpmFormat parse_ppm_format(std::string const & s, PpmFormat fallback);
+
 }  // namespace render
@@ -0,0 +1,106 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "render/tiles.hpp"
+#include "render/vector.hpp"
+
+namespace render {
+
+  struct ProgressiveOptions {
+    double time_budget{0.0};          // segundos de pared; 0 => sin límite (para en target_spp)
+    std::uint32_t target_spp{1};      // muestras por píxel a las que se para
+    double preview_interval{0.0};     // segundos entre salidas intermedias; 0 => ninguna
+    double checkpoint_interval{0.0};  // segundos entre checkpoints; 0 => ninguno
+  };
+
+  struct ProgressiveStats {
+    std::uint32_t passes{0};   // pasadas que han trazado algo
+    std::uint64_t samples{0};  // muestras añadidas al framebuffer en esta llamada
+    double seconds{0.0};
+    bool deadline_hit{false};
+  };
+
+  // Render progresivo: pasadas de 1 muestra por píxel sobre toda la imagen, acumuladas en fb
+  // (FramebufferAOS / FramebufferSOA), hasta target_spp o hasta que vence el plazo.
+  //
+  // La muestra siguiente de cada píxel es la nº fb.samples(x, y): el sample_id sale del propio
+  // contador del framebuffer, así que una pasada a medias no se pierde ni se repite (los tiles
+  // que han terminado se quedan con su muestra de más) y un framebuffer ya empezado se
+  // continúa exactamente. El plazo se mira al empezar cada tile: ningún rayo trazado se
+  // descarta. Todos los píxeles llegan a target_spp: sin muestreo adaptativo (render_main avisa
+  // si estaba pedido).
+  //
+  //   sample(x, y, sample_id) -> vector   radiancia de esa muestra
+  //   preview(stats)                      cada preview_interval segundos, entre pasadas
+  //   checkpoint(stats)                   cada checkpoint_interval segundos, entre pasadas
+  //
+  // Entre pasadas no hay ningún hilo escribiendo en fb: los dos callbacks pueden leerlo.
+  template <class Framebuffer, class SampleFn, class PreviewFn, class CheckpointFn>
+  ProgressiveStats render_progressive(Framebuffer & fb, TileOptions const & tiles,
+                                      ProgressiveOptions const & opts, SampleFn && sample,
+                                      PreviewFn && preview, CheckpointFn && checkpoint) {
+    using clock         = std::chrono::steady_clock;
+    auto const seconds  = [](double s) {
+      return std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(s));
+    };
+    auto const start    = clock::now();
+    auto const never    = clock::time_point::max();
+    auto const interval = seconds(opts.preview_interval);
+    auto const deadline = (opts.time_budget > 0.0) ? start + seconds(opts.time_budget) : never;
+    auto next_preview   = (opts.preview_interval > 0.0) ? start + interval : never;
+    auto const every    = seconds(opts.checkpoint_interval);
+    auto next_save      = (opts.checkpoint_interval > 0.0) ? start + every : never;
+
+    ProgressiveStats st;
+    std::atomic<bool> expired{false};
+    for (;;) {
+      std::atomic<std::uint64_t> added{0};
+      render_tiles(fb.width, fb.height, tiles, [&](Tile const & t) {
+        if (expired.load(std::memory_order_relaxed)) {
+          return;
+        }
+        if (clock::now() >= deadline) {
+          expired.store(true, std::memory_order_relaxed);
+          return;
+        }
+        std::uint64_t n = 0;
+        for (int y = t.y0; y < t.y1; ++y) {
+          for (int x = t.x0; x < t.x1; ++x) {
+            std::uint32_t const id = fb.samples(x, y);
+            if (id >= opts.target_spp) {
+              continue;
+            }
+            vector const c = sample(x, y, id);
+            fb.add(x, y, static_cast<float>(c.x), static_cast<float>(c.y),
+                   static_cast<float>(c.z));
+            ++n;
+          }
+        }
+        added.fetch_add(n, std::memory_order_relaxed);
+      });
+
+      std::uint64_t const n = added.load();
+      st.samples += n;
+      st.passes += (n > 0U) ? 1U : 0U;
+      if (n == 0U or expired.load()) {
+        break;
+      }
+      if (auto const now = clock::now(); now >= next_preview) {
+        st.seconds = std::chrono::duration<double>(now - start).count();
+        preview(st);
+        next_preview = now + interval;
+      }
+      if (auto const now = clock::now(); now >= next_save) {
+        st.seconds = std::chrono::duration<double>(now - start).count();
+        checkpoint(st);
+        next_save = now + every;
+      }
+    }
+    st.deadline_hit = expired.load();
+    st.seconds      = std::chrono::duration<double>(clock::now() - start).count();
+    return st;
+  }
+
+}  // namespace render
@@ -0,0 +1,99 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  // QOI ("Quite OK Image", qoiformat.org): compresión sin pérdidas de una sola pasada, sin
+  // dependencias. Cada píxel es una repetición del anterior (RUN), una entrada de una tabla
+  // de 64 colores recientes (INDEX), una diferencia pequeña con el anterior (DIFF, LUMA) o el
+  // color entero (RGB). Se escriben 3 canales, espacio sRGB (lo que sale tras la gamma).
+
+  // Extensión ".qoi" (sin distinguir mayúsculas): las salidas con ella se escriben en QOI y
+  // el resto en PPM
+  [[nodiscard]] bool has_qoi_extension(std::string const & path);
+
+  // Codificador incremental: cabecera al construirlo, píxeles en orden raster y finish() al
+  // final. Los bytes se acumulan en out() y quien lo usa puede vaciarlo entre píxeles (el
+  // estado del codificador no depende de ellos), así que sirve tanto para la imagen entera
+  // como para escribir por bandas.
+  class QoiEncoder {
+  public:
+    QoiEncoder(int width, int height);
+
+    void push(std::uint8_t r, std::uint8_t g, std::uint8_t b);
+
+    // Cierra la repetición pendiente y añade el marcador de fin
+    void finish();
+
+    [[nodiscard]] std::vector<std::uint8_t> & out() { return m_out; }
+
+  private:
+    struct Rgba {
+      std::uint8_t r{}, g{}, b{}, a{};
+      bool operator==(Rgba const &) const = default;
+    };
+
+    std::vector<std::uint8_t> m_out;
+    std::array<Rgba, 64> m_index{};
+    Rgba m_prev{0, 0, 0, 255};
+    int m_run{};
+  };
+
+  // Fichero QOI completo de RGB intercalado (width * height * 3 bytes); vacío si el tamaño no
+  // cuadra
+  [[nodiscard]] std::vector<std::uint8_t> encode_qoi(int width, int height,
+                                                     std::span<std::uint8_t const> rgb);
+
+  // Igual desde planos separados (SoA), intercalándolos al vuelo
+  [[nodiscard]] std::vector<std::uint8_t> encode_qoi(int width, int height,
+                                                     std::span<std::uint8_t const> r,
+                                                     std::span<std::uint8_t const> g,
+                                                     std::span<std::uint8_t const> b);
+
+  // false si las dimensiones no cuadran con los datos o si falla la E/S
+  bool write_qoi(std::string const & path, int width, int height,
+                 std::span<std::uint8_t const> rgb);
+  bool write_qoi(std::string const & path, int width, int height, std::span<std::uint8_t const> r,
+                 std::span<std::uint8_t const> g, std::span<std::uint8_t const> b);
+
+  // Imagen decodificada, en RGB intercalado (el alfa de los ficheros RGBA se descarta)
+  struct QoiImage {
+    int width{}, height{};
+    std::vector<std::uint8_t> rgb;
+  };
+
+  // nullopt si no es un QOI válido o está truncado
+  [[nodiscard]] std::optional<QoiImage> decode_qoi(std::span<std::uint8_t const> bytes);
+
+  // Como PpmStreamWriter (render/ppm.hpp), en QOI: filas en orden según van llegando y cada
+  // bloque codificado se escribe en cuanto se ha formado
+  class QoiStreamWriter {
+  public:
+    QoiStreamWriter(std::string const & path, int width, int height);
+
+    [[nodiscard]] bool ok() const { return m_ok; }
+
+    // Filas completas (múltiplo de width * 3 bytes); false si no lo son o falla la E/S
+    bool write_rows(std::span<std::uint8_t const> rgb);
+
+    // Cierra el fichero; false si no han llegado exactamente height filas o algo falló
+    [[nodiscard]] bool finish();
+
+  private:
+    bool flush();
+
+    std::ofstream m_out;
+    QoiEncoder m_enc;
+    int m_width{}, m_height{};
+    int m_rows{};
+    bool m_ok{false};
+  };
+
+}  // namespace render
@@ -0,0 +1,192 @@
+#pragma once
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include "render/bvh.hpp"
+#include "render/camera.hpp"
+#include "render/compiled_scene.hpp"
+#include "render/gamma.hpp"
+#include "render/kernel.hpp"
+#include "render/ppm.hpp"
+#include "render/progressive.hpp"
+#include "render/qoi.hpp"
+#include "render/settings.hpp"
+#include "render/stream.hpp"
+#include "render/tiles.hpp"
+#include "render/vector.hpp"
+
+// Kernel de render sobre una disposición de imagen: render_image es una plantilla que cada
+// ejecutable instancia con sus tipos, así que render-aos y render-soa comparten todo el código
+// y cada uno se especializa en compilación. Lo que depende de la disposición en memoria
+// (sumar una muestra, resolver a 8 bits por filas o por planos, volcar a disco) es del
+// framebuffer y de la imagen. El programa completo (argumentos, entorno, log) está aparte,
+// en render/render_main.hpp.
+
+namespace render {
+
+  // Imagen por filas (ImageAOS): row(y) son los width píxeles RGB intercalados de la fila y
+  template <class I>
+  concept RowImage = requires(I & img, I const & cimg, int y) {
+    { img.row(y) } -> std::same_as<std::span<std::uint8_t>>;
+    { cimg.row(y) } -> std::same_as<std::span<std::uint8_t const>>;
+  };
+
+  // Imagen por planos (ImageSOA): plane(c) es el canal c (0 = R, 1 = G, 2 = B) de toda la
+  // imagen, para que el resolve escriba un plano entero de una vez
+  template <class I>
+  concept PlanarImage = requires(I & img, I const & cimg, int c) {
+    { img.plane(c) } -> std::same_as<std::span<std::uint8_t>>;
+    { cimg.plane(c) } -> std::same_as<std::span<std::uint8_t const>>;
+  };
+
+  // Imagen de salida de 8 bits por canal, con acceso directo a filas o a planos (es por donde
+  // la llena el resolve de su framebuffer) y que se escribe con write_image(path, img, format)
+  template <class I>
+  concept Image = (RowImage<I> or PlanarImage<I>) and
+                  requires(I const & cimg, std::string const & path) {
+                    { cimg.width } -> std::convertible_to<int>;
+                    { cimg.height } -> std::convertible_to<int>;
+                    { write_image(path, cimg, PpmFormat::P6) } -> std::same_as<bool>;
+                  };
+
+  // Framebuffer de acumulación que se resuelve a ImageT (FramebufferAOS -> ImageAOS, ...)
+  template <class F, class ImageT>
+  concept FramebufferFor =
+      Image<ImageT> and requires(F & fb, F const & cfb, int x, int y, float v, float & out,
+                                 GammaLut const & lut) {
+        { cfb.width } -> std::convertible_to<int>;
+        { cfb.height } -> std::convertible_to<int>;
+        fb.add(x, y, v, v, v);
+        { cfb.samples(x, y) } -> std::same_as<std::uint32_t>;
+        cfb.mean(x, y, out, out, out);
+        { cfb.total_samples() } -> std::same_as<std::uint64_t>;
+        { cfb.samples_image(std::uint32_t{}) } -> std::same_as<ImageT>;
+        { cfb.resolve(lut) } -> std::same_as<ImageT>;
+        { F::checkpoint_layout } -> std::convertible_to<std::uint32_t>;
+      };
+
+  // Lo que el kernel lee (todo inmutable durante el render)
+  struct RenderJob {
+    CompiledScene const & scene;
+    Bvh const & bvh;
+    camera const & cam;
+    RenderSettings const & settings;
+  };
+
+  // Llena fb con las muestras de job y devuelve la imagen resuelta (media -> gamma -> u8 con
+  // la tabla, sin pasar por 8 bits lineales). La especialización del kernel (pinhole/DOF, 1
+  // muestra, fijo o adaptativo) se elige aquí una vez. Con 'progressive': pasadas de 1 spp
+  // hasta spp o hasta el plazo, con preview(stats) y checkpoint(stats) entre pasadas; si vence
+  // el plazo, checkpoint() se llama una última vez para no perder lo hecho. Las cuentas de
+  // las pasadas quedan en *stats.
+  template <Image ImageT, FramebufferFor<ImageT> Framebuffer, class PreviewFn,
+            class CheckpointFn>
+  [[nodiscard]] ImageT render_image(Framebuffer & fb, RenderJob const & job, bool progressive,
+                                    PreviewFn && preview, CheckpointFn && checkpoint,
+                                    ProgressiveStats * stats = nullptr) {
+    RenderSettings const & s = job.settings;
+
+    if (progressive) {
+      ProgressiveOptions const opts{s.time_budget, s.spp, s.preview_interval,
+                                    s.checkpoint_interval};
+      ProgressiveStats const st = with_kernel(s, [&]<class K>(K) {
+        return render_progressive(
+            fb, s.tiles, opts,
+            [&](int x, int y, std::uint32_t i) {
+              return trace_sample<K::lens>(job.cam, job.scene, job.bvh, s, x, y, i);
+            },
+            preview, checkpoint);
+      });
+      if (stats) {
+        *stats = st;
+      }
+      // Sin terminar: lo hecho queda en el checkpoint para la siguiente --resume
+      if (st.deadline_hit) {
+        checkpoint(st);
+      }
+    } else {
+      // Cada tile escribe solo sus píxeles (sin locks) y la cámara genera cada muestra a partir
+      // de (seed, píxel, sample_id): la imagen es la misma con 1 hilo que con N
+      with_kernel(s, [&]<class K>(K) {
+        render_tiles(fb.width, fb.height, s.tiles, [&](Tile const & t) {
+          for (int y = t.y0; y < t.y1; ++y) {
+            for (int x = t.x0; x < t.x1; ++x) {
+              vector sum;
+              std::uint32_t const n =
+                  trace_pixel<K::lens, K::mode>(job.cam, job.scene, job.bvh, s, x, y, sum);
+              fb.add(x, y, static_cast<float>(sum.x), static_cast<float>(sum.y),
+                     static_cast<float>(sum.z), n);
+            }
+          }
+        });
+      });
+    }
+    return fb.resolve(GammaLut{s.gamma});
+  }
+
+  // Render de una vez sin framebuffer: bandas de settings.stream_rows filas que se resuelven
+  // (media -> gamma -> u8 con las mismas operaciones en float que el resolve() de los
+  // framebuffers) y se pasan en orden a 'out' (PpmStreamWriter, QoiStreamWriter) según se
+  // terminan. Las bandas son RGB intercalado, el orden de PPM y QOI, sea cual sea la
+  // disposición de la imagen: una banda por planos habría que intercalarla igual antes de
+  // escribirla. Las muestras gastadas quedan en *samples; false si falla la escritura.
+  template <class Writer>
+  [[nodiscard]] bool render_streamed_to(Writer & out, RenderJob const & job, BandStats * stats,
+                                        double * samples) {
+    RenderSettings const & s = job.settings;
+    int const W              = static_cast<int>(s.width);
+    int const H              = static_cast<int>(s.height);
+    GammaLut const lut{s.gamma};
+    if (!out.ok()) {
+      return false;
+    }
+
+    std::atomic<std::uint64_t> total{0};
+    BandOptions const opts{s.stream_rows, s.tiles.threads, 0U};
+    bool const ok = with_kernel(s, [&]<class K>(K) {
+      return render_bands(
+          W, H, opts,
+          [&](int y0, int y1, std::span<std::uint8_t> rgb) {
+            std::uint64_t band_samples = 0;
+            std::size_t i              = 0;
+            for (int y = y0; y < y1; ++y) {
+              for (int x = 0; x < W; ++x) {
+                vector sum;
+                std::uint32_t const n =
+                    trace_pixel<K::lens, K::mode>(job.cam, job.scene, job.bvh, s, x, y, sum);
+                float const inv  = (n > 0U) ? 1.0F / static_cast<float>(n) : 0.0F;
+                rgb[i]           = lut(static_cast<float>(sum.x) * inv);
+                rgb[i + 1]       = lut(static_cast<float>(sum.y) * inv);
+                rgb[i + 2]       = lut(static_cast<float>(sum.z) * inv);
+                i               += 3;
+                band_samples    += n;
+              }
+            }
+            total.fetch_add(band_samples, std::memory_order_relaxed);
+          },
+          [&](std::span<std::uint8_t const> rgb) { return out.write_rows(rgb); }, stats);
+    });
+    if (samples) {
+      *samples = static_cast<double>(total.load());
+    }
+    return out.finish() and ok;
+  }
+
+  // A fichero, en QOI o en PPM según la extensión (como write_image). El fichero es el mismo
+  // que el de render_image + write_image, pero la memoria no depende del alto de la imagen.
+  [[nodiscard]] inline bool render_streamed(RenderJob const & job, std::string const & path,
+                                            BandStats * stats, double * samples) {
+    int const W = static_cast<int>(job.settings.width);
+    int const H = static_cast<int>(job.settings.height);
+    if (has_qoi_extension(path)) {
+      QoiStreamWriter out(path, W, H);
+      return render_streamed_to(out, job, stats, samples);
+    }
+    PpmStreamWriter out(path, W, H, job.settings.format);
+    return render_streamed_to(out, job, stats, samples);
+  }
+
+}  // namespace render
@@ -0,0 +1,230 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <print>
+#include <string>
+#include <string_view>
+
+#include "render/camera.hpp"
+#include "render/checkpoint.hpp"
+#include "render/config.hpp"
+#include "render/gamma.hpp"
+#include "render/hits.hpp"
+#include "render/parser.hpp"
+#include "render/ppm.hpp"
+#include "render/progressive.hpp"
+#include "render/qoi.hpp"
+#include "render/ray.hpp"
+#include "render/render_image.hpp"
+#include "render/scene_cache.hpp"
+#include "render/settings.hpp"
+#include "render/stream.hpp"
+#include "render/tiles.hpp"
+#include "render/vector.hpp"
+
+// El programa completo sobre render_image (render/render_image.hpp): argumentos, ajustes del
+// entorno, carga de la escena, checkpoints, previews, log y salida. Solo lo incluyen los
+// main de render-aos y render-soa.
+
+namespace render {
+
+  // El programa: render-xxx <config> <scene> <output> [--resume]
+  template <Image ImageT, FramebufferFor<ImageT> Framebuffer>
+  int render_main(int argc, char * argv[]) {
+    bool const resume = (argc == 5) and std::string_view{argv[4]} == "--resume";
+    if (argc != 4 and !resume) {
+      std::println(stderr, "Error: Invalid number of arguments: {}", argc - 1);
+      return 1;
+    }
+
+    std::string err_cfg;
+    auto cfg = try_parse_config(argv[1], &err_cfg);
+    if (!cfg) {
+      std::println(stderr, "{}", err_cfg);
+      return 1;
+    }
+
+    // Ajustes efectivos (Config + overrides RENDER_*), resueltos una vez: a partir de aquí
+    // nadie vuelve a leer el entorno
+    RenderSettings const settings = resolve_settings(*cfg);
+
+    // Checkpoints: el framebuffer se guarda entre pasadas y --resume lo recupera. La huella
+    // (ajustes + fichero de escena) impide seguir con otra escena o con otros ajustes.
+    bool const checkpoints = resume or settings.checkpoint_interval > 0.0;
+
+    // Escena compilada (SoA alineado con datos precalculados) y BVH sobre ella: el bucle de
+    // render solo toca estas dos estructuras. Con RENDER_SCENE_CACHE salen de la caché
+    // binaria si sigue al día con el fichero de texto (y si no, se parsea y se reescribe). El
+    // hash del texto solo se calcula si lo necesitan la caché o los checkpoints.
+    std::string err_scn, cache_note;
+    auto loaded = load_scene(argv[2], settings.scene_cache, checkpoints, &err_scn, &cache_note);
+    if (!loaded) {
+      std::println(stderr, "{}", err_scn);
+      return 1;
+    }
+    if (!cache_note.empty()) {
+      std::println(stderr, "{}", cache_note);
+    }
+    CompiledScene const & cscn = loaded->scene;
+    Bvh const & bvh            = loaded->bvh;
+
+    SphereArrays const & spheres = cscn.spheres();
+    std::println(stderr, "scene: {} spheres, {} cylinders", spheres.size(),
+                 cscn.cylinders().size());
+    if (spheres.size() > 0U) {
+      vector const c = spheres.center(0);
+      std::println(stderr, "first sphere: c=({}, {}, {}), r={}", c.x, c.y, c.z,
+                   spheres.radius[0]);
+    }
+    std::println(stderr, "compiled scene: {} bytes, bvh: {} nodes, {} prims", cscn.bytes(),
+                 bvh.node_count(), bvh.prim_count());
+
+    camera const cam = settings.make_camera();
+
+    // DEBUG: imprime valores efectivos para comprobar que llegan
+    std::println(stderr,
+                 "cam from=({}, {}, {}), at=({}, {}, {}), vup=({}, {}, {}), vfov={}, "
+                 "aperture={}, focus={}, spp={}, depth={}, sampler={}",
+                 settings.lookfrom.x, settings.lookfrom.y, settings.lookfrom.z,
+                 settings.lookat.x, settings.lookat.y, settings.lookat.z, settings.vup.x,
+                 settings.vup.y, settings.vup.z, settings.vfov_deg, settings.aperture,
+                 settings.focus_dist, settings.spp, settings.max_depth,
+                 sampler_name(settings.sampler));
+
+    int const W = static_cast<int>(settings.width);
+    int const H = static_cast<int>(settings.height);
+
+    {
+      ray const r = cam.get_ray(static_cast<std::uint32_t>(W / 2),
+                                static_cast<std::uint32_t>(H / 2), 0U);
+      double t{};
+      vector n;
+      bool const any =
+          spheres.size() > 0U and
+          hit_sphere(r, spheres.center(0), spheres.radius[0], 1e-6, 1e9, &t, &n);
+      std::println(stderr, "center-pixel hit? {}  t={}", any, any ? t : -1.0);
+    }
+
+    std::println(stderr, "tiles: {}px, threads: {}", settings.tiles.tile_size,
+                 resolve_thread_count(settings.tiles.threads));
+
+    // Muestras gastadas (con muestreo adaptativo, menos que W * H * spp)
+    auto report_samples = [&](double total) {
+      std::println(stderr, "samples: {} ({:.2f}/px, max {})", total,
+                   total / (static_cast<double>(W) * H), settings.spp);
+    };
+    RenderJob const job{cscn, bvh, cam, settings};
+
+    // El progresivo hace pasadas de una muestra sobre todo el framebuffer: ni para por píxel
+    // (adaptativo) ni va por bandas, así que esos ajustes se ignoran; mejor avisar
+    bool const progressive = settings.progressive() or resume;
+    if (progressive and settings.adaptive()) {
+      std::println(stderr,
+                   "Warning: adaptive sampling (threshold {}, min spp {}) is ignored in "
+                   "progressive mode",
+                   settings.adaptive_threshold, settings.min_spp);
+    }
+    if (progressive and settings.stream_rows > 0) {
+      std::println(stderr, "Warning: streaming ({} rows per band) is ignored in progressive mode",
+                   settings.stream_rows);
+    }
+
+    // Por bandas (RENDER_STREAM_ROWS): sin framebuffer, así que sin progresivo ni checkpoints
+    if (settings.stream_rows > 0 and !progressive) {
+      if (!settings.spp_image.empty()) {
+        std::println(stderr, "Warning: no samples image when streaming ('{}' not written)",
+                     settings.spp_image);
+      }
+      BandStats bands;
+      double total{};
+      if (!render_streamed(job, argv[3], &bands, &total)) {
+        std::println(stderr, "Error: cannot write '{}'", argv[3]);
+        return 1;
+      }
+      std::println(stderr, "stream: {} bands of {} rows, window {} ({} bytes), max {} waiting",
+                   bands.bands, settings.stream_rows, bands.window, bands.buffer_bytes,
+                   bands.max_pending);
+      double const share =
+          (bands.write_seconds > 0.0) ? 100.0 * bands.write_overlap / bands.write_seconds : 0.0;
+      std::println(stderr, "stream: {:.3f}s total, write {:.3f}s, {:.3f}s overlapped with "
+                   "rendering ({:.0f}%)",
+                   bands.seconds, bands.write_seconds, bands.write_overlap, share);
+      report_samples(total);
+      std::println(stderr, "OK: wrote {}", argv[3]);
+      return 0;
+    }
+
+    Framebuffer fb(W, H);
+
+    std::string const ckpt = settings.checkpoint_path.empty() ? std::string{argv[3]} + ".ckpt"
+                                                              : settings.checkpoint_path;
+    std::uint64_t const fingerprint =
+        checkpoints ? checkpoint_fingerprint(settings, loaded->source_hash) : 0U;
+    if (resume) {
+      std::string err;
+      if (!load_checkpoint(ckpt, fingerprint, fb, &err)) {
+        std::println(stderr, "{}", err);
+        return 1;
+      }
+      std::println(stderr, "resumed: {} samples from {}", fb.total_samples(), ckpt);
+    }
+
+    // Entre pasadas del progresivo: la media acumulada hasta ahora a preview_path y el
+    // framebuffer al checkpoint
+    std::string const preview = settings.preview_path.empty() ? argv[3] : settings.preview_path;
+    auto write_preview        = [&](ProgressiveStats const & st) {
+      // QOI desde la imagen resuelta; en PPM, sin ella (media píxel a píxel)
+      bool const ok =
+          has_qoi_extension(preview)
+              ? write_image(preview, fb.resolve(GammaLut{settings.gamma}), settings.format)
+              : write_ppm_gamma(
+                    preview, W, H, settings.gamma,
+                    [&](int x, int y, double & r, double & g, double & b) {
+                      float mr{}, mg{}, mb{};
+                      fb.mean(x, y, mr, mg, mb);
+                      r = mr;
+                      g = mg;
+                      b = mb;
+                    },
+                    settings.format);
+      std::println(stderr, "preview: pass {}, {:.2f}s -> {}{}", st.passes, st.seconds, preview,
+                   ok ? "" : " (write failed)");
+    };
+    auto save = [&](ProgressiveStats const &) {
+      if (!checkpoints) {
+        return;
+      }
+      std::string err;
+      if (!save_checkpoint(ckpt, fingerprint, fb, &err)) {
+        std::println(stderr, "{}", err);
+        return;
+      }
+      std::println(stderr, "checkpoint: {} samples -> {}", fb.total_samples(), ckpt);
+    };
+
+    ProgressiveStats passes;
+    ImageT const img = render_image<ImageT>(fb, job, progressive, write_preview, save, &passes);
+    if (progressive) {
+      std::println(stderr, "progressive: {} passes, {} samples in {:.2f}s{}", passes.passes,
+                   passes.samples, passes.seconds,
+                   passes.deadline_hit ? " (time budget hit)" : "");
+    }
+
+    report_samples(static_cast<double>(fb.total_samples()));
+    if (!settings.spp_image.empty()) {
+      auto const spp_img = fb.samples_image(settings.spp);
+      if (!write_image(settings.spp_image, spp_img, settings.format)) {
+        std::println(stderr, "Error: cannot write '{}'", settings.spp_image);
+        return 1;
+      }
+    }
+
+    if (!write_image(argv[3], img, settings.format)) {
+      std::println(stderr, "Error: cannot write '{}'", argv[3]);
+      return 1;
+    }
+    std::println(stderr, "OK: wrote {}", argv[3]);
+    return 0;
+  }
+
+}  // namespace render
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+
+namespace render {
+
+  // Finalizador de splitmix64: biyección de 64 bits con buena avalancha.
+  [[nodiscard]] constexpr std::uint64_t mix64(std::uint64_t z) {
+    z = (z ^ (z >> 30U)) * 0xBF58'476D'1CE4'E5B9ULL;
+    z = (z ^ (z >> 27U)) * 0x94D0'49BB'1331'11EBULL;
+    return z ^ (z >> 31U);
+  }
+
+  // Generador basado en contador (sin estado compartido).
+  // Cada muestra (seed, px, py, sample_id) tiene su propia clave y el valor i-ésimo es
+  // mix64(clave + i * gamma), así que cualquier hilo puede generar cualquier muestra en
+  // cualquier orden y el resultado es siempre el mismo. Ocupa 16 bytes (vs ~2.5 KB de mt19937_64).
+  class counter_rng {
+  public:
+    static constexpr std::uint64_t golden = 0x9E37'79B9'7F4A'7C15ULL;
+
+    constexpr counter_rng(std::uint64_t seed, std::uint32_t px, std::uint32_t py,
+                          std::uint32_t sample_id)
+        : m_key(make_key(seed, px, py, sample_id)) { }
+
+    // Siguiente entero de 64 bits del flujo
+    [[nodiscard]] constexpr std::uint64_t next_u64() {
+      ++m_counter;
+      return mix64(m_key + m_counter * golden);
+    }
+
+    // Uniforme en [0, 1) con 53 bits de mantisa
+    [[nodiscard]] constexpr double next01() {
+      return static_cast<double>(next_u64() >> 11U) * 0x1.0p-53;
+    }
+
+    // Posición actual en el flujo (nº de valores consumidos)
+    [[nodiscard]] constexpr std::uint64_t counter() const { return m_counter; }
+
+  private:
+    [[nodiscard]] static constexpr std::uint64_t make_key(std::uint64_t seed, std::uint32_t px,
+                                                          std::uint32_t py,
+                                                          std::uint32_t sample_id) {
+      std::uint64_t const pixel = (static_cast<std::uint64_t>(py) << 32U) | px;
+      std::uint64_t k           = mix64(seed + golden);
+      k                         = mix64(k ^ (pixel + golden));
+      return mix64(k ^ (static_cast<std::uint64_t>(sample_id) + golden));
+    }
+
+    std::uint64_t m_key;
+    std::uint64_t m_counter{0};
+  };
+
+}  // namespace render
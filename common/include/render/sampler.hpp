@@ -0,0 +1,265 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <optional>
+#include <string_view>
+
+#include "render/rng.hpp"
+
+namespace render {
+
+  // Generadores de puntos 2D en [0, 1)² indexados por sample_id, sin estado: como
+  // counter_rng, cualquier hilo puede pedir cualquier muestra en cualquier orden.
+  //
+  // Cada sampler es un struct con
+  //   static Sample2D get(PixelKey const & key, std::uint32_t sample_id, std::uint32_t dim);
+  // donde 'dim' separa usos independientes dentro de la misma muestra (jitter del píxel,
+  // lente, ...). Para añadir uno: struct nuevo + valor en SamplerKind + caso en sample_2d().
+  enum class SamplerKind : std::uint8_t {
+    Random,      // ruido blanco (counter_rng), el comportamiento original
+    Stratified,  // rejilla de spp celdas permutada y con jitter dentro de la celda
+    Sobol,       // Sobol 2D con scrambling de Owen por hash (Burley 2020)
+    R2,          // secuencia R2 de Roberts con rotación por píxel
+  };
+
+  struct Sample2D {
+    double u{}, v{};
+  };
+
+  // Rejilla de Stratified: nx * ny >= spp celdas, nx = ceil(sqrt(spp)) y ny = ceil(spp / nx)
+  struct StrataGrid {
+    std::uint32_t nx{1}, ny{1};
+  };
+
+  // Una vez por render (la cámara la guarda), no por muestra. Con spp > 65535 * 65536 la
+  // rejilla se queda en 65536 * 65535 celdas (que caben en 32 bits) y lo que sobra es otra
+  // pasada.
+  [[nodiscard]] StrataGrid strata_grid(std::uint32_t spp);
+
+  // Lo que identifica la secuencia de un píxel
+  struct PixelKey {
+    std::uint64_t seed{};
+    std::uint32_t px{}, py{};
+    StrataGrid strata{};  // lo usa Stratified para saber cuántas celdas hay
+  };
+
+  // Dimensiones 2D: las dos de la cámara y, a partir de dim_bounce, una por rebote
+  inline constexpr std::uint32_t dim_pixel  = 0;
+  inline constexpr std::uint32_t dim_lens   = 1;
+  inline constexpr std::uint32_t dim_bounce = 2;
+
+  [[nodiscard]] std::optional<SamplerKind> parse_sampler(std::string_view s);
+  [[nodiscard]] char const * sampler_name(SamplerKind k);
+
+  namespace detail {
+
+    // Hash de 32 bits por (píxel, dimensión, sal) para semillas de scrambling / permutación
+    [[nodiscard]] constexpr std::uint32_t pixel_hash(PixelKey const & k, std::uint32_t dim,
+                                                     std::uint32_t salt) {
+      counter_rng rng{k.seed ^ (static_cast<std::uint64_t>(salt) << 32U), k.px, k.py, ~dim};
+      return static_cast<std::uint32_t>(rng.next_u64() >> 32U);
+    }
+
+    [[nodiscard]] constexpr double to_unit(std::uint32_t bits) {
+      return static_cast<double>(bits) * 0x1.0p-32;
+    }
+
+    [[nodiscard]] constexpr std::uint32_t reverse_bits(std::uint32_t x) {
+      x = ((x >> 1U) & 0x5555'5555U) | ((x & 0x5555'5555U) << 1U);
+      x = ((x >> 2U) & 0x3333'3333U) | ((x & 0x3333'3333U) << 2U);
+      x = ((x >> 4U) & 0x0F0F'0F0FU) | ((x & 0x0F0F'0F0FU) << 4U);
+      x = ((x >> 8U) & 0x00FF'00FFU) | ((x & 0x00FF'00FFU) << 8U);
+      return (x >> 16U) | (x << 16U);
+    }
+
+    // Permutación de Laine-Karras: cada bit solo depende de los bits menos significativos
+    [[nodiscard]] constexpr std::uint32_t laine_karras(std::uint32_t x, std::uint32_t seed) {
+      x += seed;
+      x ^= x * 0x6C50'B47CU;
+      x ^= x * 0xB82F'1E52U;
+      x ^= x * 0xC7AF'E638U;
+      x ^= x * 0x8D22'F6E6U;
+      return x;
+    }
+
+    // Scrambling de Owen (uniforme anidado) con un hash: conserva la estructura de (t,m,s)-red
+    [[nodiscard]] constexpr std::uint32_t owen_scramble(std::uint32_t x, std::uint32_t seed) {
+      return reverse_bits(laine_karras(reverse_bits(x), seed));
+    }
+
+    // Dos primeras dimensiones de Sobol: van der Corput y la matriz de Pascal mod 2
+    [[nodiscard]] constexpr std::uint32_t sobol_dim0(std::uint32_t i) {
+      return reverse_bits(i);
+    }
+
+    [[nodiscard]] constexpr std::uint32_t sobol_dim1(std::uint32_t i) {
+      std::uint32_t v = 0x8000'0000U;
+      std::uint32_t x = 0;
+      for (; i != 0U; i >>= 1U, v ^= v >> 1U) {
+        if ((i & 1U) != 0U) {
+          x ^= v;
+        }
+      }
+      return x;
+    }
+
+    // Permutación de [0, l) indexable sin tablas (Kensler, "Correlated Multi-Jittered
+    // Sampling"). El bucle rechaza valores >= l; como w < 2l, sale en ~2 vueltas de media.
+    [[nodiscard]] constexpr std::uint32_t permute(std::uint32_t i, std::uint32_t l,
+                                                  std::uint32_t p) {
+      std::uint32_t w = l - 1U;
+      w |= w >> 1U;
+      w |= w >> 2U;
+      w |= w >> 4U;
+      w |= w >> 8U;
+      w |= w >> 16U;
+      do {
+        i ^= p;
+        i *= 0xE170'893DU;
+        i ^= p >> 16U;
+        i ^= (i & w) >> 4U;
+        i ^= p >> 8U;
+        i *= 0x0929'EB3FU;
+        i ^= p >> 23U;
+        i ^= (i & w) >> 1U;
+        i *= 1U | (p >> 27U);
+        i *= 0x6935'FA69U;
+        i ^= (i & w) >> 11U;
+        i *= 0x74DC'B303U;
+        i ^= (i & w) >> 2U;
+        i *= 0x9E50'1CC3U;
+        i ^= (i & w) >> 2U;
+        i *= 0xC860'A3DFU;
+        i &= w;
+        i ^= i >> 5U;
+      } while (i >= l);
+      return (i + p) % l;
+    }
+
+  }  // namespace detail
+
+  struct RandomSampler {
+    // dim d usa los valores 2d y 2d+1 del flujo de la muestra (dim 0 = el jitter de siempre)
+    [[nodiscard]] static constexpr Sample2D get(PixelKey const & k, std::uint32_t sample_id,
+                                                std::uint32_t dim) {
+      counter_rng rng{k.seed, k.px, k.py, sample_id};
+      for (std::uint32_t d = 0; d < dim; ++d) {
+        (void) rng.next_u64();
+        (void) rng.next_u64();
+      }
+      double const u = rng.next01();
+      return {u, rng.next01()};
+    }
+  };
+
+  struct StratifiedSampler {
+    // Rejilla k.strata; sample_id elige celda por una permutación distinta por píxel y
+    // dimensión (y por pasada si se piden más muestras que celdas)
+    [[nodiscard]] static constexpr Sample2D get(PixelKey const & k, std::uint32_t sample_id,
+                                                std::uint32_t dim) {
+      std::uint32_t const nx    = k.strata.nx;
+      std::uint32_t const ny    = k.strata.ny;
+      std::uint32_t const cells = nx * ny;
+      std::uint32_t const pass  = sample_id / cells;
+      std::uint32_t const cell =
+          detail::permute(sample_id % cells, cells, detail::pixel_hash(k, dim, pass));
+
+      counter_rng rng{k.seed, k.px, k.py, sample_id};
+      for (std::uint32_t d = 0; d < dim; ++d) {
+        (void) rng.next_u64();
+        (void) rng.next_u64();
+      }
+      double const jx = rng.next01();
+      double const jy = rng.next01();
+      return {(static_cast<double>(cell % nx) + jx) / static_cast<double>(nx),
+              (static_cast<double>(cell / nx) + jy) / static_cast<double>(ny)};
+    }
+  };
+
+  struct SobolSampler {
+    // Índice barajado con Owen (cada píxel recorre la secuencia en otro orden) y cada eje
+    // con su propio Owen: los prefijos de potencia de 2 siguen siendo (0,m,2)-redes
+    [[nodiscard]] static constexpr Sample2D get(PixelKey const & k, std::uint32_t sample_id,
+                                                std::uint32_t dim) {
+      std::uint32_t const i = detail::owen_scramble(sample_id, detail::pixel_hash(k, dim, 1U));
+      std::uint32_t const x = detail::owen_scramble(detail::sobol_dim0(i),
+                                                    detail::pixel_hash(k, dim, 2U));
+      std::uint32_t const y = detail::owen_scramble(detail::sobol_dim1(i),
+                                                    detail::pixel_hash(k, dim, 3U));
+      return {detail::to_unit(x), detail::to_unit(y)};
+    }
+  };
+
+  struct R2Sampler {
+    // x_n = frac(offset + n * (1/g, 1/g²)), g = número plástico; offset aleatorio por píxel
+    [[nodiscard]] static Sample2D get(PixelKey const & k, std::uint32_t sample_id,
+                                      std::uint32_t dim) {
+      constexpr double a1 = 0.754'877'666'246'692'7;  // 1 / g
+      constexpr double a2 = 0.569'840'290'998'053'2;  // 1 / g²
+      double const n      = static_cast<double>(sample_id);
+      double const u = detail::to_unit(detail::pixel_hash(k, dim, 4U)) + n * a1;
+      double const v = detail::to_unit(detail::pixel_hash(k, dim, 5U)) + n * a2;
+      return {u - std::floor(u), v - std::floor(v)};
+    }
+  };
+
+  // Despacho por tipo (un switch por llamada; el coste es despreciable frente al rayo)
+  [[nodiscard]] inline Sample2D sample_2d(SamplerKind kind, PixelKey const & k,
+                                          std::uint32_t sample_id, std::uint32_t dim) {
+    switch (kind) {
+      case SamplerKind::Stratified:
+        return StratifiedSampler::get(k, sample_id, dim);
+      case SamplerKind::Sobol:
+        return SobolSampler::get(k, sample_id, dim);
+      case SamplerKind::R2:
+        return R2Sampler::get(k, sample_id, dim);
+      case SamplerKind::Random:
+        break;
+    }
+    return RandomSampler::get(k, sample_id, dim);
+  }
+
+  // Aleatorios de un camino: la dirección de cada rebote sale del sampler de la imagen
+  // (dimensión dim_bounce + depth) y lo demás (ruleta rusa) del counter_rng. Con
+  // SamplerKind::Random todo sale del counter_rng. Se construye implícitamente desde un
+  // counter_rng (ruido blanco puro), que es lo que quieren los tests y los benchmarks.
+  struct PathSampler {
+    counter_rng rng;
+    SamplerKind kind{SamplerKind::Random};
+    PixelKey key{};
+    std::uint32_t sample_id{};
+
+    constexpr PathSampler(counter_rng r) : rng(r) { }  // NOLINT(google-explicit-constructor)
+
+    constexpr PathSampler(counter_rng r, SamplerKind k, PixelKey const & pk, std::uint32_t id)
+        : rng(r), kind(k), key(pk), sample_id(id) { }
+
+    [[nodiscard]] Sample2D bounce(int depth) {
+      if (kind == SamplerKind::Random) {
+        double const u = rng.next01();
+        return {u, rng.next01()};
+      }
+      return sample_2d(kind, key, sample_id, dim_bounce + static_cast<std::uint32_t>(depth));
+    }
+
+    [[nodiscard]] double next01() { return rng.next01(); }
+  };
+
+  // [0, 1)² -> disco unidad sin rechazo (Shirley-Chiu): conserva áreas y la estratificación
+  [[nodiscard]] inline Sample2D concentric_disk(Sample2D s) {
+    double const a = 2.0 * s.u - 1.0;
+    double const b = 2.0 * s.v - 1.0;
+    if (a == 0.0 and b == 0.0) {
+      return {0.0, 0.0};
+    }
+    constexpr double quarter_pi = std::numbers::pi / 4.0;
+    if (std::abs(a) > std::abs(b)) {
+      double const phi = quarter_pi * (b / a);
+      return {a * std::cos(phi), a * std::sin(phi)};
+    }
+    double const phi = 2.0 * quarter_pi - quarter_pi * (a / b);
+    return {b * std::cos(phi), b * std::sin(phi)};
+  }
+
+}  // namespace render
@@ -1,5 +1,7 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "render/vector.hpp"
@@ -16,26 +18,67 @@ namespace render {
     double ior{1.5};            // solo refractive (>1)
   };
 
+  // Material sin asignar (esferas legacy "sphere cx cy cz r")
+  inline constexpr std::uint32_t no_material = 0xFFFF'FFFFU;
+
+  // Nombre de objeto de las esferas legacy: este bit más la línea de la que salieron. El texto
+  // ("__legacy<línea>") solo se genera si alguien lo pide (Scene::sphere_name).
+  inline constexpr std::uint32_t legacy_name = 0x8000'0000U;
+
+  // Nombres de objeto de una escena, todos seguidos en un único buffer: un id por nombre en
+  // vez de un std::string (y su reserva de memoria) por objeto
+  class NameTable {
+  public:
+    std::uint32_t add(std::string_view name);
+
+    // Añade todos los de 'other' detrás; devuelve lo que hay que sumar a sus ids
+    std::uint32_t append(NameTable const & other);
+
+    [[nodiscard]] std::string_view operator[](std::uint32_t id) const {
+      return std::string_view{m_chars}.substr(m_ends[id] - length(id), length(id));
+    }
+
+    [[nodiscard]] std::size_t size() const { return m_ends.size(); }
+
+    void reserve(std::size_t names) { m_ends.reserve(names); }
+
+  private:
+    [[nodiscard]] std::size_t length(std::uint32_t id) const {
+      return m_ends[id] - ((id == 0U) ? 0U : m_ends[id - 1U]);
+    }
+
+    std::string m_chars;
+    std::vector<std::size_t> m_ends;  // fin de cada nombre en m_chars
+  };
+
   struct Sphere {
-    std::string name;
     Vec3 center;
     double radius{0.0};
-    std::string mat;  // nombre del material (puede estar vacío en legacy)
+    std::uint32_t mat{no_material};  // índice en Scene::materials (no_material en legacy)
+    std::uint32_t name{};            // id en Scene::names, o legacy_name | línea
   };
 
   struct Cylinder {
-    std::string name;
     Vec3 base;  // punto base
     Vec3 axis;  // vector eje (se normaliza)
     double height{0.0};
     double radius{0.0};
-    std::string mat;  // nombre del material
+    std::uint32_t mat{no_material};  // índice en Scene::materials
+    std::uint32_t name{};            // id en Scene::names
   };
 
   struct Scene {
     std::vector<Material> materials;
     std::vector<Sphere> spheres;
     std::vector<Cylinder> cylinders;
+    NameTable names;  // nombres de esferas y cilindros
+
+    // Nombres para mensajes y herramientas: se construyen al pedirlos
+    [[nodiscard]] std::string sphere_name(std::size_t i) const;
+    [[nodiscard]] std::string cylinder_name(std::size_t i) const;
+
+    // "" para no_material
+    [[nodiscard]] std::string_view material_name(std::uint32_t id) const;
   };
 
   struct SceneStats {
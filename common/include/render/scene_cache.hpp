@@ -0,0 +1,77 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "render/bvh.hpp"
+#include "render/compiled_scene.hpp"
+
+namespace render {
+
+  // Caché binaria de la escena compilada: lo que sale de CompiledScene::compile (primitivas
+  // precalculadas y materiales ya resueltos a índices) y, si se quiere, el BVH. Se carga con
+  // mmap y solo se recalculan los spans sobre el bloque proyectado (CompiledScene::adopt):
+  // nada que parsear ni que copiar, salvo los nodos del BVH.
+  //
+  // Fichero, en el orden de bytes de la máquina:
+  //   SceneCacheHeader (64 bytes)
+  //   bloque de CompiledScene (scene_bytes, múltiplo de 64)
+  //   nodos del BVH (bvh_nodes * Bvh::node_size)
+  //   índices de primitiva del BVH (bvh_prims * 4)
+  // Va ligada al contenido del fichero de texto (source_hash = hash_file) y a la disposición
+  // en memoria de quien la escribió (layout): si cambia cualquiera de las dos, no se usa.
+  struct SceneCacheHeader {
+    std::array<char, 4> magic{'R', 'S', 'C', 'N'};
+    std::uint32_t version{1};
+    std::uint64_t source_hash{};
+    std::uint64_t layout{};  // scene_cache_layout() del que la escribió
+    std::uint32_t spheres{}, cylinders{}, materials{};
+    std::uint32_t reserved{};
+    std::uint64_t scene_bytes{};
+    std::uint64_t bvh_nodes{};  // 0 => sin BVH
+    std::uint64_t bvh_prims{};
+  };
+  static_assert(sizeof(SceneCacheHeader) == CompiledScene::alignment);
+
+  // Huella de todo lo que decide la disposición binaria: tamaños de los tipos, orden de
+  // bytes y parámetros de construcción del BVH
+  [[nodiscard]] std::uint64_t scene_cache_layout();
+
+  struct CachedScene {
+    CompiledScene scene;
+    std::optional<Bvh> bvh;  // vacío si la caché se escribió sin él
+  };
+
+  // Escribe en path + ".tmp" y renombra, como los checkpoints: quien tenga proyectada la
+  // versión anterior la sigue viendo entera. false (y el motivo en *err) si falla.
+  [[nodiscard]] bool write_scene_cache(std::string const & path, std::uint64_t source_hash,
+                                       CompiledScene const & scn, Bvh const * bvh,
+                                       std::string * err);
+
+  // nullopt (y el motivo en *err) si no existe, no es una caché, es de otra versión o de otra
+  // disposición, no corresponde a source_hash o está truncada
+  [[nodiscard]] std::optional<CachedScene> load_scene_cache(std::string const & path,
+                                                            std::uint64_t source_hash,
+                                                            std::string * err);
+
+  // Escena lista para el render: de la caché si está al día y, si no, parseando el texto,
+  // compilando y construyendo el BVH (y reescribiendo la caché si cache_path no está vacío).
+  // El texto se proyecta una sola vez y el hash y el parser leen esa misma proyección: la
+  // caché nunca se escribe con el hash de un contenido y la escena de otro.
+  struct LoadedScene {
+    CompiledScene scene;
+    Bvh bvh;
+    std::uint64_t source_hash{};  // hash_file(scene_path); 0 si no se ha pedido
+    bool from_cache{false};
+  };
+
+  // El hash del texto solo se calcula si hace falta: con caché o si lo pide hash_source (los
+  // checkpoints lo meten en su huella). nullopt con el error del parser en *err; los
+  // problemas con la caché no son errores (se parsea el texto) y se cuentan en *note.
+  [[nodiscard]] std::optional<LoadedScene> load_scene(std::string const & scene_path,
+                                                      std::string const & cache_path,
+                                                      bool hash_source, std::string * err,
+                                                      std::string * note);
+
+}  // namespace render
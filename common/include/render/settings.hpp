@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "render/camera.hpp"
+#include "render/config.hpp"
+#include "render/ppm.hpp"
+#include "render/sampler.hpp"
+#include "render/tiles.hpp"
+#include "render/vector.hpp"
+
+namespace render {
+
+  // Parámetros efectivos del render, resueltos una sola vez antes de empezar: los del Config
+  // con los overrides RENDER_* del entorno aplicados encima. Inmutable durante el render; el
+  // bucle caliente no vuelve a mirar ni el entorno ni el Config.
+  struct RenderSettings {
+    std::uint32_t width{};
+    std::uint32_t height{};
+    double vfov_deg{};
+    vector lookfrom, lookat, vup;
+    double aperture{};
+    double focus_dist{};
+    std::uint32_t spp{};      // muestras por píxel (el máximo si es adaptativo)
+    std::uint32_t min_spp{};  // con adaptativo: mínimo antes de poder parar (>= 2, <= spp)
+    double adaptive_threshold{};
+    std::uint64_t seed{};
+    SamplerKind sampler{SamplerKind::Random};
+    int max_depth{};
+    int rr_depth{};
+    double gamma{};
+    TileOptions tiles;
+    PpmFormat format{PpmFormat::P3};
+    std::string spp_image;  // si no está vacío: imagen de depuración con las muestras por píxel
+    double time_budget{};       // progresivo: segundos de pared (0 = hasta spp)
+    double preview_interval{};  // progresivo: segundos entre salidas intermedias (0 = ninguna)
+    std::string preview_path;   // destino de las salidas intermedias (vacío = el de la final)
+    double checkpoint_interval{};  // progresivo: segundos entre checkpoints (0 = ninguno)
+    std::string checkpoint_path;   // vacío = el de la salida final + ".ckpt"
+    std::string scene_cache;       // caché binaria de la escena compilada (vacío = sin caché)
+    int stream_rows{};             // > 0: render por bandas de estas filas, sin framebuffer
+
+    [[nodiscard]] bool adaptive() const { return adaptive_threshold > 0.0 and min_spp < spp; }
+
+    [[nodiscard]] bool progressive() const {
+      return time_budget > 0.0 or preview_interval > 0.0 or checkpoint_interval > 0.0;
+    }
+
+    [[nodiscard]] Lens lens() const { return (aperture > 0.0) ? Lens::Thin : Lens::Pinhole; }
+
+    [[nodiscard]] camera make_camera() const;
+  };
+
+  // Lector del entorno (inyectable en los tests); nullptr si la variable no existe
+  using EnvLookup = std::function<char const *(char const *)>;
+
+  // Overrides reconocidos (mismo formato que leían los mains):
+  //   RENDER_VFOV, RENDER_APERTURE, RENDER_FOCUS          -> double
+  //   RENDER_SPP, RENDER_SEED, RENDER_TILE, RENDER_THREADS -> entero > 0 (si no, se ignora)
+  //   RENDER_FROM, RENDER_AT, RENDER_VUP                   -> "x,y,z"
+  //   RENDER_ADAPTIVE                                      -> umbral (double, 0 = off)
+  //   RENDER_MIN_SPP                                       -> entero > 0
+  //   RENDER_SAMPLER                                       -> random | stratified | sobol | r2
+  //   RENDER_PPM_FORMAT                                    -> p3 | p6
+  //   RENDER_SPP_IMAGE                                     -> ruta del PPM de muestras
+  //   RENDER_TIME_BUDGET, RENDER_PREVIEW_EVERY             -> segundos (double, 0 = off)
+  //   RENDER_PREVIEW                                       -> ruta de las salidas intermedias
+  //   RENDER_CHECKPOINT_EVERY                              -> segundos (double, 0 = off)
+  //   RENDER_CHECKPOINT                                    -> ruta del checkpoint
+  //   RENDER_SCENE_CACHE                                   -> ruta de la caché de escena
+  //   RENDER_STREAM_ROWS                                   -> entero > 0 (filas por banda)
+  [[nodiscard]] RenderSettings resolve_settings(Config const & cfg, EnvLookup const & env);
+
+  // Con std::getenv
+  [[nodiscard]] RenderSettings resolve_settings(Config const & cfg);
+
+}  // namespace render
@@ -0,0 +1,374 @@
+#pragma once
+// Envoltorio mínimo sobre SIMD de doble precisión para los kernels de intersección.
+//
+// dvec = N doubles (AVX: 4, SSE2 / NEON: 2, escalar: 1) y dmask = máscara por carril.
+// El backend se elige al compilar según la ISA del target; con RENDER_NO_SIMD se fuerza el
+// escalar. Todas las operaciones son IEEE sin contracción (sin FMA), así que un kernel
+// escrito con las mismas operaciones y en el mismo orden que su versión escalar da
+// resultados idénticos bit a bit.
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+#if !defined(RENDER_NO_SIMD) and defined(__AVX__)
+  #define RENDER_SIMD_AVX 1
+  #include <immintrin.h>
+#elif !defined(RENDER_NO_SIMD) and (defined(__SSE2__) or defined(_M_X64))
+  #define RENDER_SIMD_SSE2 1
+  #include <emmintrin.h>
+#elif !defined(RENDER_NO_SIMD) and defined(__ARM_NEON) and defined(__aarch64__)
+  #define RENDER_SIMD_NEON 1
+  #include <arm_neon.h>
+#endif
+
+namespace render::simd {
+
+#if defined(RENDER_SIMD_AVX)
+
+  inline constexpr char const * backend = "avx";
+
+  struct dmask {
+    __m256d v;
+  };
+
+  struct dvec {
+    static constexpr std::size_t lanes = 4;
+    __m256d v;
+  };
+
+  inline dvec broadcast(double x) {
+    return {_mm256_set1_pd(x)};
+  }
+
+  inline dvec load(double const * p) {
+    return {_mm256_loadu_pd(p)};
+  }
+
+  inline void store(double * p, dvec a) {
+    _mm256_storeu_pd(p, a.v);
+  }
+
+  inline dvec operator+(dvec a, dvec b) {
+    return {_mm256_add_pd(a.v, b.v)};
+  }
+
+  inline dvec operator-(dvec a, dvec b) {
+    return {_mm256_sub_pd(a.v, b.v)};
+  }
+
+  inline dvec operator*(dvec a, dvec b) {
+    return {_mm256_mul_pd(a.v, b.v)};
+  }
+
+  inline dvec operator/(dvec a, dvec b) {
+    return {_mm256_div_pd(a.v, b.v)};
+  }
+
+  // Cambia el bit de signo (igual que el '-x' escalar, también para ±0)
+  inline dvec operator-(dvec a) {
+    return {_mm256_xor_pd(a.v, _mm256_set1_pd(-0.0))};
+  }
+
+  inline dvec sqrt(dvec a) {
+    return {_mm256_sqrt_pd(a.v)};
+  }
+
+  inline dmask operator<(dvec a, dvec b) {
+    return {_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ)};
+  }
+
+  inline dmask operator<=(dvec a, dvec b) {
+    return {_mm256_cmp_pd(a.v, b.v, _CMP_LE_OQ)};
+  }
+
+  inline dmask operator>=(dvec a, dvec b) {
+    return {_mm256_cmp_pd(a.v, b.v, _CMP_GE_OQ)};
+  }
+
+  inline dmask operator>(dvec a, dvec b) {
+    return {_mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ)};
+  }
+
+  inline dmask operator&(dmask a, dmask b) {
+    return {_mm256_and_pd(a.v, b.v)};
+  }
+
+  inline dmask operator|(dmask a, dmask b) {
+    return {_mm256_or_pd(a.v, b.v)};
+  }
+
+  // m ? a : b por carril
+  inline dvec select(dmask m, dvec a, dvec b) {
+    return {_mm256_blendv_pd(b.v, a.v, m.v)};
+  }
+
+  inline bool any(dmask m) {
+    return _mm256_movemask_pd(m.v) != 0;
+  }
+
+#elif defined(RENDER_SIMD_SSE2)
+
+  inline constexpr char const * backend = "sse2";
+
+  struct dmask {
+    __m128d v;
+  };
+
+  struct dvec {
+    static constexpr std::size_t lanes = 2;
+    __m128d v;
+  };
+
+  inline dvec broadcast(double x) {
+    return {_mm_set1_pd(x)};
+  }
+
+  inline dvec load(double const * p) {
+    return {_mm_loadu_pd(p)};
+  }
+
+  inline void store(double * p, dvec a) {
+    _mm_storeu_pd(p, a.v);
+  }
+
+  inline dvec operator+(dvec a, dvec b) {
+    return {_mm_add_pd(a.v, b.v)};
+  }
+
+  inline dvec operator-(dvec a, dvec b) {
+    return {_mm_sub_pd(a.v, b.v)};
+  }
+
+  inline dvec operator*(dvec a, dvec b) {
+    return {_mm_mul_pd(a.v, b.v)};
+  }
+
+  inline dvec operator/(dvec a, dvec b) {
+    return {_mm_div_pd(a.v, b.v)};
+  }
+
+  inline dvec operator-(dvec a) {
+    return {_mm_xor_pd(a.v, _mm_set1_pd(-0.0))};
+  }
+
+  inline dvec sqrt(dvec a) {
+    return {_mm_sqrt_pd(a.v)};
+  }
+
+  inline dmask operator<(dvec a, dvec b) {
+    return {_mm_cmplt_pd(a.v, b.v)};
+  }
+
+  inline dmask operator<=(dvec a, dvec b) {
+    return {_mm_cmple_pd(a.v, b.v)};
+  }
+
+  inline dmask operator>=(dvec a, dvec b) {
+    return {_mm_cmpge_pd(a.v, b.v)};
+  }
+
+  inline dmask operator>(dvec a, dvec b) {
+    return {_mm_cmpgt_pd(a.v, b.v)};
+  }
+
+  inline dmask operator&(dmask a, dmask b) {
+    return {_mm_and_pd(a.v, b.v)};
+  }
+
+  inline dmask operator|(dmask a, dmask b) {
+    return {_mm_or_pd(a.v, b.v)};
+  }
+
+  // Sin blendv en SSE2: (m & a) | (~m & b)
+  inline dvec select(dmask m, dvec a, dvec b) {
+    return {_mm_or_pd(_mm_and_pd(m.v, a.v), _mm_andnot_pd(m.v, b.v))};
+  }
+
+  inline bool any(dmask m) {
+    return _mm_movemask_pd(m.v) != 0;
+  }
+
+#elif defined(RENDER_SIMD_NEON)
+
+  inline constexpr char const * backend = "neon";
+
+  struct dmask {
+    uint64x2_t v;
+  };
+
+  struct dvec {
+    static constexpr std::size_t lanes = 2;
+    float64x2_t v;
+  };
+
+  inline dvec broadcast(double x) {
+    return {vdupq_n_f64(x)};
+  }
+
+  inline dvec load(double const * p) {
+    return {vld1q_f64(p)};
+  }
+
+  inline void store(double * p, dvec a) {
+    vst1q_f64(p, a.v);
+  }
+
+  inline dvec operator+(dvec a, dvec b) {
+    return {vaddq_f64(a.v, b.v)};
+  }
+
+  inline dvec operator-(dvec a, dvec b) {
+    return {vsubq_f64(a.v, b.v)};
+  }
+
+  inline dvec operator*(dvec a, dvec b) {
+    return {vmulq_f64(a.v, b.v)};
+  }
+
+  inline dvec operator/(dvec a, dvec b) {
+    return {vdivq_f64(a.v, b.v)};
+  }
+
+  inline dvec operator-(dvec a) {
+    return {vnegq_f64(a.v)};
+  }
+
+  inline dvec sqrt(dvec a) {
+    return {vsqrtq_f64(a.v)};
+  }
+
+  inline dmask operator<(dvec a, dvec b) {
+    return {vcltq_f64(a.v, b.v)};
+  }
+
+  inline dmask operator<=(dvec a, dvec b) {
+    return {vcleq_f64(a.v, b.v)};
+  }
+
+  inline dmask operator>=(dvec a, dvec b) {
+    return {vcgeq_f64(a.v, b.v)};
+  }
+
+  inline dmask operator>(dvec a, dvec b) {
+    return {vcgtq_f64(a.v, b.v)};
+  }
+
+  inline dmask operator&(dmask a, dmask b) {
+    return {vandq_u64(a.v, b.v)};
+  }
+
+  inline dmask operator|(dmask a, dmask b) {
+    return {vorrq_u64(a.v, b.v)};
+  }
+
+  inline dvec select(dmask m, dvec a, dvec b) {
+    return {vbslq_f64(m.v, a.v, b.v)};
+  }
+
+  inline bool any(dmask m) {
+    return vmaxvq_u32(vreinterpretq_u32_u64(m.v)) != 0;
+  }
+
+#else
+
+  // Respaldo escalar: un carril, mismas operaciones
+  inline constexpr char const * backend = "scalar";
+
+  struct dmask {
+    bool v;
+  };
+
+  struct dvec {
+    static constexpr std::size_t lanes = 1;
+    double v;
+  };
+
+  inline dvec broadcast(double x) {
+    return {x};
+  }
+
+  inline dvec load(double const * p) {
+    return {*p};
+  }
+
+  inline void store(double * p, dvec a) {
+    *p = a.v;
+  }
+
+  inline dvec operator+(dvec a, dvec b) {
+    return {a.v + b.v};
+  }
+
+  inline dvec operator-(dvec a, dvec b) {
+    return {a.v - b.v};
+  }
+
+  inline dvec operator*(dvec a, dvec b) {
+    return {a.v * b.v};
+  }
+
+  inline dvec operator/(dvec a, dvec b) {
+    return {a.v / b.v};
+  }
+
+  inline dvec operator-(dvec a) {
+    return {-a.v};
+  }
+
+  inline dvec sqrt(dvec a) {
+    return {std::sqrt(a.v)};
+  }
+
+  inline dmask operator<(dvec a, dvec b) {
+    return {a.v < b.v};
+  }
+
+  inline dmask operator<=(dvec a, dvec b) {
+    return {a.v <= b.v};
+  }
+
+  inline dmask operator>=(dvec a, dvec b) {
+    return {a.v >= b.v};
+  }
+
+  inline dmask operator>(dvec a, dvec b) {
+    return {a.v > b.v};
+  }
+
+  inline dmask operator&(dmask a, dmask b) {
+    return {a.v and b.v};
+  }
+
+  inline dmask operator|(dmask a, dmask b) {
+    return {a.v or b.v};
+  }
+
+  inline dvec select(dmask m, dvec a, dvec b) {
+    return m.v ? a : b;
+  }
+
+  inline bool any(dmask m) {
+    return m.v;
+  }
+
+#endif
+
+  inline constexpr std::size_t lanes = dvec::lanes;
+
+  // Carga por carriles a partir de una función lane -> double (gather escalar)
+  template <class F>
+  inline dvec gather(F && f) {
+    std::array<double, lanes> tmp{};
+    for (std::size_t l = 0; l < lanes; ++l) {
+      tmp[l] = f(l);
+    }
+    return load(tmp.data());
+  }
+
+  inline std::array<double, lanes> to_array(dvec a) {
+    std::array<double, lanes> out{};
+    store(out.data(), a);
+    return out;
+  }
+
+}  // namespace render::simd
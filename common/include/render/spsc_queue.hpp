@@ -0,0 +1,65 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace render {
+
+  // Cola FIFO sin locks de un productor y un consumidor sobre un anillo de capacidad fija
+  // (potencia de 2). Cada índice lo escribe un solo lado y están en líneas de caché distintas;
+  // el productor publica con release y el consumidor lee con acquire. Varios productores valen
+  // si algo externo los serializa (un mutex, por ejemplo).
+  template <class T>
+  class SpscQueue {
+  public:
+    explicit SpscQueue(std::size_t capacity)
+        : m_buf(std::bit_ceil(std::max<std::size_t>(capacity, 1U))), m_mask(m_buf.size() - 1U) {}
+
+    [[nodiscard]] std::size_t capacity() const { return m_buf.size(); }
+
+    // Productor: false si está llena
+    bool try_push(T v) {
+      std::size_t const tail = m_tail.load(std::memory_order_relaxed);
+      if (tail - m_head.load(std::memory_order_acquire) == m_buf.size()) {
+        return false;
+      }
+      m_buf[tail & m_mask] = std::move(v);
+      m_tail.store(tail + 1U, std::memory_order_release);
+      m_tail.notify_one();
+      return true;
+    }
+
+    // Consumidor: nullopt si está vacía
+    [[nodiscard]] std::optional<T> try_pop() {
+      std::size_t const head = m_head.load(std::memory_order_relaxed);
+      if (head == m_tail.load(std::memory_order_acquire)) {
+        return std::nullopt;
+      }
+      T v = std::move(m_buf[head & m_mask]);
+      m_head.store(head + 1U, std::memory_order_release);
+      return v;
+    }
+
+    // Consumidor: espera (atomic::wait, sin girar) hasta que haya algo
+    [[nodiscard]] T pop() {
+      std::size_t const head = m_head.load(std::memory_order_relaxed);
+      m_tail.wait(head, std::memory_order_acquire);
+      T v = std::move(m_buf[head & m_mask]);
+      m_head.store(head + 1U, std::memory_order_release);
+      return v;
+    }
+
+  private:
+    static_assert(std::atomic<std::size_t>::is_always_lock_free);
+
+    std::vector<T> m_buf;
+    std::size_t m_mask;
+    alignas(64) std::atomic<std::size_t> m_head{0};  // siguiente a leer (solo el consumidor)
+    alignas(64) std::atomic<std::size_t> m_tail{0};  // siguiente a escribir (solo el productor)
+  };
+
+}  // namespace render
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+
+namespace render {
+
+  // Render por bandas de filas sin framebuffer completo. Los hilos renderizan bandas en
+  // paralelo (cada una en su hueco de un anillo de 'window' buffers) y se entregan en orden de
+  // filas a un hilo escritor propio por una cola sin locks (SpscQueue): una banda terminada
+  // antes que la anterior espera en el anillo (el buffer de reordenación) y la codificación y
+  // la E/S de una banda se solapan con el render de las siguientes. Ningún hilo empieza la
+  // banda b hasta que la b - window se ha escrito, así que la memoria es
+  // window * band_rows * width * 3 bytes sea cual sea la altura de la imagen.
+  struct BandOptions {
+    int band_rows{16};
+    unsigned threads{0};    // 0 => std::thread::hardware_concurrency()
+    std::size_t window{0};  // bandas en vuelo como máximo (0 => 2 por hilo)
+  };
+
+  struct BandStats {
+    std::size_t bands{};
+    std::size_t window{};        // efectivo
+    std::size_t max_pending{};   // máximo de bandas terminadas esperando su turno
+    std::size_t buffer_bytes{};  // memoria del anillo
+    double seconds{};            // de pared, de la primera banda a la última escrita
+    double write_seconds{};      // del escritor dentro de emit (codificación + E/S)
+    double write_overlap{};      // parte de write_seconds mientras aún se renderizaba
+  };
+
+  // Llena las filas [y0, y1) en rgb ((y1 - y0) * width * 3 bytes, RGB intercalado)
+  using BandRenderFn = std::function<void(int y0, int y1, std::span<std::uint8_t> rgb)>;
+  // Recibe las bandas en orden, en el hilo escritor; false para abortar (error de escritura)
+  using BandEmitFn = std::function<bool(std::span<std::uint8_t const> rgb)>;
+
+  // true si se han escrito todas las bandas. Si emit falla no se lanzan más bandas y las que
+  // estén en curso terminan sin entregarse.
+  bool render_bands(int width, int height, BandOptions const & opts, BandRenderFn const & render,
+                    BandEmitFn const & emit, BandStats * stats = nullptr);
+
+}  // namespace render
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace render {
+
+  // Rectángulo [x0, x1) x [y0, y1) de la imagen. Los tiles de una partición son disjuntos,
+  // así que cada hilo puede escribir sus píxeles en la imagen sin locks.
+  struct Tile {
+    int x0{}, y0{}, x1{}, y1{};
+    std::size_t index{};  // orden raster del tile (no depende del nº de hilos)
+  };
+
+  struct TileOptions {
+    int tile_size{32};    // lado del tile en píxeles (los del borde pueden ser menores)
+    unsigned threads{0};  // 0 => std::thread::hardware_concurrency()
+  };
+
+  // Parte la imagen en tiles cuadrados en orden raster (filas de tiles de arriba a abajo).
+  [[nodiscard]] std::vector<Tile> make_tiles(int width, int height, int tile_size);
+
+  // Nº efectivo de hilos: 'requested' si > 0, si no el del hardware (mínimo 1).
+  [[nodiscard]] unsigned resolve_thread_count(unsigned requested);
+
+  // Llama a fn(i) para i en [0, n) repartiendo los índices entre hilos con una cola atómica
+  // (cada hilo toma el siguiente libre). Con un solo hilo, en orden en el hilo llamante.
+  void parallel_for(std::size_t n, unsigned threads, std::function<void(std::size_t)> const & fn);
+
+  // Reparte los tiles entre hilos con una cola atómica; fn se llama exactamente una vez por tile.
+  // Con un solo hilo no se lanza ninguno: se recorre en orden en el hilo llamante.
+  void render_tiles(int width, int height, TileOptions const & opts,
+                    std::function<void(Tile const &)> const & fn);
+
+}  // namespace render
@@ -0,0 +1,410 @@
+#include "render/bvh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <span>
+
+#include "render/hits.hpp"
+#include "render/hits_wide.hpp"
+
+namespace render {
+
+  // ───────────────────────── AABB ─────────────────────────
+  void Aabb::grow(vector const & p) {
+    lo = vector{std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z)};
+    hi = vector{std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z)};
+  }
+
+  void Aabb::grow(Aabb const & b) {
+    if (b.empty()) {
+      return;
+    }
+    grow(b.lo);
+    grow(b.hi);
+  }
+
+  double Aabb::surface_area() const {
+    if (empty()) {
+      return 0.0;
+    }
+    vector const d = hi - lo;
+    return 2.0 * (d.x * d.y + d.y * d.z + d.z * d.x);
+  }
+
+  Aabb bounds_of(Sphere const & s) {
+    vector const r{s.radius, s.radius, s.radius};
+    Aabb b;
+    b.grow(s.center - r);
+    b.grow(s.center + r);
+    return b;
+  }
+
+  Aabb bounds_of(Cylinder const & c) {
+    return bounds_of(precompute_cylinder(c.base, c.axis, c.height, c.radius), c.radius);
+  }
+
+  Aabb bounds_of(CylinderPre const & c, double radius) {
+    // Cada tapa es un disco de radio r con normal 'ax': su extensión en el eje i es
+    // r * sqrt(1 - ax_i^2). La caja del cilindro es la unión de las cajas de ambos discos.
+    vector const & ax = c.ax;
+    vector const e{radius * std::sqrt(std::max(0.0, 1.0 - ax.x * ax.x)),
+                   radius * std::sqrt(std::max(0.0, 1.0 - ax.y * ax.y)),
+                   radius * std::sqrt(std::max(0.0, 1.0 - ax.z * ax.z))};
+    Aabb b;
+    b.grow(c.p0 - e);
+    b.grow(c.p0 + e);
+    b.grow(c.p1 - e);
+    b.grow(c.p1 + e);
+    return b;
+  }
+
+  namespace {
+
+    [[nodiscard]] double axis_of(vector const & v, int axis) {
+      if (axis == 0) {
+        return v.x;
+      }
+      return (axis == 1) ? v.y : v.z;
+    }
+
+    // Test de slabs. Devuelve la t de entrada en 'tenter' si el rayo cruza la caja en
+    // [t_min, t_max].
+    [[nodiscard]] inline bool hit_box(Aabb const & b, vector const & o, vector const & inv,
+                                      double t_min, double t_max, double & tenter) {
+      double tx0 = (b.lo.x - o.x) * inv.x;
+      double tx1 = (b.hi.x - o.x) * inv.x;
+      double ty0 = (b.lo.y - o.y) * inv.y;
+      double ty1 = (b.hi.y - o.y) * inv.y;
+      double tz0 = (b.lo.z - o.z) * inv.z;
+      double tz1 = (b.hi.z - o.z) * inv.z;
+
+      double const t0 =
+          std::max({t_min, std::min(tx0, tx1), std::min(ty0, ty1), std::min(tz0, tz1)});
+      double const t1 =
+          std::min({t_max, std::max(tx0, tx1), std::max(ty0, ty1), std::max(tz0, tz1)});
+      tenter = t0;
+      return t0 <= t1;
+    }
+
+    // Esferas o cilindros (por índice o tramo contiguo) con los kernels SIMD; actualiza *out
+    // y t_closest si mejora
+    template <PrimKind Kind, class... Range>
+    inline bool hit_group(CompiledScene const & scn, ray const & r, double t_min,
+                          double & t_closest, Hit * out, Range... range) {
+      double t{};
+      vector n;
+      std::uint32_t index{};
+      bool hit = false;
+      if constexpr (Kind == PrimKind::Sphere) {
+        hit = hit_spheres_wide(scn.spheres(), range..., r, t_min, t_closest, &t, &n, &index);
+      } else {
+        hit = hit_cylinders_wide(scn.cylinders(), range..., r, t_min, t_closest, &t, &n, &index);
+      }
+      if (!hit) {
+        return false;
+      }
+      t_closest = t;
+      if (out != nullptr) {
+        *out = Hit{t, n, Kind, index};
+      }
+      return true;
+    }
+
+  }  // namespace
+
+  // ───────────────────── Construcción (SAH por bins) ────────────────────
+  struct BvhBuilder {
+    struct Item {
+      Bvh::PrimRef ref;
+      Aabb box;
+      vector centroid;
+    };
+
+    Bvh & bvh;
+    std::vector<Item> items;
+
+    // Por debajo de esta profundidad solo se parte por la mitad: acota la pila del recorrido
+    static constexpr int max_sah_depth = 64;
+
+    void build_node(std::uint32_t node_idx, std::size_t begin, std::size_t end, int depth) {
+      Aabb box, cbox;
+      for (std::size_t i = begin; i < end; ++i) {
+        box.grow(items[i].box);
+        cbox.grow(items[i].centroid);
+      }
+      bvh.m_nodes[node_idx].box = box;
+
+      std::size_t const count = end - begin;
+      if (count <= static_cast<std::size_t>(Bvh::max_leaf_size)) {
+        make_leaf(node_idx, begin, end);
+        return;
+      }
+
+      // Eje de mayor extensión de los centroides
+      vector const ext = cbox.hi - cbox.lo;
+      int axis         = 0;
+      if (ext.y > ext.x) {
+        axis = 1;
+      }
+      if (ext.z > axis_of(ext, axis)) {
+        axis = 2;
+      }
+      double const lo  = axis_of(cbox.lo, axis);
+      double const len = axis_of(ext, axis);
+
+      std::size_t mid = begin + count / 2;
+      if (len <= 0.0 or depth >= max_sah_depth) {
+        // Centroides coincidentes (o árbol ya muy profundo): partimos por la mitad sin ordenar
+        split_and_recurse(node_idx, begin, mid, end, depth);
+        return;
+      }
+
+      // Bins de centroides
+      struct Bin {
+        Aabb box;
+        std::size_t count{0};
+      };
+
+      std::array<Bin, Bvh::num_bins> bins{};
+      double const scale = static_cast<double>(Bvh::num_bins) / len;
+      auto bin_of        = [&](Item const & it) {
+        auto const b = static_cast<int>((axis_of(it.centroid, axis) - lo) * scale);
+        return static_cast<std::size_t>(std::clamp(b, 0, Bvh::num_bins - 1));
+      };
+      for (std::size_t i = begin; i < end; ++i) {
+        Bin & b = bins[bin_of(items[i])];
+        b.box.grow(items[i].box);
+        ++b.count;
+      }
+
+      // Barrido: área y nº de primitivas a la derecha de cada plano de corte
+      std::array<double, Bvh::num_bins> right_area{};
+      std::array<std::size_t, Bvh::num_bins> right_count{};
+      Aabb acc;
+      std::size_t n = 0;
+      for (std::size_t i = Bvh::num_bins - 1; i > 0; --i) {
+        acc.grow(bins[i].box);
+        n              += bins[i].count;
+        right_area[i]  = acc.surface_area();
+        right_count[i] = n;
+      }
+
+      double best_cost       = 1e300;
+      std::size_t best_plane = 0;
+      acc                    = Aabb{};
+      n                      = 0;
+      for (std::size_t i = 0; i + 1 < Bvh::num_bins; ++i) {
+        acc.grow(bins[i].box);
+        n += bins[i].count;
+        if (n == 0 or right_count[i + 1] == 0) {
+          continue;
+        }
+        double const cost = acc.surface_area() * static_cast<double>(n) +
+                            right_area[i + 1] * static_cast<double>(right_count[i + 1]);
+        if (cost < best_cost) {
+          best_cost  = cost;
+          best_plane = i + 1;
+        }
+      }
+
+      // Coste relativo (traversal = 1, intersección = 1) frente a dejarlo como hoja
+      // (las hojas nunca pasan de 4 * max_leaf_size primitivas)
+      double const leaf_cost  = static_cast<double>(count);
+      double const split_cost = 1.0 + best_cost / box.surface_area();
+      if (best_plane == 0) {
+        split_and_recurse(node_idx, begin, mid, end, depth);
+        return;
+      }
+      if (split_cost >= leaf_cost and count <= 4U * static_cast<std::size_t>(Bvh::max_leaf_size)) {
+        make_leaf(node_idx, begin, end);
+        return;
+      }
+
+      auto it = std::partition(items.begin() + static_cast<std::ptrdiff_t>(begin),
+                               items.begin() + static_cast<std::ptrdiff_t>(end),
+                               [&](Item const & x) { return bin_of(x) < best_plane; });
+      mid     = static_cast<std::size_t>(it - items.begin());
+      split_and_recurse(node_idx, begin, mid, end, depth);
+    }
+
+    // Esferas delante (en su orden) para probarlas todas de una vez con el kernel ancho
+    void make_leaf(std::uint32_t node_idx, std::size_t begin, std::size_t end) {
+      auto const first = items.begin() + static_cast<std::ptrdiff_t>(begin);
+      auto const last  = items.begin() + static_cast<std::ptrdiff_t>(end);
+      auto const split = std::stable_partition(
+          first, last, [](Item const & x) { return x.ref.kind == PrimKind::Sphere; });
+      bvh.m_nodes[node_idx].first   = static_cast<std::uint32_t>(begin);
+      bvh.m_nodes[node_idx].count   = static_cast<std::uint32_t>(end - begin);
+      bvh.m_nodes[node_idx].spheres = static_cast<std::uint32_t>(split - first);
+    }
+
+    void split_and_recurse(std::uint32_t node_idx, std::size_t begin, std::size_t mid,
+                           std::size_t end, int depth) {
+      auto const left = static_cast<std::uint32_t>(bvh.m_nodes.size());
+      bvh.m_nodes.emplace_back();
+      bvh.m_nodes.emplace_back();
+      bvh.m_nodes[node_idx].first = left;
+      bvh.m_nodes[node_idx].count = 0;
+      build_node(left, begin, mid, depth + 1);
+      build_node(left + 1U, mid, end, depth + 1);
+    }
+  };
+
+  Bvh Bvh::build(CompiledScene const & scn) {
+    SphereArrays const & sph   = scn.spheres();
+    CylinderArrays const & cyl = scn.cylinders();
+
+    Bvh bvh;
+    BvhBuilder b{bvh, {}};
+    b.items.reserve(sph.size() + cyl.size());
+    for (std::size_t i = 0; i < sph.size(); ++i) {
+      vector const r{sph.radius[i], sph.radius[i], sph.radius[i]};
+      Aabb box;
+      box.grow(sph.center(i) - r);
+      box.grow(sph.center(i) + r);
+      b.items.push_back({
+        {PrimKind::Sphere, static_cast<std::uint32_t>(i)},
+        box, box.centroid()
+      });
+    }
+    for (std::size_t i = 0; i < cyl.size(); ++i) {
+      Aabb const box = bounds_of(cyl.pre(i), cyl.radius[i]);
+      b.items.push_back({
+        {PrimKind::Cylinder, static_cast<std::uint32_t>(i)},
+        box, box.centroid()
+      });
+    }
+    if (b.items.empty()) {
+      return bvh;
+    }
+
+    // Como mucho 2N-1 nodos
+    bvh.m_nodes.reserve(2 * b.items.size());
+    bvh.m_nodes.emplace_back();
+    b.build_node(0, 0, b.items.size(), 0);
+
+    bvh.m_prim_ids.reserve(b.items.size());
+    for (auto const & it : b.items) {
+      bvh.m_prim_ids.push_back(it.ref.index);
+    }
+    return bvh;
+  }
+
+  std::optional<Bvh> Bvh::from_bytes(std::span<std::byte const> nodes,
+                                     std::span<std::uint32_t const> prim_ids,
+                                     std::size_t spheres, std::size_t cylinders) {
+    if (nodes.size() % sizeof(Node) != 0 or prim_ids.size() != spheres + cylinders) {
+      return std::nullopt;
+    }
+    Bvh bvh;
+    bvh.m_nodes.resize(nodes.size() / sizeof(Node));
+    std::memcpy(bvh.m_nodes.data(), nodes.data(), nodes.size());
+    bvh.m_prim_ids.assign(prim_ids.begin(), prim_ids.end());
+    if (bvh.m_nodes.empty()) {
+      return prim_ids.empty() ? std::optional<Bvh>{std::move(bvh)} : std::nullopt;
+    }
+
+    // Los hijos siempre van detrás del padre y cada nodo tiene un único padre (así los deja
+    // build), de modo que basta una pasada en orden para acotar la profundidad a lo que cabe en
+    // la pila de closest_hit. Un hijo compartido (un DAG) se rechaza: el segundo padre le
+    // rebajaría la profundidad anotada y la pila podría desbordarse. depth 0 = aún sin padre.
+    std::vector<std::uint8_t> depth(bvh.m_nodes.size(), 0);
+    depth[0] = 1U;
+    for (std::size_t i = 0; i < bvh.m_nodes.size(); ++i) {
+      Node const & n = bvh.m_nodes[i];
+      if (n.count == 0) {
+        if (n.first <= i or std::size_t{n.first} + 1U >= bvh.m_nodes.size() or
+            depth[i] >= 127U or depth[n.first] != 0U or depth[n.first + 1U] != 0U)
+        {
+          return std::nullopt;
+        }
+        depth[n.first]      = static_cast<std::uint8_t>(depth[i] + 1U);
+        depth[n.first + 1U] = static_cast<std::uint8_t>(depth[i] + 1U);
+        continue;
+      }
+      if (std::size_t{n.first} + n.count > prim_ids.size() or n.spheres > n.count) {
+        return std::nullopt;
+      }
+      for (std::uint32_t k = 0; k < n.count; ++k) {
+        if (prim_ids[n.first + k] >= ((k < n.spheres) ? spheres : cylinders)) {
+          return std::nullopt;
+        }
+      }
+    }
+    return bvh;
+  }
+
+  // ───────────────────────── Consultas ─────────────────────────
+  bool Bvh::closest_hit(CompiledScene const & scn, ray const & r, double t_min, double t_max,
+                        Hit * out) const {
+    if (m_nodes.empty()) {
+      return false;
+    }
+    vector const inv{1.0 / r.direction.x, 1.0 / r.direction.y, 1.0 / r.direction.z};
+
+    double t_closest = t_max;
+    bool hit_any     = false;
+
+    // Pila explícita: la construcción limita la profundidad a 64 + log2(N) < 128
+    std::array<std::uint32_t, 128> stack{};
+    std::size_t sp = 0;
+    stack[sp++]    = 0;
+
+    while (sp > 0) {
+      Node const & node = m_nodes[stack[--sp]];
+      double tenter{};
+      if (!hit_box(node.box, r.origin, inv, t_min, t_closest, tenter)) {
+        continue;
+      }
+
+      if (node.count > 0) {
+        std::span<std::uint32_t const> const ids{m_prim_ids.data() + node.first, node.count};
+        if (node.spheres > 0) {
+          hit_any = hit_group<PrimKind::Sphere>(scn, r, t_min, t_closest, out,
+                                                ids.first(node.spheres)) or
+                    hit_any;
+        }
+        if (node.spheres < node.count) {
+          hit_any = hit_group<PrimKind::Cylinder>(scn, r, t_min, t_closest, out,
+                                                  ids.subspan(node.spheres)) or
+                    hit_any;
+        }
+        continue;
+      }
+
+      // Primero el hijo más cercano (se apila el último)
+      double tl{}, tr{};
+      bool const hl = hit_box(m_nodes[node.first].box, r.origin, inv, t_min, t_closest, tl);
+      bool const hr = hit_box(m_nodes[node.first + 1U].box, r.origin, inv, t_min, t_closest, tr);
+      if (hl and hr) {
+        if (tl <= tr) {
+          stack[sp++] = node.first + 1U;
+          stack[sp++] = node.first;
+        } else {
+          stack[sp++] = node.first;
+          stack[sp++] = node.first + 1U;
+        }
+      } else if (hl) {
+        stack[sp++] = node.first;
+      } else if (hr) {
+        stack[sp++] = node.first + 1U;
+      }
+    }
+    return hit_any;
+  }
+
+  bool closest_hit_linear(CompiledScene const & scn, ray const & r, double t_min, double t_max,
+                          Hit * out) {
+    double t_closest = t_max;
+    bool hit_any     = false;
+    hit_any = hit_group<PrimKind::Sphere>(scn, r, t_min, t_closest, out, std::size_t{0},
+                                          scn.spheres().size());
+    hit_any = hit_group<PrimKind::Cylinder>(scn, r, t_min, t_closest, out, std::size_t{0},
+                                            scn.cylinders().size()) or
+              hit_any;
+    return hit_any;
+  }
+
+}  // namespace render
@@ -1,22 +1,11 @@
 #include "render/camera.hpp"
+#include "render/sampler.hpp"
 
 #include <cmath>    // tan, numbers::pi
 #include <numbers>  // std::numbers::pi
 
 namespace render {
 
-  // muestreo uniforme en disco unidad para la lente
-  static inline std::pair<double, double> random_in_unit_disk(
-      std::mt19937_64 & rng, std::uniform_real_distribution<double> & dist) {
-    for (;;) {
-      double x = 2.0 * dist(rng) - 1.0;
-      double y = 2.0 * dist(rng) - 1.0;
-      if (x * x + y * y < 1.0) {
-        return {x, y};
-      }
-    }
-  }
-
   // Helper to compute camera geometry; extracted from constructor to reduce constructor complexity.
   namespace {
 
@@ -106,9 +95,11 @@ namespace render {
   camera::camera(std::uint32_t image_width, std::uint32_t image_height, double vfov_deg,
                  vector const & lookfrom, vector const & lookat, vector const & vup,
                  std::uint32_t samples_per_pixel, std::uint64_t seed, double aperture,
-                 double focus_dist)
+                 double focus_dist, SamplerKind sampler)
       : m_image_width(image_width), m_image_height(image_height),
-        m_samples_per_pixel(samples_per_pixel), m_origin(lookfrom), m_rng(seed), m_dist(0.0, 1.0) {
+        m_samples_per_pixel(samples_per_pixel), m_strata(strata_grid(samples_per_pixel)),
+        m_origin(lookfrom), m_seed(seed),
+        m_sampler(sampler) {
     // === Base de cámara (igual que tus helpers) ===
     m_w            = (lookfrom - lookat).normalized();  // mira de lookat -> lookfrom
     m_u            = (vup.cross(m_w)).normalized();     // derecha
@@ -137,30 +128,40 @@ namespace render {
     m_lens_radius = 0.5 * aperture;
   }
 
-  ray camera::get_ray(std::uint32_t px, std::uint32_t py, std::uint32_t /*sample_id*/) {
-    // 1) Jitter subpixel (igual que antes)
-    double jitter_x = m_dist(m_rng);
-    double jitter_y = m_dist(m_rng);
+  ray camera::get_ray(std::uint32_t px, std::uint32_t py, std::uint32_t sample_id) const {
+    return (lens() == Lens::Pinhole) ? get_ray<Lens::Pinhole>(px, py, sample_id)
+                                     : get_ray<Lens::Thin>(px, py, sample_id);
+  }
+
+  template <Lens L>
+  ray camera::get_ray(std::uint32_t px, std::uint32_t py, std::uint32_t sample_id) const {
+    PixelKey const key{m_seed, px, py, m_strata};
 
-    double px_f       = static_cast<double>(px) + jitter_x;
-    double py_flipped = (static_cast<double>(m_image_height - 1U - py)) + jitter_y;
+    // 1) Jitter subpixel
+    Sample2D const jitter = sample_2d(m_sampler, key, sample_id, dim_pixel);
+
+    double px_f       = static_cast<double>(px) + jitter.u;
+    double py_flipped = (static_cast<double>(m_image_height - 1U - py)) + jitter.v;
 
     vector pixel_sample =
         m_lower_left_corner + px_f * m_pixel_delta_u + py_flipped * m_pixel_delta_v;
 
-    if (m_lens_radius <= 0.0) {
+    if constexpr (L == Lens::Pinhole) {
       // Pinhole (comportamiento anterior)
       vector dir = (pixel_sample - m_origin).normalized();
       return {m_origin, dir};
+    } else {
+      // 2) DOF: desplaza el origen en el disco de la lente (plano u-v), sin rechazo
+      Sample2D const d = concentric_disk(sample_2d(m_sampler, key, sample_id, dim_lens));
+      vector offset    = (d.u * m_lens_radius) * m_u + (d.v * m_lens_radius) * m_v;
+
+      vector origin = m_origin + offset;
+      vector dir    = (pixel_sample - origin).normalized();
+      return {origin, dir};
     }
-
-    // 2) DOF: desplaza el origen en el disco de la lente (plano u-v)
-    auto [dx, dy] = random_in_unit_disk(m_rng, m_dist);
-    vector offset = (dx * m_lens_radius) * m_u + (dy * m_lens_radius) * m_v;
-
-    vector origin = m_origin + offset;
-    vector dir    = (pixel_sample - origin).normalized();
-    return {origin, dir};
   }
 
+  template ray camera::get_ray<Lens::Pinhole>(std::uint32_t, std::uint32_t, std::uint32_t) const;
+  template ray camera::get_ray<Lens::Thin>(std::uint32_t, std::uint32_t, std::uint32_t) const;
+
 }  // namespace render
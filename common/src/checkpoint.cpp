@@ -0,0 +1,132 @@
+#include "render/checkpoint.hpp"
+
+#include <bit>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+#include "render/hash.hpp"
+
+namespace render {
+
+  namespace {
+
+    template <class T>
+    std::uint64_t mix(std::uint64_t h, T const & v) {
+      auto const raw = std::bit_cast<std::array<std::byte, sizeof(T)>>(v);
+      return fnv1a64(raw, h);
+    }
+
+    std::uint64_t mix(std::uint64_t h, vector const & v) {
+      return mix(mix(mix(h, v.x), v.y), v.z);
+    }
+
+    std::uint64_t payload_size(auto const & parts) {
+      std::uint64_t n = 0;
+      for (auto const & p : parts) {
+        n += p.size();
+      }
+      return n;
+    }
+
+    void set_err(std::string * err, std::string msg) {
+      if (err) {
+        *err = std::move(msg);
+      }
+    }
+
+  }  // namespace
+
+  std::uint64_t checkpoint_fingerprint(RenderSettings const & s, std::uint64_t scene_hash) {
+    std::uint64_t h = mix(fnv1a_basis, scene_hash);
+    h               = mix(h, s.width);
+    h               = mix(h, s.height);
+    h               = mix(h, s.vfov_deg);
+    h               = mix(h, s.lookfrom);
+    h               = mix(h, s.lookat);
+    h               = mix(h, s.vup);
+    h               = mix(h, s.aperture);
+    h               = mix(h, s.focus_dist);
+    h               = mix(h, s.spp);
+    h               = mix(h, s.seed);
+    h               = mix(h, s.sampler);
+    h               = mix(h, s.max_depth);
+    return mix(h, s.rr_depth);
+  }
+
+  bool write_checkpoint(std::string const & path, CheckpointKey const & key,
+                        std::span<std::span<std::byte const> const> parts, std::string * err) {
+    CheckpointHeader hdr;
+    hdr.layout        = key.layout;
+    hdr.width         = static_cast<std::uint32_t>(key.width);
+    hdr.height        = static_cast<std::uint32_t>(key.height);
+    hdr.fingerprint   = key.fingerprint;
+    hdr.payload_bytes = payload_size(parts);
+
+    std::string const tmp = path + ".tmp";
+    {
+      std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+      out.write(reinterpret_cast<char const *>(&hdr), sizeof hdr);
+      for (auto const & p : parts) {
+        out.write(reinterpret_cast<char const *>(p.data()),
+                  static_cast<std::streamsize>(p.size()));
+      }
+      out.flush();
+      if (!out) {
+        set_err(err, "Error: cannot write checkpoint '" + tmp + "'");
+        return false;
+      }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+      set_err(err, "Error: cannot write checkpoint '" + path + "': " + ec.message());
+      return false;
+    }
+    return true;
+  }
+
+  bool read_checkpoint(std::string const & path, CheckpointKey const & key,
+                       std::span<std::span<std::byte> const> parts, std::string * err) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+      set_err(err, "Error: cannot open checkpoint '" + path + "'");
+      return false;
+    }
+    auto const file_size = static_cast<std::uint64_t>(in.tellg());
+    in.seekg(0);
+
+    CheckpointHeader hdr;
+    CheckpointHeader const expected;
+    if (!in.read(reinterpret_cast<char *>(&hdr), sizeof hdr) or hdr.magic != expected.magic) {
+      set_err(err, "Error: '" + path + "' is not a checkpoint");
+      return false;
+    }
+    if (hdr.version != expected.version) {
+      set_err(err, "Error: unsupported checkpoint version " + std::to_string(hdr.version) +
+                       " in '" + path + "'");
+      return false;
+    }
+    std::uint64_t const payload = payload_size(parts);
+    if (hdr.layout != key.layout or hdr.width != static_cast<std::uint32_t>(key.width) or
+        hdr.height != static_cast<std::uint32_t>(key.height) or
+        hdr.fingerprint != key.fingerprint or hdr.payload_bytes != payload)
+    {
+      set_err(err, "Error: checkpoint '" + path + "' does not match the current settings/scene");
+      return false;
+    }
+    if (file_size != sizeof hdr + payload) {
+      set_err(err, "Error: checkpoint '" + path + "' is truncated");
+      return false;
+    }
+    for (auto const & p : parts) {
+      if (!in.read(reinterpret_cast<char *>(p.data()), static_cast<std::streamsize>(p.size()))) {
+        set_err(err, "Error: cannot read checkpoint '" + path + "'");
+        return false;
+      }
+    }
+    return true;
+  }
+
+}  // namespace render
@@ -0,0 +1,165 @@
+#include "render/compiled_scene.hpp"
+
+#include <cstdint>
+#include <new>
+
+namespace render {
+
+  namespace {
+
+    constexpr std::size_t align_up(std::size_t n, std::size_t a) {
+      return (n + a - 1) / a * a;
+    }
+
+    // Reparte un bloque de memoria en arrays consecutivos alineados a 64 bytes.
+    // Con base == nullptr solo mide (primera pasada para saber cuánto reservar). Las vistas
+    // son mutables (las rellena compile); CompiledScene solo guarda las de solo lectura.
+    class ArenaCarver {
+    public:
+      explicit ArenaCarver(std::byte * base) : m_base(base) { }
+
+      template <class T>
+      std::span<T> take(std::size_t n) {
+        std::size_t const off = m_offset;
+        m_offset              = align_up(off + n * sizeof(T), CompiledScene::alignment);
+        if (m_base == nullptr or n == 0) {
+          return {};
+        }
+        return {reinterpret_cast<T *>(m_base + off), n};
+      }
+
+      [[nodiscard]] std::size_t size() const { return m_offset; }
+
+    private:
+      std::byte * m_base;
+      std::size_t m_offset{0};
+    };
+
+    // Mismo reparto para las vistas de solo lectura de la escena y las mutables de compile
+    template <bool W>
+    void carve(ArenaCarver & a, BasicSphereArrays<W> & s, BasicCylinderArrays<W> & c,
+               ArenaSpan<MaterialPre, W> & m, std::size_t ns, std::size_t nc, std::size_t nm) {
+      s.cx     = a.take<double>(ns);
+      s.cy     = a.take<double>(ns);
+      s.cz     = a.take<double>(ns);
+      s.radius = a.take<double>(ns);
+      s.r2     = a.take<double>(ns);
+      s.inv_r  = a.take<double>(ns);
+      s.mat    = a.take<std::uint32_t>(ns);
+
+      c.p0x    = a.take<double>(nc);
+      c.p0y    = a.take<double>(nc);
+      c.p0z    = a.take<double>(nc);
+      c.p1x    = a.take<double>(nc);
+      c.p1y    = a.take<double>(nc);
+      c.p1z    = a.take<double>(nc);
+      c.axx    = a.take<double>(nc);
+      c.axy    = a.take<double>(nc);
+      c.axz    = a.take<double>(nc);
+      c.height = a.take<double>(nc);
+      c.radius = a.take<double>(nc);
+      c.r2     = a.take<double>(nc);
+      c.mat    = a.take<std::uint32_t>(nc);
+
+      m = a.take<MaterialPre>(nm);
+    }
+
+  }  // namespace
+
+  std::size_t CompiledScene::bytes_for(std::size_t spheres, std::size_t cylinders,
+                                       std::size_t materials) {
+    CompiledScene tmp;
+    ArenaCarver measure{nullptr};
+    carve(measure, tmp.m_spheres, tmp.m_cylinders, tmp.m_materials, spheres, cylinders,
+          materials);
+    return measure.size();
+  }
+
+  std::optional<CompiledScene> CompiledScene::adopt(std::shared_ptr<std::byte const> block,
+                                                    std::size_t bytes, std::size_t spheres,
+                                                    std::size_t cylinders,
+                                                    std::size_t materials) {
+    auto const addr = reinterpret_cast<std::uintptr_t>(block.get());
+    if (bytes != bytes_for(spheres, cylinders, materials) or addr % alignment != 0) {
+      return std::nullopt;
+    }
+    // Una escena compilada ya no se escribe nunca: el bloque puede ser de solo lectura (una
+    // proyección de la caché). El carver solo reparte direcciones.
+    CompiledScene out;
+    out.m_storage = std::move(block);
+    out.m_bytes   = bytes;
+    if (bytes == 0) {
+      return out;
+    }
+    ArenaCarver carver{const_cast<std::byte *>(out.m_storage.get())};
+    carve(carver, out.m_spheres, out.m_cylinders, out.m_materials, spheres, cylinders,
+          materials);
+    return out;
+  }
+
+  CompiledScene CompiledScene::compile(Scene const & scn) {
+    std::size_t const ns = scn.spheres.size();
+    std::size_t const nc = scn.cylinders.size();
+    std::size_t const nm = scn.materials.size();
+
+    CompiledScene out;
+    ArenaCarver measure{nullptr};
+    carve(measure, out.m_spheres, out.m_cylinders, out.m_materials, ns, nc, nm);
+    out.m_bytes = measure.size();
+    if (out.m_bytes == 0) {
+      return out;
+    }
+
+    auto * raw =
+        static_cast<std::byte *>(::operator new(out.m_bytes, std::align_val_t{alignment}));
+    out.m_storage = std::shared_ptr<std::byte const>(raw, [](std::byte const * p) {
+      ::operator delete(const_cast<std::byte *>(p), std::align_val_t{alignment});
+    });
+    ArenaCarver view{raw};
+    carve(view, out.m_spheres, out.m_cylinders, out.m_materials, ns, nc, nm);
+
+    // Las vistas mutables solo existen aquí, mientras se rellena el bloque
+    BasicSphereArrays<true> s;
+    BasicCylinderArrays<true> c;
+    std::span<MaterialPre> materials;
+    ArenaCarver fill{raw};
+    carve(fill, s, c, materials, ns, nc, nm);
+
+    // Las primitivas ya traen el índice del material (el mismo en scn.materials y materials())
+    for (std::size_t i = 0; i < nm; ++i) {
+      Material const & src = scn.materials[i];
+      materials[i]         = MaterialPre{src.kind, src.color, src.fuzz, src.ior};
+    }
+
+    for (std::size_t i = 0; i < ns; ++i) {
+      Sphere const & src = scn.spheres[i];
+      s.cx[i]            = src.center.x;
+      s.cy[i]            = src.center.y;
+      s.cz[i]            = src.center.z;
+      s.radius[i]        = src.radius;
+      s.r2[i]            = src.radius * src.radius;
+      s.inv_r[i]         = 1.0 / src.radius;
+      s.mat[i]           = src.mat;
+    }
+
+    for (std::size_t i = 0; i < nc; ++i) {
+      Cylinder const & src = scn.cylinders[i];
+      CylinderPre const p  = precompute_cylinder(src.base, src.axis, src.height, src.radius);
+      c.p0x[i]             = p.p0.x;
+      c.p0y[i]             = p.p0.y;
+      c.p0z[i]             = p.p0.z;
+      c.p1x[i]             = p.p1.x;
+      c.p1y[i]             = p.p1.y;
+      c.p1z[i]             = p.p1.z;
+      c.axx[i]             = p.ax.x;
+      c.axy[i]             = p.ax.y;
+      c.axz[i]             = p.ax.z;
+      c.height[i]          = p.height;
+      c.radius[i]          = src.radius;
+      c.r2[i]              = p.r2;
+      c.mat[i]             = src.mat;
+    }
+    return out;
+  }
+
+}  // namespace render
@@ -0,0 +1,59 @@
+#include "render/gamma.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace render {
+
+  std::uint8_t gamma_encode_exact(double v, double gamma) {
+    if (gamma <= 0.0) {
+      gamma = 2.2;
+    }
+    if (!(v > 0.0)) {
+      return 0;
+    }
+    double const g = std::pow(std::min(v, 1.0), 1.0 / gamma);
+    return static_cast<std::uint8_t>(std::clamp(std::lround(g * 255.0), 0L, 255L));
+  }
+
+  GammaLut::GammaLut(double gamma) : m_gamma(gamma <= 0.0 ? 2.2 : gamma) {
+    // Los floats positivos se ordenan igual que sus bits: bisección sobre el entero
+    auto const level = [&](std::uint32_t bits) {
+      return gamma_encode_exact(static_cast<double>(std::bit_cast<float>(bits)), m_gamma);
+    };
+    std::uint32_t const one_bits = std::bit_cast<std::uint32_t>(1.0F);
+    for (std::size_t k = 1; k < 256; ++k) {
+      std::uint32_t lo = 0, hi = one_bits;  // level(hi) >= k siempre (level(1) = 255)
+      while (lo < hi) {
+        std::uint32_t const mid = lo + (hi - lo) / 2;
+        if (level(mid) >= k) {
+          hi = mid;
+        } else {
+          lo = mid + 1;
+        }
+      }
+      m_threshold[k] = std::bit_cast<float>(lo);
+    }
+    m_threshold[256] = std::numeric_limits<float>::infinity();
+
+    // Nivel en el extremo inferior de cada bucket (mismo cálculo del índice que operator())
+    std::size_t k = 0;
+    for (std::size_t b = 0; b < buckets; ++b) {
+      float const lo_edge = static_cast<float>(b) / static_cast<float>(buckets);
+      while (lo_edge >= m_threshold[k + 1]) {
+        ++k;
+      }
+      m_start[b] = static_cast<std::uint8_t>(k);
+    }
+  }
+
+  void GammaLut::resolve(std::span<float const> in, std::span<std::uint8_t> out) const {
+    std::size_t const n = std::min(in.size(), out.size());
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = (*this)(in[i]);
+    }
+  }
+
+}  // namespace render
@@ -0,0 +1,24 @@
+#include "render/hash.hpp"
+
+#include <array>
+#include <fstream>
+
+namespace render {
+
+  std::optional<std::uint64_t> hash_file(std::string const & path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+      return std::nullopt;
+    }
+    std::array<char, 1 << 16> buf{};
+    std::uint64_t h = fnv1a_basis;
+    while (in.read(buf.data(), static_cast<std::streamsize>(buf.size())) or in.gcount() > 0) {
+      h = fnv1a64(std::string_view{buf.data(), static_cast<std::size_t>(in.gcount())}, h);
+    }
+    if (in.bad()) {
+      return std::nullopt;
+    }
+    return h;
+  }
+
+}  // namespace render
@@ -1,16 +1,33 @@
 #include "render/hits.hpp"
+#include <array>
 #include <cmath>
 
 namespace render {
 
+  namespace {
+
+    // Normaliza sin tocar vectores nulos (misma fórmula que usaba hit_cylinder)
+    inline vector normalize_or_keep(vector const & v) {
+      double const L = std::sqrt(v.dot(v));
+      return (L > 0.0) ? (1.0 / L) * v : v;
+    }
+
+  }  // namespace
+
   bool hit_sphere(ray const & r, vector const & center, double radius, double t_min, double t_max,
                   double * t_out, vector * normal_out) {
+    return hit_sphere_pre(r, center, radius * radius, 1.0 / radius, t_min, t_max, t_out,
+                          normal_out);
+  }
+
+  bool hit_sphere_pre(ray const & r, vector const & center, double r2, double inv_r, double t_min,
+                      double t_max, double * t_out, vector * normal_out) {
     // Ecuación: ||(o + t d) - c||^2 = r^2
     // Sea oc = o - c. a = d·d, b = 2 oc·d, c2 = oc·oc - r^2
     vector const oc     = r.origin - center;
     double const a      = r.direction.dot(r.direction);
     double const half_b = oc.dot(r.direction);  // usamos forma con half_b para estabilidad
-    double const c2     = oc.dot(oc) - radius * radius;
+    double const c2     = oc.dot(oc) - r2;
 
     double const discriminant = half_b * half_b - a * c2;
     if (discriminant < 0.0) {
@@ -33,7 +50,7 @@ namespace render {
     }
     if (normal_out != nullptr) {
       vector const p = r.at(t);
-      vector n       = (p - center) * (1.0 / radius);  // normalizada
+      vector n       = (p - center) * inv_r;  // normalizada
       *normal_out    = n;
     }
     return true;
@@ -42,19 +59,28 @@ namespace render {
   bool hit_cylinder(ray const & r, vector const & base, vector const & axis, double height,
                     double radius, double t_min, double t_max, double * t_out,
                     vector * normal_out) {
-    // helpers locales
-    auto length    = [](vector const & v) -> double { return std::sqrt(v.dot(v)); };
-    auto normalize = [&](vector v) -> vector {
-      double L = length(v);
-      return (L > 0.0) ? (1.0 / L) * v : v;
-    };
+    return hit_cylinder_pre(r, precompute_cylinder(base, axis, height, radius), t_min, t_max,
+                            t_out, normal_out);
+  }
+
+  CylinderPre precompute_cylinder(vector const & base, vector const & axis, double height,
+                                  double radius) {
+    CylinderPre c;
+    c.ax     = normalize_or_keep(axis);  // por si nos llega sin normalizar
+    c.p0     = base;                     // punto de la tapa inferior
+    c.p1     = base + height * c.ax;     // punto de la tapa superior
+    c.height = height;
+    c.r2     = radius * radius;
+    return c;
+  }
 
-    // Normaliza el eje (por si nos llega sin normalizar)
-    vector ax = normalize(axis);
-    vector O  = r.origin;
-    vector D  = r.direction;         // se asume ya normalizada en tu cámara
-    vector P0 = base;                // punto de la tapa inferior
-    vector P1 = base + height * ax;  // punto de la tapa superior
+  bool hit_cylinder_pre(ray const & r, CylinderPre const & c, double t_min, double t_max,
+                        double * t_out, vector * normal_out) {
+    vector const & ax = c.ax;
+    vector const & P0 = c.p0;
+    vector const & P1 = c.p1;
+    vector const O    = r.origin;
+    vector const D    = r.direction;  // se asume ya normalizada en tu cámara
 
     bool hit_any     = false;
     double best_t    = t_max;
@@ -62,85 +88,65 @@ namespace render {
 
     // --- 1) Intersección con el lateral ---------------------------------------
     // Proyecta origen y dirección al plano perpendicular a ax
-    double D_par = D.dot(ax);
-    double O_par = (O - P0).dot(ax);
+    double const D_par = D.dot(ax);
+    double const O_par = (O - P0).dot(ax);
 
-    vector D_perp = D - D_par * ax;  // componente perpendicular del rayo
-    vector O_perp = (O - P0) - O_par * ax;
+    vector const D_perp = D - D_par * ax;  // componente perpendicular del rayo
+    vector const O_perp = (O - P0) - O_par * ax;
 
-    double a = D_perp.dot(D_perp);
-    double b = 2.0 * O_perp.dot(D_perp);
-    double c = O_perp.dot(O_perp) - radius * radius;
+    double const a = D_perp.dot(D_perp);
+    double const b = 2.0 * O_perp.dot(D_perp);
+    double const k = O_perp.dot(O_perp) - c.r2;
 
     if (a > 1e-16) {
-      double disc = b * b - 4.0 * a * c;
+      double const disc = b * b - 4.0 * a * k;
       if (disc >= 0.0) {
-        double sdisc = std::sqrt(disc);
-        // Dos candidatos
-        double t0 = (-b - sdisc) / (2.0 * a);
-        double t1 = (-b + sdisc) / (2.0 * a);
-
-        auto try_t_lateral = [&](double t) {
-          if (t < t_min || t > best_t) {
-            return;
+        double const sdisc = std::sqrt(disc);
+        // Dos candidatos (t0 <= t1); nos quedamos con el primero que cae entre tapas
+        std::array<double, 2> const roots = {(-b - sdisc) / (2.0 * a),
+                                             (-b + sdisc) / (2.0 * a)};
+        for (double const t : roots) {
+          if (t <= t_min or t > best_t) {
+            continue;
           }
           // Comprueba que el punto cae entre tapas: 0 <= y <= height
-          double y = O_par + t * D_par;  // coordenada a lo largo de ax relativa a P0
-          if (y < 0.0 || y > height) {
-            return;
+          double const y = O_par + t * D_par;  // coordenada a lo largo de ax relativa a P0
+          if (y < 0.0 or y > c.height) {
+            continue;
           }
-
-          // Punto de impacto y normal lateral (componente perpendicular normalizada)
-          vector P  = O + t * D;
-          vector Pc = P - (P0 + y * ax);  // vector radial en el plano perpendicular
-          vector N  = normalize(Pc);      // salida hacia fuera
-
-          best_t    = t;
-          best_norm = N;
-          hit_any   = true;
-        };
-
-        // pruebo ambos
-        if (t0 > t_min) {
-          try_t_lateral(t0);
-        }
-        if (t1 > t_min) {
-          try_t_lateral(t1);
+          // Normal lateral: componente radial normalizada, hacia fuera
+          vector const P  = O + t * D;
+          vector const Pc = P - (P0 + y * ax);
+          best_t          = t;
+          best_norm       = normalize_or_keep(Pc);
+          hit_any         = true;
         }
       }
     }
 
-    // --- 2) Intersección con TAPA inferior (plano por P0, normal -ax hacia fuera) ---
-    {
-      double denom = ax.dot(D);       // D·ax
-      if (std::abs(denom) > 1e-16) {  // no paralelo
-        double t = (P0 - O).dot(ax) / denom;
-        if (t >= t_min && t < best_t) {
-          vector P = O + t * D;
-          // distancia radial al centro de la tapa inferior
-          vector radial = P - P0 - ((P - P0).dot(ax)) * ax;  // componente perpendicular
-          if (radial.dot(radial) <= radius * radius + 1e-12) {
-            best_t    = t;
-            best_norm = -1.0 * ax;  // normal hacia fuera en la tapa inferior
-            hit_any   = true;
-          }
+    double const denom = ax.dot(D);  // D·ax
+    if (std::abs(denom) > 1e-16) {   // no paralelo a las tapas
+      // --- 2) TAPA inferior (plano por P0, normal -ax hacia fuera) ---
+      double t = (P0 - O).dot(ax) / denom;
+      if (t >= t_min and t < best_t) {
+        vector const P      = O + t * D;
+        vector const radial = P - P0 - ((P - P0).dot(ax)) * ax;  // componente perpendicular
+        if (radial.dot(radial) <= c.r2 + 1e-12) {
+          best_t    = t;
+          best_norm = -1.0 * ax;
+          hit_any   = true;
         }
       }
-    }
 
-    // --- 3) Intersección con TAPA superior (plano por P1, normal +ax hacia fuera) ---
-    {
-      double denom = ax.dot(D);
-      if (std::abs(denom) > 1e-16) {
-        double t = (P1 - O).dot(ax) / denom;
-        if (t >= t_min && t < best_t) {
-          vector P      = O + t * D;
-          vector radial = P - P1 - ((P - P1).dot(ax)) * ax;
-          if (radial.dot(radial) <= radius * radius + 1e-12) {
-            best_t    = t;
-            best_norm = ax;  // normal hacia fuera en la tapa superior
-            hit_any   = true;
-          }
+      // --- 3) TAPA superior (plano por P1, normal +ax hacia fuera) ---
+      t = (P1 - O).dot(ax) / denom;
+      if (t >= t_min and t < best_t) {
+        vector const P      = O + t * D;
+        vector const radial = P - P1 - ((P - P1).dot(ax)) * ax;
+        if (radial.dot(radial) <= c.r2 + 1e-12) {
+          best_t    = t;
+          best_norm = ax;
+          hit_any   = true;
         }
       }
     }
@@ -148,10 +154,10 @@ namespace render {
     if (!hit_any) {
       return false;
     }
-    if (t_out) {
+    if (t_out != nullptr) {
       *t_out = best_t;
     }
-    if (normal_out) {
+    if (normal_out != nullptr) {
       *normal_out = best_norm;
     }
     return true;
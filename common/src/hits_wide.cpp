@@ -0,0 +1,329 @@
+#include "render/hits_wide.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace render {
+
+  namespace {
+
+    using simd::dmask;
+    using simd::dvec;
+
+    // Origen de los datos: tramo contiguo de los arrays SoA
+    struct RangeSource {
+      std::size_t first;
+
+      [[nodiscard]] std::uint32_t index(std::size_t k) const {
+        return static_cast<std::uint32_t>(first + k);
+      }
+
+      [[nodiscard]] dvec load(std::span<double const> a, std::size_t k) const {
+        return simd::load(a.data() + first + k);
+      }
+    };
+
+    // Origen de los datos: lista de índices (gather)
+    struct IdsSource {
+      std::span<std::uint32_t const> ids;
+
+      [[nodiscard]] std::uint32_t index(std::size_t k) const { return ids[k]; }
+
+      [[nodiscard]] dvec load(std::span<double const> a, std::size_t k) const {
+        return simd::gather([&](std::size_t l) { return a[ids[k + l]]; });
+      }
+    };
+
+    // Bloque [k, k + lanes) de un array; en el último bloque incompleto se repite el último
+    // elemento (el kernel enmascara esos carriles con pos < n)
+    template <class Source>
+    inline dvec load_block(Source const & src, std::span<double const> arr, std::size_t k,
+                           std::size_t n) {
+      if (k + simd::lanes <= n) {
+        return src.load(arr, k);
+      }
+      return simd::gather([&](std::size_t l) { return arr[src.index(std::min(k + l, n - 1))]; });
+    }
+
+    inline dvec lane_offsets() {
+      return simd::gather([](std::size_t l) { return static_cast<double>(l); });
+    }
+
+    // Mismas operaciones y en el mismo orden que hit_sphere_pre, carril a carril.
+    // Cada carril guarda su mejor (t, posición); al final se reduce entre carriles.
+    template <class Source>
+    bool spheres_kernel(SphereArrays const & s, std::size_t n, Source const & src,
+                        ray const & r, double t_min, double t_max, double * t_out,
+                        vector * normal_out, std::uint32_t * index_out) {
+      if (n == 0) {
+        return false;
+      }
+      constexpr double inf_s = std::numeric_limits<double>::infinity();
+
+      vector const & o = r.origin;
+      vector const & d = r.direction;
+      dvec const ox    = simd::broadcast(o.x);
+      dvec const oy    = simd::broadcast(o.y);
+      dvec const oz    = simd::broadcast(o.z);
+      dvec const dx    = simd::broadcast(d.x);
+      dvec const dy    = simd::broadcast(d.y);
+      dvec const dz    = simd::broadcast(d.z);
+      dvec const a     = simd::broadcast(d.dot(d));
+      dvec const tmin  = simd::broadcast(t_min);
+      dvec const tmax  = simd::broadcast(t_max);
+      dvec const zero  = simd::broadcast(0.0);
+      dvec const inf   = simd::broadcast(inf_s);
+      dvec const count = simd::broadcast(static_cast<double>(n));
+      dvec const lane  = lane_offsets();
+
+      dvec best_t   = inf;
+      dvec best_pos = simd::broadcast(-1.0);
+
+      for (std::size_t k = 0; k < n; k += sphere_lanes) {
+        auto ld = [&](std::span<double const> arr) { return load_block(src, arr, k, n); };
+
+        dvec const pos    = simd::broadcast(static_cast<double>(k)) + lane;
+        dvec const ocx    = ox - ld(s.cx);
+        dvec const ocy    = oy - ld(s.cy);
+        dvec const ocz    = oz - ld(s.cz);
+        dvec const half_b = ocx * dx + ocy * dy + ocz * dz;
+        dvec const c2     = (ocx * ocx + ocy * ocy + ocz * ocz) - ld(s.r2);
+        dvec const disc   = half_b * half_b - a * c2;
+        dvec const sq     = simd::sqrt(disc);  // NaN si disc < 0: ese carril no cuenta
+        dvec const t0     = (-half_b - sq) / a;
+        dvec const t1     = (-half_b + sq) / a;
+
+        dmask const ok     = (disc >= zero) & (pos < count);
+        dmask const m0     = ok & (t0 >= tmin) & (t0 <= tmax);
+        dmask const m1     = ok & (t1 >= tmin) & (t1 <= tmax);
+        dvec const cand    = simd::select(m0, t0, simd::select(m1, t1, inf));
+        dmask const better = (m0 | m1) & (cand <= best_t);
+        best_t             = simd::select(better, cand, best_t);
+        best_pos           = simd::select(better, pos, best_pos);
+      }
+
+      auto const ts  = simd::to_array(best_t);
+      auto const ps  = simd::to_array(best_pos);
+      double win_t   = inf_s;
+      double win_pos = -1.0;
+      for (std::size_t l = 0; l < sphere_lanes; ++l) {
+        if (ps[l] >= 0.0 and (ts[l] < win_t or (ts[l] == win_t and ps[l] > win_pos))) {
+          win_t   = ts[l];
+          win_pos = ps[l];
+        }
+      }
+      if (win_pos < 0.0) {
+        return false;
+      }
+
+      std::uint32_t const i = src.index(static_cast<std::size_t>(win_pos));
+      if (t_out != nullptr) {
+        *t_out = win_t;
+      }
+      if (normal_out != nullptr) {
+        *normal_out = (r.at(win_t) - s.center(i)) * s.inv_r[i];
+      }
+      if (index_out != nullptr) {
+        *index_out = i;
+      }
+      return true;
+    }
+
+
+    // Normaliza sin tocar vectores nulos (igual que en hits.cpp)
+    inline vector normalize_or_keep(vector const & v) {
+      double const L = std::sqrt(v.dot(v));
+      return (L > 0.0) ? (1.0 / L) * v : v;
+    }
+
+    // Qué parte del cilindro dio el mejor impacto de un carril
+    constexpr double part_lateral = 0.0;
+    constexpr double part_bottom  = 1.0;
+    constexpr double part_top     = 2.0;
+
+    // hit_cylinder_pre sin ramas: lateral y ambas tapas se evalúan siempre y se combinan con
+    // máscaras. Cada carril arrastra su mejor t como t_max del siguiente cilindro (igual que
+    // el bucle escalar) y respeta sus desempates: el lateral acepta t == mejor, las tapas no.
+    template <class Source>
+    bool cylinders_kernel(CylinderArrays const & c, std::size_t n, Source const & src,
+                          ray const & r, double t_min, double t_max, double * t_out,
+                          vector * normal_out, std::uint32_t * index_out) {
+      if (n == 0) {
+        return false;
+      }
+      vector const & O = r.origin;
+      vector const & D = r.direction;
+      dvec const ox    = simd::broadcast(O.x);
+      dvec const oy    = simd::broadcast(O.y);
+      dvec const oz    = simd::broadcast(O.z);
+      dvec const dx    = simd::broadcast(D.x);
+      dvec const dy    = simd::broadcast(D.y);
+      dvec const dz    = simd::broadcast(D.z);
+      dvec const tmin  = simd::broadcast(t_min);
+      dvec const zero  = simd::broadcast(0.0);
+      dvec const two   = simd::broadcast(2.0);
+      dvec const four  = simd::broadcast(4.0);
+      dvec const eps16 = simd::broadcast(1e-16);
+      dvec const eps12 = simd::broadcast(1e-12);
+      dvec const count = simd::broadcast(static_cast<double>(n));
+      dvec const lane  = lane_offsets();
+
+      dvec best_t    = simd::broadcast(t_max);
+      dvec best_pos  = simd::broadcast(-1.0);
+      dvec best_part = simd::broadcast(part_lateral);
+
+      for (std::size_t k = 0; k < n; k += simd::lanes) {
+        auto ld = [&](std::span<double const> arr) { return load_block(src, arr, k, n); };
+
+        dvec const pos = simd::broadcast(static_cast<double>(k)) + lane;
+        dvec const axx = ld(c.axx);
+        dvec const axy = ld(c.axy);
+        dvec const axz = ld(c.axz);
+        dvec const p0x = ld(c.p0x);
+        dvec const p0y = ld(c.p0y);
+        dvec const p0z = ld(c.p0z);
+        dvec const h   = ld(c.height);
+        dvec const r2  = ld(c.r2);
+        dmask const in = pos < count;
+
+        // --- Lateral ---
+        dvec const wx    = ox - p0x;  // O - P0
+        dvec const wy    = oy - p0y;
+        dvec const wz    = oz - p0z;
+        dvec const d_par = dx * axx + dy * axy + dz * axz;
+        dvec const o_par = wx * axx + wy * axy + wz * axz;
+        dvec const dpx   = dx - axx * d_par;
+        dvec const dpy   = dy - axy * d_par;
+        dvec const dpz   = dz - axz * d_par;
+        dvec const opx   = wx - axx * o_par;
+        dvec const opy   = wy - axy * o_par;
+        dvec const opz   = wz - axz * o_par;
+        dvec const a     = dpx * dpx + dpy * dpy + dpz * dpz;
+        dvec const b     = two * (opx * dpx + opy * dpy + opz * dpz);
+        dvec const kk    = (opx * opx + opy * opy + opz * opz) - r2;
+        dvec const disc  = b * b - four * a * kk;
+        dvec const sq    = simd::sqrt(disc);
+        dvec const two_a = two * a;
+        dvec const t0    = (-b - sq) / two_a;
+        dvec const t1    = (-b + sq) / two_a;
+        dvec const y0    = o_par + t0 * d_par;
+        dvec const y1    = o_par + t1 * d_par;
+
+        dmask const lat_ok = in & (a > eps16) & (disc >= zero);
+        dmask const v0 = lat_ok & (t0 > tmin) & (t0 <= best_t) & (y0 >= zero) & (y0 <= h);
+        dmask const v1 = lat_ok & (t1 > tmin) & (t1 <= best_t) & (y1 >= zero) & (y1 <= h);
+        dmask const lat_hit = v0 | v1;
+        dvec cur_t          = simd::select(v0, t0, simd::select(v1, t1, best_t));
+        dvec cur_part       = simd::select(lat_hit, simd::broadcast(part_lateral), best_part);
+
+        // --- Tapas: plano por P, normal ±ax; denom = ax·D ---
+        dvec const denom    = axx * dx + axy * dy + axz * dz;
+        dmask const caps_ok = in & ((denom > eps16) | (denom < -eps16));
+        auto cap            = [&](dvec px, dvec py, dvec pz) {
+          dvec const t    = ((px - ox) * axx + (py - oy) * axy + (pz - oz) * axz) / denom;
+          dvec const qx   = (ox + dx * t) - px;  // P - Pcap
+          dvec const qy   = (oy + dy * t) - py;
+          dvec const qz   = (oz + dz * t) - pz;
+          dvec const proj = qx * axx + qy * axy + qz * axz;
+          dvec const rx   = qx - axx * proj;
+          dvec const ry   = qy - axy * proj;
+          dvec const rz   = qz - axz * proj;
+          dmask const ok  = caps_ok & (t >= tmin) & (t < cur_t) &
+                           ((rx * rx + ry * ry + rz * rz) <= r2 + eps12);
+          return std::pair{ok, t};
+        };
+        auto const [b_ok, tb] = cap(p0x, p0y, p0z);
+        cur_t                 = simd::select(b_ok, tb, cur_t);
+        cur_part              = simd::select(b_ok, simd::broadcast(part_bottom), cur_part);
+        auto const [t_ok, tt] = cap(ld(c.p1x), ld(c.p1y), ld(c.p1z));
+        cur_t                 = simd::select(t_ok, tt, cur_t);
+        cur_part              = simd::select(t_ok, simd::broadcast(part_top), cur_part);
+
+        dmask const hit = lat_hit | b_ok | t_ok;
+        best_t          = simd::select(hit, cur_t, best_t);
+        best_pos        = simd::select(hit, pos, best_pos);
+        best_part       = cur_part;
+      }
+
+      // Reducción entre carriles en orden de posición, con el mismo desempate que el bucle
+      // escalar: gana el menor t; ante empate solo un lateral posterior sustituye
+      auto const ts = simd::to_array(best_t);
+      auto const ps = simd::to_array(best_pos);
+      auto const ks = simd::to_array(best_part);
+      std::array<std::size_t, simd::lanes> order{};
+      for (std::size_t l = 0; l < simd::lanes; ++l) {
+        order[l] = l;
+      }
+      std::sort(order.begin(), order.end(), [&](std::size_t x, std::size_t y) {
+        return ps[x] < ps[y];
+      });
+      std::size_t win = simd::lanes;
+      for (std::size_t const l : order) {
+        if (ps[l] < 0.0) {
+          continue;
+        }
+        if (win == simd::lanes or ts[l] < ts[win] or
+            (ts[l] == ts[win] and ks[l] == part_lateral)) {
+          win = l;
+        }
+      }
+      if (win == simd::lanes) {
+        return false;
+      }
+
+      std::uint32_t const i = src.index(static_cast<std::size_t>(ps[win]));
+      double const t        = ts[win];
+      if (t_out != nullptr) {
+        *t_out = t;
+      }
+      if (normal_out != nullptr) {
+        CylinderPre const p = c.pre(i);
+        if (ks[win] == part_bottom) {
+          *normal_out = -1.0 * p.ax;
+        } else if (ks[win] == part_top) {
+          *normal_out = p.ax;
+        } else {
+          double const y = (O - p.p0).dot(p.ax) + t * D.dot(p.ax);
+          *normal_out    = normalize_or_keep((O + t * D) - (p.p0 + y * p.ax));
+        }
+      }
+      if (index_out != nullptr) {
+        *index_out = i;
+      }
+      return true;
+    }
+
+  }  // namespace
+
+  bool hit_spheres_wide(SphereArrays const & s, std::size_t first, std::size_t last,
+                        ray const & r, double t_min, double t_max, double * t_out,
+                        vector * normal_out, std::uint32_t * index_out) {
+    return spheres_kernel(s, last - first, RangeSource{first}, r, t_min, t_max, t_out,
+                          normal_out, index_out);
+  }
+
+  bool hit_spheres_wide(SphereArrays const & s, std::span<std::uint32_t const> ids,
+                        ray const & r, double t_min, double t_max, double * t_out,
+                        vector * normal_out, std::uint32_t * index_out) {
+    return spheres_kernel(s, ids.size(), IdsSource{ids}, r, t_min, t_max, t_out, normal_out,
+                          index_out);
+  }
+
+  bool hit_cylinders_wide(CylinderArrays const & c, std::size_t first, std::size_t last,
+                          ray const & r, double t_min, double t_max, double * t_out,
+                          vector * normal_out, std::uint32_t * index_out) {
+    return cylinders_kernel(c, last - first, RangeSource{first}, r, t_min, t_max, t_out,
+                            normal_out, index_out);
+  }
+
+  bool hit_cylinders_wide(CylinderArrays const & c, std::span<std::uint32_t const> ids,
+                          ray const & r, double t_min, double t_max, double * t_out,
+                          vector * normal_out, std::uint32_t * index_out) {
+    return cylinders_kernel(c, ids.size(), IdsSource{ids}, r, t_min, t_max, t_out, normal_out,
+                            index_out);
+  }
+
+}  // namespace render
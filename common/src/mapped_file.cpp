@@ -0,0 +1,73 @@
+#include "render/mapped_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <utility>
+
+namespace render {
+
+  std::optional<MappedFile> MappedFile::open(std::string const & path) {
+    int const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return std::nullopt;
+    }
+    MappedFile f;
+    struct stat st{};
+    if (::fstat(fd, &st) == 0 and S_ISREG(st.st_mode) and st.st_size > 0) {
+      auto const size = static_cast<std::size_t>(st.st_size);
+      void * p        = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p != MAP_FAILED) {
+        ::madvise(p, size, MADV_SEQUENTIAL);
+        f.m_data   = static_cast<char const *>(p);
+        f.m_size   = size;
+        f.m_mapped = true;
+        ::close(fd);
+        return f;
+      }
+    }
+    // Sin proyección: lectura completa (un fichero vacío o un directorio dan 0 bytes)
+    std::array<char, 1 << 16> buf{};
+    for (;;) {
+      ssize_t const n = ::read(fd, buf.data(), buf.size());
+      if (n <= 0) {
+        break;
+      }
+      f.m_fallback.append(buf.data(), static_cast<std::size_t>(n));
+    }
+    ::close(fd);
+    f.m_data = f.m_fallback.data();
+    f.m_size = f.m_fallback.size();
+    return f;
+  }
+
+  MappedFile::MappedFile(MappedFile && other) noexcept { *this = std::move(other); }
+
+  MappedFile & MappedFile::operator=(MappedFile && other) noexcept {
+    if (this != &other) {
+      release();
+      m_mapped   = std::exchange(other.m_mapped, false);
+      m_size     = std::exchange(other.m_size, 0U);
+      m_fallback = std::move(other.m_fallback);
+      m_data       = m_mapped ? std::exchange(other.m_data, nullptr) : m_fallback.data();
+      other.m_data = nullptr;
+    }
+    return *this;
+  }
+
+  MappedFile::~MappedFile() { release(); }
+
+  void MappedFile::release() noexcept {
+    if (m_mapped) {
+      ::munmap(const_cast<char *>(m_data), m_size);
+    }
+    m_data   = nullptr;
+    m_size   = 0;
+    m_mapped = false;
+    m_fallback.clear();
+  }
+
+}  // namespace render
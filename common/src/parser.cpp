@@ -5,6 +5,7 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "render/parser.hpp"
@@ -226,7 +227,12 @@ namespace render {
           return std::nullopt;
         }
 
-      } else if (key == "samples" || key == "samples_per_pixel" || key == "spp") {
+      } else if (key == "samples" ||
+                 key == "samples_per_pixel" ||
+                 key == "spp" ||
+                 key == "max_samples" ||
+                 key == "max_spp")
+      {
         if (!(iss >> cfg.samples_per_pixel)) {
           if (err) {
             *err = "Error: invalid format for 'samples' in " +
@@ -391,6 +397,168 @@ namespace render {
         }
         cfg.max_depth = v;
 
+        // russian roulette: rebotes seguros antes de empezar a cortar caminos
+      } else if (key == "rr_depth" ||
+                 key == "roulette_depth" ||
+                 key == "russian_roulette_depth")
+      {
+        int v{};
+        if (!(iss >> v)) {
+          if (err) {
+            *err = "Error: invalid format for 'rr_depth' in " +
+                   filename +
+                   ":" +
+                   std::to_string(line_number);
+          }
+          return std::nullopt;
+        }
+        if (v < 0) {
+          if (err) {
+            *err = "Error: invalid value for 'rr_depth' in " +
+                   filename +
+                   ":" +
+                   std::to_string(line_number);
+          }
+          return std::nullopt;
+        }
+        cfg.rr_depth = v;
+
+        // adaptive sampling
+      } else if (key == "adaptive_threshold" ||
+                 key == "adaptive_error" ||
+                 key == "noise_threshold")
+      {
+        double v{};
+        if (!(iss >> v)) {
+          if (err) {
+            *err = "Error: invalid format for 'adaptive_threshold' in " +
+                   filename +
+                   ":" +
+                   std::to_string(line_number);
+          }
+          return std::nullopt;
+        }
+        if (v < 0.0) {
+          if (err) {
+            *err = "Error: invalid value for 'adaptive_threshold' in " +
+                   filename +
+                   ":" +
+                   std::to_string(line_number);
+          }
+          return std::nullopt;
+        }
+        cfg.adaptive_threshold = v;
+
+      } else if (key == "sampler" || key == "sample_pattern") {
+        std::string name;
+        if (!(iss >> name)) {
+          if (err) {
+            *err = "Error: invalid format for 'sampler' in " +
+                   filename +
+                   ":" +
+                   std::to_string(line_number);
+          }
+          return std::nullopt;
+        }
+        auto const kind = parse_sampler(name);
+        if (!kind) {
+          if (err) {
+            *err = "Error: invalid value for 'sampler' in " +
+                   filename +
+                   ":" +
+                   std::to_string(line_number);
+          }
+          return std::nullopt;
+        }
+        cfg.sampler = *kind;
+
+      } else if (key == "min_samples" || key == "min_spp") {
+        if (!(iss >> cfg.min_samples)) {
+          if (err) {
+            *err = "Error: invalid format for 'min_samples' in " +
+                   filename +
+                   ":" +
+                   std::to_string(line_number);
+          }
+          return std::nullopt;
+        }
+        if (cfg.min_samples == 0U) {
+          if (err) {
+            *err = "Error: min_samples must be > 0 in " +
+                   filename +
+                   ":" +
+                   std::to_string(line_number);
+          }
+          return std::nullopt;
+        }
+
+        // progressive rendering
+      } else if (key == "time_budget" || key == "time_limit") {
+        double v{};
+        if (!(iss >> v)) {
+          if (err) {
+            *err = "Error: invalid format for 'time_budget' in " +
+                   filename +
+                   ":" +
+                   std::to_string(line_number);
+          }
+          return std::nullopt;
+        }
+        if (v < 0.0) {
+          if (err) {
+            *err = "Error: invalid value for 'time_budget' in " +
+                   filename +
+                   ":" +
+                   std::to_string(line_number);
+          }
+          return std::nullopt;
+        }
+        cfg.time_budget = v;
+
+      } else if (key == "preview_interval" || key == "preview_every") {
+        double v{};
+        if (!(iss >> v)) {
+          if (err) {
+            *err = "Error: invalid format for 'preview_interval' in " +
+                   filename +
+                   ":" +
+                   std::to_string(line_number);
+          }
+          return std::nullopt;
+        }
+        if (v < 0.0) {
+          if (err) {
+            *err = "Error: invalid value for 'preview_interval' in " +
+                   filename +
+                   ":" +
+                   std::to_string(line_number);
+          }
+          return std::nullopt;
+        }
+        cfg.preview_interval = v;
+
+      } else if (key == "checkpoint_interval" || key == "checkpoint_every") {
+        double v{};
+        if (!(iss >> v)) {
+          if (err) {
+            *err = "Error: invalid format for 'checkpoint_interval' in " +
+                   filename +
+                   ":" +
+                   std::to_string(line_number);
+          }
+          return std::nullopt;
+        }
+        if (v < 0.0) {
+          if (err) {
+            *err = "Error: invalid value for 'checkpoint_interval' in " +
+                   filename +
+                   ":" +
+                   std::to_string(line_number);
+          }
+          return std::nullopt;
+        }
+        cfg.checkpoint_interval = v;
+
       } else {
         if (err) {
           *err =
@@ -418,7 +586,8 @@ namespace render {
   }
 
   // ======================= TA3: SCENE PARSER =======================
-  std::optional<Scene> try_parse_scene(std::string const & filename, std::string * err) {
+  // Versión de referencia con streams; la del render es try_parse_scene (scene_parser.cpp)
+  std::optional<Scene> try_parse_scene_stream(std::string const & filename, std::string * err) {
     if (err) {
       err->clear();
     }
@@ -439,7 +608,8 @@ namespace render {
     };
 
     Scene scn;
-    std::unordered_set<std::string> mat_names, sph_names, cyl_names;
+    std::unordered_set<std::string> sph_names, cyl_names;
+    std::unordered_map<std::string, std::uint32_t> mat_names;  // nombre -> índice
     enum class Phase { Materials, Objects };
     Phase phase = Phase::Materials;
 
@@ -492,7 +662,7 @@ namespace render {
           return fail(line_no, "unknown material kind '" + kindStr + "'");
         }
 
-        if (!mat_names.insert(name).second) {
+        if (!mat_names.emplace(name, static_cast<std::uint32_t>(scn.materials.size())).second) {
           return fail(line_no, "duplicated material '" + name + "'");
         }
 
@@ -583,8 +753,9 @@ namespace render {
           iss.seekg(pos);
 
           Sphere s{};
+          std::string name, mat;
           if (is_kv) {
-            s.name   = first;
+            name     = first;
             bool okc = false, okr = false, okm = false;
             std::string kv;
             while (iss >> kv) {
@@ -601,8 +772,8 @@ namespace render {
                 }
                 okr = true;
               } else if (kv.rfind("mat=", 0) == 0) {
-                s.mat = kv.substr(4);
-                okm   = true;
+                mat = kv.substr(4);
+                okm = true;
               } else {
                 return fail(line_no,
                             "unknown key '" + kv.substr(0, kv.find('=')) + "' for 'sphere'");
@@ -611,13 +782,15 @@ namespace render {
             if (!(okc and okr and okm)) {
               return fail(line_no, "invalid sphere format");
             }
-            if (!sph_names.insert(s.name).second) {
-              return fail(line_no, "duplicated object '" + s.name + "'");
+            if (!sph_names.insert(name).second) {
+              return fail(line_no, "duplicated object '" + name + "'");
             }
-            if (!mat_names.count(s.mat)) {
-              return fail(line_no, "unknown material '" + s.mat + "'");
+            if (!mat_names.count(mat)) {
+              return fail(line_no, "unknown material '" + mat + "'");
             }
-            scn.spheres.push_back(std::move(s));
+            s.name = scn.names.add(name);
+            s.mat  = mat_names.at(mat);
+            scn.spheres.push_back(s);
 
           } else {
             // ¿legacy o con nombre?
@@ -636,14 +809,14 @@ namespace render {
                 return fail(line_no, "sphere radius must be > 0");
               }
               Sphere sl{};
-              sl.name   = "__legacy" + std::to_string(line_no);
+              sl.name   = legacy_name | static_cast<std::uint32_t>(line_no);
               sl.center = c;
               sl.radius = r;
-              scn.spheres.push_back(std::move(sl));
+              scn.spheres.push_back(sl);
             } else {
-              s.name = first;
-              if (!sph_names.insert(s.name).second) {
-                return fail(line_no, "duplicated object '" + s.name + "'");
+              name = first;
+              if (!sph_names.insert(name).second) {
+                return fail(line_no, "duplicated object '" + name + "'");
               }
               if (!(iss >> s.center.x >> s.center.y >> s.center.z >> s.radius)) {
                 return fail(line_no, "invalid sphere format");
@@ -651,13 +824,15 @@ namespace render {
               if (s.radius <= 0.0) {
                 return fail(line_no, "sphere radius must be > 0");
               }
-              if (!(iss >> s.mat)) {
+              if (!(iss >> mat)) {
                 return fail(line_no, "invalid sphere format");
               }
-              if (!mat_names.count(s.mat)) {
-                return fail(line_no, "unknown material '" + s.mat + "'");
+              if (!mat_names.count(mat)) {
+                return fail(line_no, "unknown material '" + mat + "'");
               }
-              scn.spheres.push_back(std::move(s));
+              s.name = scn.names.add(name);
+              s.mat  = mat_names.at(mat);
+              scn.spheres.push_back(s);
               std::string extra;
               if (iss >> extra) {
                 return fail(line_no, "trailing data after sphere");
@@ -669,14 +844,13 @@ namespace render {
 
         if (head == "cylinder") {
           Cylinder c{};
-          std::string name;
+          std::string name, mat;
           if (!(iss >> name)) {
             return fail(line_no, "invalid cylinder header");
           }
           if (!cyl_names.insert(name).second) {
             return fail(line_no, "duplicated object '" + name + "'");
           }
-          c.name = name;
 
           if (!(iss >>
                 c.base.x >>
@@ -695,17 +869,19 @@ namespace render {
             return fail(line_no, "invalid value for 'height'/'radius' (must be > 0)");
           }
 
-          if (!(iss >> c.mat)) {
+          if (!(iss >> mat)) {
             return fail(line_no, "invalid cylinder format");
           }
           if (!normalize_safe(c.axis)) {
             return fail(line_no, "invalid value for 'axis' (zero vector)");
           }
-          if (!mat_names.count(c.mat)) {
-            return fail(line_no, "unknown material '" + c.mat + "'");
+          if (!mat_names.count(mat)) {
+            return fail(line_no, "unknown material '" + mat + "'");
           }
 
-          scn.cylinders.push_back(std::move(c));
+          c.name = scn.names.add(name);
+          c.mat  = mat_names.at(mat);
+          scn.cylinders.push_back(c);
           std::string extra;
           if (iss >> extra) {
             return fail(line_no, "trailing data after cylinder");
@@ -1,10 +1,20 @@
 #include "render/ppm.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <functional>
+#include <span>
 #include <string>
+#include <utility>
+#include <vector>
+
+#include "render/tiles.hpp"
 
 namespace {
 
@@ -39,39 +49,179 @@ namespace {
     return vi;
   }
 
-}  // namespace
+  inline std::size_t pixel_count(int width, int height) {
+    return static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+  }
 
-namespace render {
+  inline void append_int(std::string & buf, int v) {
+    std::array<char, 16> tmp{};
+    auto const res = std::to_chars(tmp.data(), tmp.data() + tmp.size(), v);
+    buf.append(tmp.data(), res.ptr);
+  }
 
-  // ==================== VERSIÓN ORIGINAL (4 parámetros) ====================
-  // Firma EXACTA esperada por los tests (const & en el std::function).
-  // Mantiene el mapeo legacy (sqrt).
-  bool write_ppm_gamma(
-      std::string const & path, int width, int height,
-      std::function<void(int, int, double &, double &, double &)> const & sampler) {
-    if (width <= 0 and height <= 0) {
-      return false;
+  // Cabecera "P3\n<w> <h>\n255\n" (o P6), idéntica a la que escribía el ofstream
+  inline std::string ppm_header(render::PpmFormat format, int width, int height) {
+    std::string h = (format == render::PpmFormat::P6) ? "P6\n" : "P3\n";
+    append_int(h, width);
+    h += ' ';
+    append_int(h, height);
+    h += "\n255\n";
+    return h;
+  }
+
+  // Texto decimal de 0..255 con la longitud aparte: formatear un canal P3 es copiar 4 bytes
+  // (los dígitos y lo que sobre, que pisa el separador) en vez de dividir por 10
+  struct DecimalByte {
+    std::array<char, 4> digits{};
+    std::uint8_t len{};
+  };
+
+  constexpr std::array<DecimalByte, 256> decimal_bytes = [] {
+    std::array<DecimalByte, 256> t{};
+    for (std::size_t v = 0; v < t.size(); ++v) {
+      auto const hundreds = static_cast<char>('0' + v / 100);
+      auto const tens     = static_cast<char>('0' + v / 10 % 10);
+      auto const units    = static_cast<char>('0' + v % 10);
+      if (v >= 100) {
+        t[v] = {{hundreds, tens, units, ' '}, 3};
+      } else if (v >= 10) {
+        t[v] = {{tens, units, ' ', ' '}, 2};
+      } else {
+        t[v] = {{units, ' ', ' ', ' '}, 1};
+      }
     }
+    return t;
+  }();
+
+  // Bytes de "R G B\n"
+  inline std::size_t p3_size(std::uint8_t r, std::uint8_t g, std::uint8_t b) {
+    return std::size_t{3} + decimal_bytes[r].len + decimal_bytes[g].len + decimal_bytes[b].len;
+  }
+
+  // Un canal y su separador en p. Con 'exact' copia solo los dígitos; si no, copia 4 bytes y
+  // puede escribir hasta 2 de más tras el separador (que pisa lo siguiente que se formatee).
+  template <bool exact>
+  inline char * put_decimal(char * p, std::uint8_t v, char sep) {
+    DecimalByte const & d = decimal_bytes[v];
+    if constexpr (exact) {
+      std::memcpy(p, d.digits.data(), d.len);
+    } else {
+      std::memcpy(p, d.digits.data(), d.digits.size());
+    }
+    p[d.len] = sep;
+    return p + d.len + 1;
+  }
 
-    std::ofstream out(path, std::ios::out bitor std::ios::trunc);
+  template <bool exact>
+  inline char * put_p3(char * p, std::uint8_t r, std::uint8_t g, std::uint8_t b) {
+    p = put_decimal<false>(p, r, ' ');
+    p = put_decimal<false>(p, g, ' ');
+    return put_decimal<exact>(p, b, '\n');
+  }
+
+  // Vuelca el fichero ya compuesto: cabecera + un único write con todo el cuerpo
+  bool write_file(std::string const & path, std::string const & header, char const * body,
+                  std::size_t body_size) {
+    std::ofstream out(path, std::ios::out bitor std::ios::trunc bitor std::ios::binary);
     if (!out.is_open()) {
       return false;
     }
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    out.write(body, static_cast<std::streamsize>(body_size));
+    return static_cast<bool>(out);
+  }
 
-    out << "P3\n" << width << " " << height << "\n255\n";
+  // Cuerpo P3 a partir de un accesor i -> (r, g, b), por trozos de píxeles en paralelo. Primero
+  // se miden los trozos (con la tabla, sin formatear) y después cada uno se formatea
+  // directamente en su sitio del resultado: sin buffers intermedios ni concatenación.
+  // Solo el último píxel de cada trozo se escribe sin pasarse, para no pisar al siguiente.
+  constexpr std::size_t p3_chunk_pixels = std::size_t{1} << 15;
 
+  template <class Get>
+  std::string p3_body(std::size_t n, unsigned threads, Get && get) {
+    std::size_t const chunks = (n + p3_chunk_pixels - 1) / p3_chunk_pixels;
+    std::vector<std::size_t> offset(chunks + 1, 0);
+    auto chunk_range = [&](std::size_t c) {
+      return std::pair{c * p3_chunk_pixels, std::min(n, (c + 1) * p3_chunk_pixels)};
+    };
+    render::parallel_for(chunks, threads, [&](std::size_t c) {
+      auto const [i0, i1] = chunk_range(c);
+      std::size_t bytes   = 0;
+      for (std::size_t i = i0; i < i1; ++i) {
+        auto const [r, g, b]  = get(i);
+        bytes                += p3_size(r, g, b);
+      }
+      offset[c + 1] = bytes;
+    });
+    for (std::size_t c = 0; c < chunks; ++c) {
+      offset[c + 1] += offset[c];
+    }
+
+    // Sin rellenar antes con ceros. Se devuelve el tamaño pedido y no el que llega: la
+    // libstdc++ de GCC 12 pasa la capacidad
+    std::string body;
+    body.resize_and_overwrite(offset[chunks], [&](char * out, std::size_t) {
+      render::parallel_for(chunks, threads, [&](std::size_t c) {
+        auto const [i0, i1] = chunk_range(c);
+        char * p            = out + offset[c];
+        for (std::size_t i = i0; i + 1 < i1; ++i) {
+          auto const [r, g, b] = get(i);
+          p                    = put_p3<false>(p, r, g, b);
+        }
+        auto const [r, g, b] = get(i1 - 1);
+        put_p3<true>(p, r, g, b);
+      });
+      return offset[chunks];
+    });
+    return body;
+  }
+
+  // Evalúa el sampler y cuantiza a RGB intercalado
+  template <class ToByte>
+  std::vector<std::uint8_t>
+      sample_rgb(int width, int height,
+                 std::function<void(int, int, double &, double &, double &)> const & sampler,
+                 ToByte && to_byte) {
+    std::vector<std::uint8_t> rgb;
+    rgb.reserve(3 * pixel_count(std::max(width, 0), std::max(height, 0)));
     double r = 0.0, g = 0.0, b = 0.0;
     for (int y = 0; y < height; ++y) {
       for (int x = 0; x < width; ++x) {
         sampler(x, y, r, g, b);
-        int const R = to_byte_gamma2(r);
-        int const G = to_byte_gamma2(g);
-        int const B = to_byte_gamma2(b);
-        out << R << ' ' << G << ' ' << B << '\n';
+        rgb.push_back(static_cast<std::uint8_t>(to_byte(r)));
+        rgb.push_back(static_cast<std::uint8_t>(to_byte(g)));
+        rgb.push_back(static_cast<std::uint8_t>(to_byte(b)));
       }
     }
+    return rgb;
+  }
 
-    return static_cast<bool>(out);
+  // Salida de las sobrecargas con sampler. Con una dimensión negativa (y la otra no) las
+  // originales escribían solo la cabecera y devolvían true; write_ppm lo rechaza, así que ese
+  // caso se mantiene aquí.
+  bool write_sampled(std::string const & path, int width, int height,
+                     std::span<std::uint8_t const> rgb, render::PpmFormat format) {
+    if (width < 0 or height < 0) {
+      return write_file(path, ppm_header(format, width, height), nullptr, 0);
+    }
+    return render::write_ppm(path, width, height, rgb, format);
+  }
+
+}  // namespace
+
+namespace render {
+
+  // ==================== VERSIÓN ORIGINAL (4 parámetros) ====================
+  // Firma EXACTA esperada por los tests (const & en el std::function).
+  // Mantiene el mapeo legacy (sqrt).
+  bool write_ppm_gamma(
+      std::string const & path, int width, int height,
+      std::function<void(int, int, double &, double &, double &)> const & sampler) {
+    if (width <= 0 and height <= 0) {
+      return false;
+    }
+    auto const rgb = sample_rgb(width, height, sampler, to_byte_gamma2);
+    return write_sampled(path, width, height, rgb, PpmFormat::P3);
   }
 
   // ==================== SOBRECARGA NUEVA (5 parámetros) ====================
@@ -80,29 +230,129 @@ namespace render {
   bool write_ppm_gamma(
       std::string const & path, int width, int height, double gamma,
       std::function<void(int, int, double &, double &, double &)> const & sampler) {
+    return write_ppm_gamma(path, width, height, gamma, sampler, PpmFormat::P3);
+  }
+
+  bool write_ppm_gamma(
+      std::string const & path, int width, int height, double gamma,
+      std::function<void(int, int, double &, double &, double &)> const & sampler,
+      PpmFormat format) {
     if (width <= 0 and height <= 0) {
       return false;
     }
+    auto const rgb =
+        sample_rgb(width, height, sampler, [gamma](double v) { return to_byte_gamma_cfg(v, gamma); });
+    return write_sampled(path, width, height, rgb, format);
+  }
 
-    std::ofstream out(path, std::ios::out bitor std::ios::trunc);
-    if (!out.is_open()) {
+  // ==================== ESCRITURA EN BLOQUE ====================
+  std::string encode_p3(std::span<std::uint8_t const> rgb, unsigned threads) {
+    return p3_body(rgb.size() / 3, threads, [&](std::size_t i) {
+      return std::array{rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2]};
+    });
+  }
+
+  std::string encode_p3(std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                        std::span<std::uint8_t const> b, unsigned threads) {
+    std::size_t const n = std::min({r.size(), g.size(), b.size()});
+    return p3_body(n, threads, [&](std::size_t i) { return std::array{r[i], g[i], b[i]}; });
+  }
+
+  bool write_ppm(std::string const & path, int width, int height,
+                 std::span<std::uint8_t const> rgb, PpmFormat format) {
+    if (width < 0 or height < 0 or rgb.size() != 3 * pixel_count(width, height)) {
       return false;
     }
+    std::string const header = ppm_header(format, width, height);
+    if (format == PpmFormat::P6) {
+      return write_file(path, header, reinterpret_cast<char const *>(rgb.data()), rgb.size());
+    }
+    std::string const body = encode_p3(rgb);
+    return write_file(path, header, body.data(), body.size());
+  }
 
-    out << "P3\n" << width << " " << height << "\n255\n";
-
-    double r = 0.0, g = 0.0, b = 0.0;
-    for (int y = 0; y < height; ++y) {
-      for (int x = 0; x < width; ++x) {
-        sampler(x, y, r, g, b);
-        int const R = to_byte_gamma_cfg(r, gamma);
-        int const G = to_byte_gamma_cfg(g, gamma);
-        int const B = to_byte_gamma_cfg(b, gamma);
-        out << R << ' ' << G << ' ' << B << '\n';
+  bool write_ppm(std::string const & path, int width, int height, std::span<std::uint8_t const> r,
+                 std::span<std::uint8_t const> g, std::span<std::uint8_t const> b,
+                 PpmFormat format) {
+    std::size_t const n = (width < 0 or height < 0) ? 0 : pixel_count(width, height);
+    if (width < 0 or height < 0 or r.size() != n or g.size() != n or b.size() != n) {
+      return false;
+    }
+    std::string const header = ppm_header(format, width, height);
+    if (format == PpmFormat::P6) {
+      std::vector<char> body(3 * n);
+      for (std::size_t i = 0; i < n; ++i) {
+        body[3 * i]     = static_cast<char>(r[i]);
+        body[3 * i + 1] = static_cast<char>(g[i]);
+        body[3 * i + 2] = static_cast<char>(b[i]);
       }
+      return write_file(path, header, body.data(), body.size());
     }
+    std::string const body = encode_p3(r, g, b);
+    return write_file(path, header, body.data(), body.size());
+  }
 
-    return static_cast<bool>(out);
+  // ==================== ESCRITURA INCREMENTAL ====================
+  PpmStreamWriter::PpmStreamWriter(std::string const & path, int width, int height,
+                                   PpmFormat format)
+      : m_width(width), m_height(height), m_format(format) {
+    if (width < 0 or height < 0) {
+      return;
+    }
+    m_out.open(path, std::ios::out bitor std::ios::trunc bitor std::ios::binary);
+    std::string const header = ppm_header(format, width, height);
+    m_out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    m_ok = static_cast<bool>(m_out);
+  }
+
+  bool PpmStreamWriter::write_rows(std::span<std::uint8_t const> rgb) {
+    std::size_t const row = 3 * static_cast<std::size_t>(m_width);
+    if (!m_ok or row == 0 or rgb.size() % row != 0 or
+        rgb.size() / row > static_cast<std::size_t>(m_height - m_rows))
+    {
+      m_ok = false;
+      return false;
+    }
+    if (m_format == PpmFormat::P6) {
+      m_out.write(reinterpret_cast<char const *>(rgb.data()),
+                  static_cast<std::streamsize>(rgb.size()));
+    } else {
+      std::string const text = encode_p3(rgb, 1U);
+      m_out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+    m_rows += static_cast<int>(rgb.size() / row);
+    m_ok    = static_cast<bool>(m_out);
+    return m_ok;
+  }
+
+  bool PpmStreamWriter::finish() {
+    if (m_out.is_open()) {
+      m_out.close();
+    }
+    m_ok = m_ok and m_rows == m_height and !m_out.fail();
+    return m_ok;
+  }
+
+  std::array<std::uint8_t, 256> gamma_table_u8(double gamma) {
+    std::array<std::uint8_t, 256> lut{};
+    for (std::size_t i = 0; i < lut.size(); ++i) {
+      lut[i] = static_cast<std::uint8_t>(to_byte_gamma_cfg(static_cast<double>(i) / 255.0, gamma));
+    }
+    return lut;
+  }
+
+  PpmFormat parse_ppm_format(std::string const & s, PpmFormat fallback) {
+    std::string low;
+    for (char const c : s) {
+      low += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    if (low == "p3") {
+      return PpmFormat::P3;
+    }
+    if (low == "p6") {
+      return PpmFormat::P6;
+    }
+    return fallback;
   }
 
 }  // namespace render
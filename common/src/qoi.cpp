@@ -0,0 +1,302 @@
+#include "render/qoi.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <utility>
+
+namespace render {
+
+  namespace {
+
+    // Códigos (el byte entero o sus 2 bits altos)
+    constexpr std::uint8_t op_index = 0x00;  // 00iiiiii
+    constexpr std::uint8_t op_diff  = 0x40;  // 01rrggbb: dr, dg, db en [-2, 1]
+    constexpr std::uint8_t op_luma  = 0x80;  // 10gggggg rrrrbbbb: dg en [-32, 31], dr-dg y db-dg
+                                             // en [-8, 7]
+    constexpr std::uint8_t op_run   = 0xc0;  // 11rrrrrr: 1..62 repeticiones
+    constexpr std::uint8_t op_rgb   = 0xfe;
+    constexpr std::uint8_t op_rgba  = 0xff;
+    constexpr std::uint8_t mask_2   = 0xc0;
+
+    constexpr std::size_t header_size = 14;
+    constexpr std::array<std::uint8_t, 8> end_marker{0, 0, 0, 0, 0, 0, 0, 1};
+    constexpr int max_run = 62;
+    // Como la implementación de referencia: un fichero no describe más de 400 M píxeles
+    constexpr std::size_t max_pixels = 400'000'000;
+
+    std::size_t color_hash(std::uint8_t r, std::uint8_t g, std::uint8_t b, std::uint8_t a) {
+      return (3U * r + 5U * g + 7U * b + 11U * a) % 64U;
+    }
+
+    void put_u32_be(std::vector<std::uint8_t> & out, std::uint32_t v) {
+      out.push_back(static_cast<std::uint8_t>(v >> 24));
+      out.push_back(static_cast<std::uint8_t>(v >> 16));
+      out.push_back(static_cast<std::uint8_t>(v >> 8));
+      out.push_back(static_cast<std::uint8_t>(v));
+    }
+
+    std::uint32_t get_u32_be(std::span<std::uint8_t const> in) {
+      return (std::uint32_t{in[0]} << 24) | (std::uint32_t{in[1]} << 16) |
+             (std::uint32_t{in[2]} << 8) | std::uint32_t{in[3]};
+    }
+
+    std::size_t pixel_count(int width, int height) {
+      return static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+    }
+
+    bool write_bytes(std::string const & path, std::vector<std::uint8_t> const & bytes) {
+      if (bytes.empty()) {
+        return false;
+      }
+      std::ofstream out(path, std::ios::out bitor std::ios::trunc bitor std::ios::binary);
+      out.write(reinterpret_cast<char const *>(bytes.data()),
+                static_cast<std::streamsize>(bytes.size()));
+      return static_cast<bool>(out);
+    }
+
+    template <class Get>
+    std::vector<std::uint8_t> encode(int width, int height, Get && get) {
+      QoiEncoder enc(width, height);
+      std::size_t const n = pixel_count(width, height);
+      enc.out().reserve(header_size + 4 * n + end_marker.size());  // peor caso: todo RGB
+      for (std::size_t i = 0; i < n; ++i) {
+        auto const [r, g, b] = get(i);
+        enc.push(r, g, b);
+      }
+      enc.finish();
+      return std::move(enc.out());
+    }
+
+  }  // namespace
+
+  bool has_qoi_extension(std::string const & path) {
+    if (path.size() < 4) {
+      return false;
+    }
+    std::string ext = path.substr(path.size() - 4);
+    for (char & c : ext) {
+      c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return ext == ".qoi";
+  }
+
+  // ==================== CODIFICADOR ====================
+  QoiEncoder::QoiEncoder(int width, int height) {
+    m_out.insert(m_out.end(), {'q', 'o', 'i', 'f'});
+    put_u32_be(m_out, static_cast<std::uint32_t>(std::max(width, 0)));
+    put_u32_be(m_out, static_cast<std::uint32_t>(std::max(height, 0)));
+    m_out.push_back(3);  // canales
+    m_out.push_back(0);  // sRGB con alfa lineal
+  }
+
+  void QoiEncoder::push(std::uint8_t r, std::uint8_t g, std::uint8_t b) {
+    Rgba const px{r, g, b, 255};
+    if (px == m_prev) {
+      if (++m_run == max_run) {
+        m_out.push_back(static_cast<std::uint8_t>(op_run | (m_run - 1)));
+        m_run = 0;
+      }
+      return;
+    }
+    if (m_run > 0) {
+      m_out.push_back(static_cast<std::uint8_t>(op_run | (m_run - 1)));
+      m_run = 0;
+    }
+
+    std::size_t const h = color_hash(r, g, b, 255);
+    if (m_index[h] == px) {
+      m_out.push_back(static_cast<std::uint8_t>(op_index | h));
+    } else {
+      m_index[h] = px;
+      // Diferencias con el anterior en aritmética de 8 bits con vuelta (como la referencia)
+      auto const dr  = static_cast<std::int8_t>(r - m_prev.r);
+      auto const dg  = static_cast<std::int8_t>(g - m_prev.g);
+      auto const db  = static_cast<std::int8_t>(b - m_prev.b);
+      int const dr_g = dr - dg;
+      int const db_g = db - dg;
+      if (dr >= -2 and dr <= 1 and dg >= -2 and dg <= 1 and db >= -2 and db <= 1) {
+        m_out.push_back(static_cast<std::uint8_t>(op_diff | (dr + 2) << 4 | (dg + 2) << 2 |
+                                                  (db + 2)));
+      } else if (dr_g >= -8 and dr_g <= 7 and dg >= -32 and dg <= 31 and db_g >= -8 and
+                 db_g <= 7)
+      {
+        m_out.push_back(static_cast<std::uint8_t>(op_luma | (dg + 32)));
+        m_out.push_back(static_cast<std::uint8_t>((dr_g + 8) << 4 | (db_g + 8)));
+      } else {
+        m_out.insert(m_out.end(), {op_rgb, r, g, b});
+      }
+    }
+    m_prev = px;
+  }
+
+  void QoiEncoder::finish() {
+    if (m_run > 0) {
+      m_out.push_back(static_cast<std::uint8_t>(op_run | (m_run - 1)));
+      m_run = 0;
+    }
+    m_out.insert(m_out.end(), end_marker.begin(), end_marker.end());
+  }
+
+  std::vector<std::uint8_t> encode_qoi(int width, int height, std::span<std::uint8_t const> rgb) {
+    if (width < 0 or height < 0 or rgb.size() != 3 * pixel_count(width, height)) {
+      return {};
+    }
+    return encode(width, height, [&](std::size_t i) {
+      return std::array{rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2]};
+    });
+  }
+
+  std::vector<std::uint8_t> encode_qoi(int width, int height, std::span<std::uint8_t const> r,
+                                       std::span<std::uint8_t const> g,
+                                       std::span<std::uint8_t const> b) {
+    std::size_t const n = (width < 0 or height < 0) ? 0 : pixel_count(width, height);
+    if (width < 0 or height < 0 or r.size() != n or g.size() != n or b.size() != n) {
+      return {};
+    }
+    return encode(width, height, [&](std::size_t i) { return std::array{r[i], g[i], b[i]}; });
+  }
+
+  bool write_qoi(std::string const & path, int width, int height,
+                 std::span<std::uint8_t const> rgb) {
+    return write_bytes(path, encode_qoi(width, height, rgb));
+  }
+
+  bool write_qoi(std::string const & path, int width, int height, std::span<std::uint8_t const> r,
+                 std::span<std::uint8_t const> g, std::span<std::uint8_t const> b) {
+    return write_bytes(path, encode_qoi(width, height, r, g, b));
+  }
+
+  // ==================== DECODIFICADOR ====================
+  std::optional<QoiImage> decode_qoi(std::span<std::uint8_t const> bytes) {
+    if (bytes.size() < header_size + end_marker.size() or bytes[0] != 'q' or bytes[1] != 'o' or
+        bytes[2] != 'i' or bytes[3] != 'f')
+    {
+      return std::nullopt;
+    }
+    std::uint32_t const w     = get_u32_be(bytes.subspan(4));
+    std::uint32_t const h     = get_u32_be(bytes.subspan(8));
+    std::uint8_t const chans  = bytes[12];
+    std::uint8_t const cspace = bytes[13];
+    auto const max_side       = static_cast<std::uint32_t>(std::numeric_limits<int>::max());
+    if (w == 0 or h == 0 or w > max_side or h > max_side or (chans != 3 and chans != 4) or
+        cspace > 1 or std::size_t{w} * std::size_t{h} > max_pixels)
+    {
+      return std::nullopt;
+    }
+
+    QoiImage img{static_cast<int>(w), static_cast<int>(h), {}};
+    std::size_t const n = std::size_t{w} * std::size_t{h};
+    img.rgb.resize(3 * n);
+
+    struct Rgba {
+      std::uint8_t r{}, g{}, b{}, a{};
+    };
+    std::array<Rgba, 64> index{};
+    Rgba px{0, 0, 0, 255};
+    int run         = 0;
+    std::size_t pos = header_size;
+    // Los códigos nunca se leen dentro del marcador de fin
+    std::size_t const end = bytes.size() - end_marker.size();
+
+    for (std::size_t i = 0; i < n; ++i) {
+      if (run > 0) {
+        --run;
+      } else {
+        if (pos >= end) {
+          return std::nullopt;
+        }
+        std::uint8_t const op = bytes[pos++];
+        if (op == op_rgb) {
+          if (end - pos < 3) {
+            return std::nullopt;
+          }
+          px.r  = bytes[pos];
+          px.g  = bytes[pos + 1];
+          px.b  = bytes[pos + 2];
+          pos  += 3;
+        } else if (op == op_rgba) {
+          if (end - pos < 4) {
+            return std::nullopt;
+          }
+          px   = {bytes[pos], bytes[pos + 1], bytes[pos + 2], bytes[pos + 3]};
+          pos += 4;
+        } else if ((op & mask_2) == op_index) {
+          px = index[op];
+        } else if ((op & mask_2) == op_diff) {
+          px.r = static_cast<std::uint8_t>(px.r + ((op >> 4) & 0x03) - 2);
+          px.g = static_cast<std::uint8_t>(px.g + ((op >> 2) & 0x03) - 2);
+          px.b = static_cast<std::uint8_t>(px.b + (op & 0x03) - 2);
+        } else if ((op & mask_2) == op_luma) {
+          if (pos >= end) {
+            return std::nullopt;
+          }
+          std::uint8_t const b2 = bytes[pos++];
+          int const dg          = (op & 0x3f) - 32;
+          px.r = static_cast<std::uint8_t>(px.r + dg - 8 + ((b2 >> 4) & 0x0f));
+          px.g = static_cast<std::uint8_t>(px.g + dg);
+          px.b = static_cast<std::uint8_t>(px.b + dg - 8 + (b2 & 0x0f));
+        } else {
+          run = op & 0x3f;  // este píxel y 'run' más
+        }
+        index[color_hash(px.r, px.g, px.b, px.a)] = px;
+      }
+      img.rgb[3 * i]     = px.r;
+      img.rgb[3 * i + 1] = px.g;
+      img.rgb[3 * i + 2] = px.b;
+    }
+
+    if (!std::ranges::equal(bytes.subspan(end), end_marker)) {
+      return std::nullopt;
+    }
+    return img;
+  }
+
+  // ==================== ESCRITURA INCREMENTAL ====================
+  QoiStreamWriter::QoiStreamWriter(std::string const & path, int width, int height)
+      : m_enc(width, height), m_width(width), m_height(height) {
+    if (width < 0 or height < 0) {
+      return;
+    }
+    m_out.open(path, std::ios::out bitor std::ios::trunc bitor std::ios::binary);
+    m_ok = m_out.is_open() and flush();
+  }
+
+  bool QoiStreamWriter::flush() {
+    std::vector<std::uint8_t> & bytes = m_enc.out();
+    m_out.write(reinterpret_cast<char const *>(bytes.data()),
+                static_cast<std::streamsize>(bytes.size()));
+    bytes.clear();
+    return static_cast<bool>(m_out);
+  }
+
+  bool QoiStreamWriter::write_rows(std::span<std::uint8_t const> rgb) {
+    std::size_t const row = 3 * static_cast<std::size_t>(m_width);
+    if (!m_ok or row == 0 or rgb.size() % row != 0 or
+        rgb.size() / row > static_cast<std::size_t>(m_height - m_rows))
+    {
+      m_ok = false;
+      return false;
+    }
+    for (std::size_t i = 0; i < rgb.size(); i += 3) {
+      m_enc.push(rgb[i], rgb[i + 1], rgb[i + 2]);
+    }
+    m_rows += static_cast<int>(rgb.size() / row);
+    m_ok    = flush();
+    return m_ok;
+  }
+
+  bool QoiStreamWriter::finish() {
+    if (m_ok and m_rows == m_height) {
+      m_enc.finish();
+      m_ok = flush();
+    } else {
+      m_ok = false;
+    }
+    if (m_out.is_open()) {
+      m_out.close();
+    }
+    return m_ok and !m_out.fail();
+  }
+
+}  // namespace render
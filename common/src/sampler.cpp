@@ -0,0 +1,59 @@
+#include "render/sampler.hpp"
+
+#include <cctype>
+#include <cmath>
+#include <string>
+
+namespace render {
+
+  StrataGrid strata_grid(std::uint32_t spp) {
+    std::uint64_t const n = (spp == 0U) ? 1U : spp;
+    // sqrt en double (exacta para enteros de 32 bits salvo el redondeo) y un paso de ajuste
+    auto nx = static_cast<std::uint64_t>(std::sqrt(static_cast<double>(n)));
+    if (nx * nx < n) {
+      ++nx;
+    } else if (nx > 1U and (nx - 1U) * (nx - 1U) >= n) {
+      --nx;
+    }
+    std::uint64_t ny = (n + nx - 1U) / nx;
+    if (nx * ny > 0xFFFF'FFFFU) {
+      --ny;
+    }
+    return {static_cast<std::uint32_t>(nx), static_cast<std::uint32_t>(ny)};
+  }
+
+  std::optional<SamplerKind> parse_sampler(std::string_view s) {
+    std::string v;
+    for (char const c : s) {
+      v += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    if (v == "random" or v == "white") {
+      return SamplerKind::Random;
+    }
+    if (v == "stratified" or v == "jittered") {
+      return SamplerKind::Stratified;
+    }
+    if (v == "sobol") {
+      return SamplerKind::Sobol;
+    }
+    if (v == "r2") {
+      return SamplerKind::R2;
+    }
+    return std::nullopt;
+  }
+
+  char const * sampler_name(SamplerKind k) {
+    switch (k) {
+      case SamplerKind::Random:
+        return "random";
+      case SamplerKind::Stratified:
+        return "stratified";
+      case SamplerKind::Sobol:
+        return "sobol";
+      case SamplerKind::R2:
+        return "r2";
+    }
+    return "random";
+  }
+
+}  // namespace render
@@ -0,0 +1,198 @@
+#include "render/scene_cache.hpp"
+
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <span>
+#include <system_error>
+#include <utility>
+
+#include "render/hash.hpp"
+#include "render/mapped_file.hpp"
+#include "render/parser.hpp"
+
+namespace render {
+
+  namespace {
+
+    void set_err(std::string * err, std::string msg) {
+      if (err) {
+        *err = std::move(msg);
+      }
+    }
+
+    std::uint64_t mix(std::uint64_t h, std::uint64_t v) {
+      return fnv1a64(std::as_bytes(std::span{&v, 1}), h);
+    }
+
+    // Copia alineada de un bloque (cuando la caché no se ha podido proyectar)
+    std::shared_ptr<std::byte const> aligned_copy(std::span<std::byte const> bytes) {
+      constexpr std::align_val_t align{CompiledScene::alignment};
+      auto * raw = static_cast<std::byte *>(::operator new(bytes.size(), align));
+      std::memcpy(raw, bytes.data(), bytes.size());
+      return {raw, [](std::byte const * p) {
+                ::operator delete(const_cast<std::byte *>(p), align);
+              }};
+    }
+
+  }  // namespace
+
+  std::uint64_t scene_cache_layout() {
+    std::uint64_t h = mix(fnv1a_basis, sizeof(SceneCacheHeader));
+    h               = mix(h, std::endian::native == std::endian::little ? 1U : 2U);
+    h               = mix(h, sizeof(double));
+    h               = mix(h, sizeof(MaterialPre));
+    h               = mix(h, CompiledScene::alignment);
+    h               = mix(h, Bvh::node_size);
+    h               = mix(h, static_cast<std::uint64_t>(Bvh::num_bins));
+    return mix(h, static_cast<std::uint64_t>(Bvh::max_leaf_size));
+  }
+
+  bool write_scene_cache(std::string const & path, std::uint64_t source_hash,
+                         CompiledScene const & scn, Bvh const * bvh, std::string * err) {
+    SceneCacheHeader hdr;
+    hdr.source_hash = source_hash;
+    hdr.layout      = scene_cache_layout();
+    hdr.spheres     = static_cast<std::uint32_t>(scn.spheres().size());
+    hdr.cylinders   = static_cast<std::uint32_t>(scn.cylinders().size());
+    hdr.materials   = static_cast<std::uint32_t>(scn.materials().size());
+    hdr.scene_bytes = scn.bytes();
+    hdr.bvh_nodes   = (bvh != nullptr) ? bvh->node_count() : 0U;
+    hdr.bvh_prims   = (bvh != nullptr) ? bvh->prim_count() : 0U;
+
+    std::string const tmp = path + ".tmp";
+    {
+      std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+      auto put = [&](std::span<std::byte const> b) {
+        out.write(reinterpret_cast<char const *>(b.data()),
+                  static_cast<std::streamsize>(b.size()));
+      };
+      put(std::as_bytes(std::span{&hdr, 1}));
+      put(scn.data());
+      if (bvh != nullptr) {
+        put(bvh->node_bytes());
+        put(std::as_bytes(bvh->prim_ids()));
+      }
+      out.flush();
+      if (!out) {
+        set_err(err, "Error: cannot write scene cache '" + tmp + "'");
+        return false;
+      }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+      set_err(err, "Error: cannot write scene cache '" + path + "': " + ec.message());
+      return false;
+    }
+    return true;
+  }
+
+  std::optional<CachedScene> load_scene_cache(std::string const & path,
+                                              std::uint64_t source_hash, std::string * err) {
+    auto file = MappedFile::open(path);
+    if (!file) {
+      set_err(err, "Error: cannot open scene cache '" + path + "'");
+      return std::nullopt;
+    }
+    std::span<std::byte const> const bytes = file->bytes();
+
+    SceneCacheHeader hdr;
+    SceneCacheHeader const expected;
+    if (bytes.size() < sizeof hdr) {
+      set_err(err, "Error: '" + path + "' is not a scene cache");
+      return std::nullopt;
+    }
+    std::memcpy(&hdr, bytes.data(), sizeof hdr);
+    if (hdr.magic != expected.magic) {
+      set_err(err, "Error: '" + path + "' is not a scene cache");
+      return std::nullopt;
+    }
+    if (hdr.version != expected.version or hdr.layout != scene_cache_layout()) {
+      set_err(err, "Error: scene cache '" + path + "' was written by another version");
+      return std::nullopt;
+    }
+    if (hdr.source_hash != source_hash) {
+      set_err(err, "Error: scene cache '" + path + "' is stale");
+      return std::nullopt;
+    }
+    // Tamaños con cuentas en 64 bits: una cabecera corrupta no puede desbordar la suma
+    std::uint64_t const nodes_bytes = hdr.bvh_nodes * Bvh::node_size;
+    std::uint64_t const prims_bytes = hdr.bvh_prims * sizeof(std::uint32_t);
+    if (hdr.bvh_nodes > bytes.size() or hdr.bvh_prims > bytes.size() or
+        hdr.scene_bytes > bytes.size() or
+        bytes.size() != sizeof hdr + hdr.scene_bytes + nodes_bytes + prims_bytes)
+    {
+      set_err(err, "Error: scene cache '" + path + "' is truncated");
+      return std::nullopt;
+    }
+
+    // La escena apunta directamente a la proyección, que vive mientras viva la escena (o
+    // sus copias). Con la copia leída (sin mmap) el bloque puede no estar alineado.
+    auto const scene_block = bytes.subspan(sizeof hdr, hdr.scene_bytes);
+    std::shared_ptr<std::byte const> block;
+    if (file->mapped()) {
+      auto owner = std::make_shared<MappedFile const>(std::move(*file));
+      block      = std::shared_ptr<std::byte const>(owner, scene_block.data());
+    } else {
+      block = aligned_copy(scene_block);
+    }
+    auto scene = CompiledScene::adopt(std::move(block), scene_block.size(), hdr.spheres,
+                                      hdr.cylinders, hdr.materials);
+    if (!scene) {
+      set_err(err, "Error: scene cache '" + path + "' is corrupt");
+      return std::nullopt;
+    }
+
+    CachedScene out{std::move(*scene), std::nullopt};
+    if (hdr.bvh_nodes > 0U) {
+      auto const nodes = bytes.subspan(sizeof hdr + hdr.scene_bytes, nodes_bytes);
+      // Los índices van justo detrás, a 4 bytes de alineación como mínimo (64 + 64k + 64n)
+      auto const * ids = reinterpret_cast<std::uint32_t const *>(nodes.data() + nodes.size());
+      out.bvh          = Bvh::from_bytes(nodes, std::span{ids, hdr.bvh_prims}, hdr.spheres,
+                                         hdr.cylinders);
+      if (!out.bvh) {
+        set_err(err, "Error: scene cache '" + path + "' is corrupt");
+        return std::nullopt;
+      }
+    }
+    return out;
+  }
+
+  std::optional<LoadedScene> load_scene(std::string const & scene_path,
+                                        std::string const & cache_path, bool hash_source,
+                                        std::string * err, std::string * note) {
+    auto const file = MappedFile::open(scene_path);
+    if (!file) {
+      set_err(err, "Error: cannot open file '" + scene_path + "'");
+      return std::nullopt;
+    }
+    bool const use_cache            = !cache_path.empty();
+    std::uint64_t const source_hash = (use_cache or hash_source) ? fnv1a64(file->bytes()) : 0U;
+    if (use_cache) {
+      if (auto cached = load_scene_cache(cache_path, source_hash, note)) {
+        Bvh bvh = cached->bvh ? std::move(*cached->bvh) : Bvh::build(cached->scene);
+        if (note) {
+          *note = "scene cache: loaded '" + cache_path + "'";
+        }
+        return LoadedScene{std::move(cached->scene), std::move(bvh), source_hash, true};
+      }
+    }
+
+    auto scn = try_parse_scene_text_parallel(file->text(), scene_path, err);
+    if (!scn) {
+      return std::nullopt;
+    }
+    CompiledScene cscn = CompiledScene::compile(*scn);
+    Bvh bvh            = Bvh::build(cscn);
+    // Sin caché o con una que no vale: se (re)escribe para la próxima vez
+    if (use_cache and write_scene_cache(cache_path, source_hash, cscn, &bvh, note) and note) {
+      *note = "scene cache: wrote '" + cache_path + "'";
+    }
+    return LoadedScene{std::move(cscn), std::move(bvh), source_hash, false};
+  }
+
+}  // namespace render
@@ -0,0 +1,634 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "render/mapped_file.hpp"
+#include "render/parser.hpp"
+#include "render/scene.hpp"
+#include "render/tiles.hpp"
+#include "render/vector.hpp"
+
+// Parser de escenas sin copias: el fichero proyectado se recorre con string_view, las líneas
+// y los tokens son vistas sobre él y los números salen de from_chars. Reproduce paso a paso
+// el parser de referencia (try_parse_scene_stream en parser.cpp): mismas comprobaciones, en
+// el mismo orden, con los mismos mensajes.
+
+namespace render {
+
+  namespace {
+
+    // std::isspace en la locale "C"
+    constexpr bool is_space(char c) {
+      return c == ' ' or c == '\t' or c == '\n' or c == '\v' or c == '\f' or c == '\r';
+    }
+
+    constexpr bool is_digit(char c) {
+      return c >= '0' and c <= '9';
+    }
+
+    constexpr std::string_view trim(std::string_view s) {
+      while (!s.empty() and is_space(s.front())) {
+        s.remove_prefix(1);
+      }
+      while (!s.empty() and is_space(s.back())) {
+        s.remove_suffix(1);
+      }
+      return s;
+    }
+
+    // Mismo filtro que clean_and_is_content_line: recorta, descarta vacías y comentarios y
+    // corta el comentario del final
+    constexpr bool content_line(std::string_view & line) {
+      line = trim(line);
+      if (line.empty() or line.front() == '#') {
+        return false;
+      }
+      if (auto const pos = line.find('#'); pos != std::string_view::npos) {
+        line = trim(line.substr(0, pos));
+        if (line.empty()) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    // El número completo del token (como parse_double_sv)
+    bool parse_double_sv(std::string_view sv, double & out) {
+      char const * e = sv.data() + sv.size();
+      auto const res = std::from_chars(sv.data(), e, out);
+      return res.ec == std::errc{} and res.ptr == e;
+    }
+
+    bool parse_vec3_csv(std::string_view s, Vec3 & v) {
+      std::size_t const p1 = s.find(',');
+      if (p1 == std::string_view::npos) {
+        return false;
+      }
+      std::size_t const p2 = s.find(',', p1 + 1);
+      if (p2 == std::string_view::npos) {
+        return false;
+      }
+      double x{}, y{}, z{};
+      if (!parse_double_sv(s.substr(0, p1), x) or
+          !parse_double_sv(s.substr(p1 + 1, p2 - p1 - 1), y) or
+          !parse_double_sv(s.substr(p2 + 1), z))
+      {
+        return false;
+      }
+      v = Vec3{x, y, z};
+      return true;
+    }
+
+    bool normalize_safe(Vec3 & v) {
+      double const n = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+      if (n <= 1e-12) {
+        return false;
+      }
+      v.x /= n;
+      v.y /= n;
+      v.z /= n;
+      return true;
+    }
+
+    // Lectura de una línea con la semántica de 'iss >> x' sobre std::istringstream, pero
+    // sobre una vista y sin reservar memoria. Como en el stream, una lectura fallida no
+    // deshace lo consumido: quien quiera volver atrás guarda mark() y llama a seek().
+    class LineCursor {
+    public:
+      explicit constexpr LineCursor(std::string_view line) : m_rest(line) { }
+
+      // iss >> std::string
+      bool word(std::string_view & out) {
+        skip_space();
+        if (m_rest.empty()) {
+          return false;
+        }
+        std::size_t n = 0;
+        while (n < m_rest.size() and !is_space(m_rest[n])) {
+          ++n;
+        }
+        out = m_rest.substr(0, n);
+        m_rest.remove_prefix(n);
+        return true;
+      }
+
+      // iss >> double: consume el mismo prefijo que num_get ([+-] dígitos [. dígitos]
+      // [e [+-] dígitos]) y solo acepta si ese prefijo es un número entero y finito
+      bool number(double & out) {
+        skip_space();
+        std::size_t n = 0;
+        if (n < m_rest.size() and (m_rest[n] == '+' or m_rest[n] == '-')) {
+          ++n;
+        }
+        bool mantissa = false, dot = false, sci = false;
+        while (n < m_rest.size()) {
+          char const c = m_rest[n];
+          if (is_digit(c)) {
+            mantissa = true;
+          } else if (c == '.' and !dot and !sci) {
+            dot = true;
+          } else if ((c == 'e' or c == 'E') and mantissa and !sci) {
+            sci = true;
+            if (n + 1 < m_rest.size() and (m_rest[n + 1] == '+' or m_rest[n + 1] == '-')) {
+              ++n;
+            }
+          } else {
+            break;
+          }
+          ++n;
+        }
+        std::string_view const tok = m_rest.substr(0, n);
+        m_rest.remove_prefix(n);
+        return to_double(tok, out);
+      }
+
+      [[nodiscard]] constexpr std::string_view mark() const { return m_rest; }
+
+      constexpr void seek(std::string_view mark) { m_rest = mark; }
+
+    private:
+      constexpr void skip_space() {
+        while (!m_rest.empty() and is_space(m_rest.front())) {
+          m_rest.remove_prefix(1);
+        }
+      }
+
+      // Lo que hace strtod sobre el prefijo en la conversión de num_get: todo el texto o
+      // nada, y desbordar a infinito es un error (el subdesbordamiento no)
+      static bool to_double(std::string_view tok, double & out) {
+        std::string_view digits = tok;
+        if (!digits.empty() and digits.front() == '+') {
+          digits.remove_prefix(1);  // from_chars no admite '+'
+        }
+        char const * e = digits.data() + digits.size();
+        double v{};
+        auto const res = std::from_chars(digits.data(), e, v);
+        if (res.ptr != e or digits.empty()) {
+          return false;
+        }
+        if (res.ec == std::errc::result_out_of_range) {
+          // Caso raro: que decida strtod (necesita la cadena terminada en '\0')
+          std::string const copy{tok};
+          v = std::strtod(copy.c_str(), nullptr);
+        } else if (res.ec != std::errc{}) {
+          return false;
+        }
+        if (std::abs(v) == std::numeric_limits<double>::infinity()) {
+          return false;
+        }
+        out = v;
+        return true;
+      }
+
+      std::string_view m_rest;
+    };
+
+    constexpr bool is_kind(std::string_view s) {
+      return s == "matte" or s == "metal" or s == "refractive";
+    }
+
+    // Estado del parseo línea a línea. El secuencial usa uno para todo el fichero; el paralelo,
+    // uno para los materiales y otro por cada trozo de la sección de objetos, que empieza con
+    // una copia de la tabla de materiales ya cerrada. Los nombres son vistas sobre el texto.
+    struct SceneLineParser {
+      std::string const * filename{};
+      Scene scn;
+      std::unordered_map<std::string_view, std::uint32_t> mat_names;  // nombre -> índice
+      std::unordered_set<std::string_view> sph_names, cyl_names;
+      bool objects{false};  // ya ha salido un objeto: no se admiten más materiales
+      std::string error;    // mensaje del primer error (vacío si no hay)
+
+      explicit SceneLineParser(std::string const & name) : filename(&name) { }
+
+      bool fail(int line, std::string const & msg) {
+        error = "Error: " + msg + " in " + *filename + ":" + std::to_string(line);
+        return false;
+      }
+
+      // Una línea ya limpia (content_line); false si tiene un error
+      bool parse(std::string_view raw, int line_no);
+
+      // Recorre las líneas de 'text' numerándolas desde line_no + 1; false en el primer
+      // error. Si 'until_objects', para también tras la primera línea de objeto (text queda
+      // apuntando a lo que falta).
+      bool parse_lines(std::string_view & text, int & line_no, bool until_objects);
+    };
+
+    bool SceneLineParser::parse(std::string_view raw, int line_no) {
+      LineCursor iss{raw};
+      std::string_view head;
+      if (!iss.word(head)) {
+        return true;
+      }
+
+      // -------- Material --------
+      if (head == "material" or is_kind(head)) {
+        std::string_view kind_str, name;
+        if (head == "material") {
+          if (!iss.word(kind_str) or !iss.word(name)) {
+            return fail(line_no, "invalid material header");
+          }
+        } else {
+          kind_str = head;
+          if (!iss.word(name)) {
+            return fail(line_no, "invalid material header");
+          }
+        }
+        if (objects) {
+          return fail(line_no, "material declared after objects");
+        }
+
+        Material m{};
+        if (kind_str == "matte") {
+          m.kind = MaterialKind::Matte;
+        } else if (kind_str == "metal") {
+          m.kind = MaterialKind::Metal;
+        } else if (kind_str == "refractive") {
+          m.kind = MaterialKind::Refractive;
+        } else {
+          return fail(line_no, "unknown material kind '" + std::string{kind_str} + "'");
+        }
+
+        if (!mat_names.emplace(name, static_cast<std::uint32_t>(scn.materials.size())).second) {
+          return fail(line_no, "duplicated material '" + std::string{name} + "'");
+        }
+        m.name = name;
+
+        std::string_view tok;
+        while (iss.word(tok)) {
+          if (tok == "color" and m.kind != MaterialKind::Refractive) {
+            auto const pos = iss.mark();
+            double r{}, g{}, b{};
+            if (iss.number(r) and iss.number(g) and iss.number(b)) {
+              m.color = Vec3{r, g, b};
+            } else {
+              iss.seek(pos);
+              std::string_view csv;
+              Vec3 c{};
+              if (!iss.word(csv) or !parse_vec3_csv(csv, c)) {
+                return fail(line_no, "invalid format for 'color'");
+              }
+              m.color = c;
+            }
+          } else if (tok.starts_with("color=") and m.kind != MaterialKind::Refractive) {
+            Vec3 c{};
+            if (!parse_vec3_csv(tok.substr(6), c)) {
+              return fail(line_no, "invalid format for 'color'");
+            }
+            m.color = c;
+
+          } else if (tok == "fuzz" and m.kind == MaterialKind::Metal) {
+            if (!iss.number(m.fuzz)) {
+              return fail(line_no, "invalid value for 'fuzz'");
+            }
+          } else if (tok.starts_with("fuzz=") and m.kind == MaterialKind::Metal) {
+            if (!parse_double_sv(tok.substr(5), m.fuzz)) {
+              return fail(line_no, "invalid value for 'fuzz'");
+            }
+
+          } else if (tok == "ior" and m.kind == MaterialKind::Refractive) {
+            if (!iss.number(m.ior)) {
+              return fail(line_no, "invalid value for 'ior'");
+            }
+          } else if (tok.starts_with("ior=") and m.kind == MaterialKind::Refractive) {
+            if (!parse_double_sv(tok.substr(4), m.ior)) {
+              return fail(line_no, "invalid value for 'ior'");
+            }
+
+          } else {
+            std::string const key{tok.substr(0, tok.find('='))};
+            return fail(line_no,
+                        "unknown key '" + key + "' for material '" + std::string{kind_str} + "'");
+          }
+        }
+
+        if (m.kind == MaterialKind::Metal and (m.fuzz < 0.0 or m.fuzz > 1.0)) {
+          return fail(line_no, "invalid value for 'fuzz' (must be in [0,1])");
+        }
+        if (m.kind == MaterialKind::Refractive and m.ior <= 1.0) {
+          return fail(line_no, "invalid value for 'ior' (must be > 1)");
+        }
+
+        scn.materials.push_back(std::move(m));
+        return true;
+      }
+
+      // -------- Objetos --------
+      if (head == "sphere") {
+        if (mat_names.empty()) {
+          return fail(line_no, "object declared before materials");
+        }
+        objects = true;
+
+        // (1) sphere NAME center=.. radius=.. mat=..
+        // (2) sphere NAME cx cy cz r mat
+        // (3) sphere cx cy cz r   (legacy sin nombre/material)
+        std::string_view first;
+        if (!iss.word(first)) {
+          return fail(line_no, "invalid sphere format");
+        }
+        auto const pos = iss.mark();
+        std::string_view nxt;
+        bool const is_kv = iss.word(nxt) and nxt.find('=') != std::string_view::npos;
+        iss.seek(pos);
+
+        if (is_kv) {
+          Sphere s{};
+          std::string_view mat;
+          bool okc = false, okr = false, okm = false;
+          std::string_view kv;
+          while (iss.word(kv)) {
+            if (kv.starts_with("center=")) {
+              if (!parse_vec3_csv(kv.substr(7), s.center)) {
+                return fail(line_no, "invalid format for 'center' (x,y,z)");
+              }
+              okc = true;
+            } else if (kv.starts_with("radius=")) {
+              if (!parse_double_sv(kv.substr(7), s.radius) or s.radius <= 0.0) {
+                return fail(line_no, "sphere radius must be > 0");
+              }
+              okr = true;
+            } else if (kv.starts_with("mat=")) {
+              mat = kv.substr(4);
+              okm = true;
+            } else {
+              return fail(line_no, "unknown key '" + std::string{kv.substr(0, kv.find('='))} +
+                                       "' for 'sphere'");
+            }
+          }
+          if (!(okc and okr and okm)) {
+            return fail(line_no, "invalid sphere format");
+          }
+          if (!sph_names.insert(first).second) {
+            return fail(line_no, "duplicated object '" + std::string{first} + "'");
+          }
+          auto const mat_id = mat_names.find(mat);
+          if (mat_id == mat_names.end()) {
+            return fail(line_no, "unknown material '" + std::string{mat} + "'");
+          }
+          s.name = scn.names.add(first);
+          s.mat  = mat_id->second;
+          scn.spheres.push_back(s);
+          return true;
+        }
+
+        double x{};
+        if (parse_double_sv(first, x)) {
+          Sphere s{};
+          s.center.x = x;
+          if (!iss.number(s.center.y) or !iss.number(s.center.z) or !iss.number(s.radius)) {
+            return fail(line_no, "invalid sphere format");
+          }
+          if (s.radius <= 0.0) {
+            return fail(line_no, "sphere radius must be > 0");
+          }
+          s.name = legacy_name | static_cast<std::uint32_t>(line_no);
+          scn.spheres.push_back(s);
+          return true;
+        }
+
+        Sphere s{};
+        if (!sph_names.insert(first).second) {
+          return fail(line_no, "duplicated object '" + std::string{first} + "'");
+        }
+        if (!iss.number(s.center.x) or !iss.number(s.center.y) or !iss.number(s.center.z) or
+            !iss.number(s.radius))
+        {
+          return fail(line_no, "invalid sphere format");
+        }
+        if (s.radius <= 0.0) {
+          return fail(line_no, "sphere radius must be > 0");
+        }
+        std::string_view mat, extra;
+        if (!iss.word(mat)) {
+          return fail(line_no, "invalid sphere format");
+        }
+        auto const mat_id = mat_names.find(mat);
+        if (mat_id == mat_names.end()) {
+          return fail(line_no, "unknown material '" + std::string{mat} + "'");
+        }
+        if (iss.word(extra)) {
+          return fail(line_no, "trailing data after sphere");
+        }
+        s.name = scn.names.add(first);
+        s.mat  = mat_id->second;
+        scn.spheres.push_back(s);
+        return true;
+      }
+
+      if (head == "cylinder") {
+        if (mat_names.empty()) {
+          return fail(line_no, "object declared before materials");
+        }
+        objects = true;
+
+        std::string_view name;
+        if (!iss.word(name)) {
+          return fail(line_no, "invalid cylinder header");
+        }
+        if (!cyl_names.insert(name).second) {
+          return fail(line_no, "duplicated object '" + std::string{name} + "'");
+        }
+
+        Cylinder c{};
+        if (!iss.number(c.base.x) or !iss.number(c.base.y) or !iss.number(c.base.z) or
+            !iss.number(c.axis.x) or !iss.number(c.axis.y) or !iss.number(c.axis.z) or
+            !iss.number(c.height) or !iss.number(c.radius))
+        {
+          return fail(line_no, "invalid cylinder format");
+        }
+        if (c.height <= 0.0 or c.radius <= 0.0) {
+          return fail(line_no, "invalid value for 'height'/'radius' (must be > 0)");
+        }
+        std::string_view mat, extra;
+        if (!iss.word(mat)) {
+          return fail(line_no, "invalid cylinder format");
+        }
+        if (!normalize_safe(c.axis)) {
+          return fail(line_no, "invalid value for 'axis' (zero vector)");
+        }
+        auto const mat_id = mat_names.find(mat);
+        if (mat_id == mat_names.end()) {
+          return fail(line_no, "unknown material '" + std::string{mat} + "'");
+        }
+        if (iss.word(extra)) {
+          return fail(line_no, "trailing data after cylinder");
+        }
+        c.name = scn.names.add(name);
+        c.mat  = mat_id->second;
+        scn.cylinders.push_back(c);
+        return true;
+      }
+
+      // directiva desconocida
+      return fail(line_no, "unknown object '" + std::string{head} + "'");
+    }
+
+    bool SceneLineParser::parse_lines(std::string_view & text, int & line_no,
+                                      bool until_objects) {
+      while (!text.empty() and !(until_objects and objects)) {
+        std::size_t const eol = text.find('\n');
+        std::string_view raw  = text.substr(0, eol);
+        text.remove_prefix((eol == std::string_view::npos) ? text.size() : eol + 1);
+        ++line_no;
+
+        if (line_no == 1 and raw.starts_with("\xEF\xBB\xBF")) {
+          raw.remove_prefix(3);  // BOM
+        }
+        if (content_line(raw) and !parse(raw, line_no)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+  }  // namespace
+
+  std::optional<Scene> try_parse_scene_text(std::string_view text, std::string const & filename,
+                                            std::string * err) {
+    if (err) {
+      err->clear();
+    }
+    SceneLineParser p{filename};
+    // Una línea por objeto como mucho: reservar evita rehashes con escenas grandes
+    auto const lines = static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n')) + 1U;
+    p.sph_names.reserve(lines);
+    p.cyl_names.reserve(lines);
+    p.scn.names.reserve(lines);
+
+    int line_no = 0;
+    if (!p.parse_lines(text, line_no, false)) {
+      if (err) {
+        *err = std::move(p.error);
+      }
+      return std::nullopt;
+    }
+    return std::move(p.scn);
+  }
+
+  std::optional<Scene> try_parse_scene_text_parallel(std::string_view text,
+                                                     std::string const & filename,
+                                                     std::string * err, unsigned threads,
+                                                     std::size_t min_bytes) {
+    if (err) {
+      err->clear();
+    }
+    // Materiales y primer objeto, en secuencial: a partir de ahí la tabla de materiales ya
+    // no puede cambiar (un material más es un error) y cada línea se parsea por separado
+    SceneLineParser head{filename};
+    std::string_view rest = text;
+    int line_no           = 0;
+    if (!head.parse_lines(rest, line_no, true)) {
+      if (err) {
+        *err = std::move(head.error);
+      }
+      return std::nullopt;
+    }
+
+    unsigned const n_threads = resolve_thread_count(threads);
+    if (n_threads == 1U or rest.size() < min_bytes) {
+      return try_parse_scene_text(text, filename, err);
+    }
+
+    // Trozos de tamaño parecido cortados en saltos de línea; varios por hilo para repartir
+    std::size_t const n_target = std::size_t{n_threads} * 4U;
+    std::vector<std::string_view> chunks;
+    chunks.reserve(n_target);
+    while (!rest.empty()) {
+      std::size_t const left = n_target - std::min(chunks.size(), n_target - 1U);
+      std::size_t cut        = rest.find('\n', rest.size() / left);
+      cut                    = (cut == std::string_view::npos) ? rest.size() : cut + 1U;
+      chunks.push_back(rest.substr(0, cut));
+      rest.remove_prefix(cut);
+    }
+
+    // Cada trozo necesita su primera línea para los mensajes y los nombres "__legacy<línea>"
+    std::vector<int> first_line(chunks.size() + 1U, 0);
+    parallel_for(chunks.size(), n_threads, [&](std::size_t i) {
+      first_line[i + 1U] = static_cast<int>(std::count(chunks[i].begin(), chunks[i].end(), '\n'));
+    });
+    first_line[0] = line_no;
+    for (std::size_t i = 1; i <= chunks.size(); ++i) {
+      first_line[i] += first_line[i - 1U];
+    }
+
+    std::vector<SceneLineParser> parts(chunks.size(), SceneLineParser{filename});
+    std::vector<char> ok(chunks.size(), 0);
+    parallel_for(chunks.size(), n_threads, [&](std::size_t i) {
+      SceneLineParser & p = parts[i];
+      p.mat_names         = head.mat_names;  // copia de la tabla cerrada: solo lectura
+      p.objects           = true;
+      auto const lines    = static_cast<std::size_t>(first_line[i + 1U] - first_line[i]) + 1U;
+      p.sph_names.reserve(lines);
+      p.cyl_names.reserve(lines);
+      p.scn.names.reserve(lines);
+      std::string_view chunk = chunks[i];
+      int no                 = first_line[i];
+      ok[i]                  = p.parse_lines(chunk, no, false) ? 1 : 0;
+    });
+
+    // Un error en algún trozo o un nombre repetido entre trozos: el primer error del fichero
+    // (texto y línea) lo decide el secuencial, que es el que define el contrato. Solo pasa
+    // con ficheros incorrectos, así que no importa repetir el trabajo.
+    bool valid = std::ranges::all_of(ok, [](char c) { return c != 0; });
+    auto const n_lines = static_cast<std::size_t>(first_line.back() - line_no);
+    head.sph_names.reserve(n_lines);
+    head.cyl_names.reserve(n_lines);
+    for (std::size_t i = 0; valid and i < parts.size(); ++i) {
+      for (auto const name : parts[i].sph_names) {
+        valid = valid and head.sph_names.insert(name).second;
+      }
+      for (auto const name : parts[i].cyl_names) {
+        valid = valid and head.cyl_names.insert(name).second;
+      }
+    }
+    if (!valid) {
+      return try_parse_scene_text(text, filename, err);
+    }
+
+    // Unión en el orden del fichero
+    Scene scn               = std::move(head.scn);
+    std::size_t n_spheres   = scn.spheres.size();
+    std::size_t n_cylinders = scn.cylinders.size();
+    for (auto const & p : parts) {
+      n_spheres += p.scn.spheres.size();
+      n_cylinders += p.scn.cylinders.size();
+    }
+    scn.spheres.reserve(n_spheres);
+    scn.cylinders.reserve(n_cylinders);
+    // Los ids de nombre de cada trozo pasan a contar desde donde acaba la tabla común
+    for (auto const & p : parts) {
+      std::uint32_t const offset = scn.names.append(p.scn.names);
+      for (Sphere s : p.scn.spheres) {
+        s.name += ((s.name & legacy_name) != 0U) ? 0U : offset;
+        scn.spheres.push_back(s);
+      }
+      for (Cylinder c : p.scn.cylinders) {
+        c.name += offset;
+        scn.cylinders.push_back(c);
+      }
+    }
+    return scn;
+  }
+
+  std::optional<Scene> try_parse_scene(std::string const & filename, std::string * err) {
+    auto const file = MappedFile::open(filename);
+    if (!file) {
+      if (err) {
+        *err = "Error: cannot open file '" + filename + "'";
+      }
+      return std::nullopt;
+    }
+    return try_parse_scene_text_parallel(file->text(), filename, err);
+  }
+
+}  // namespace render
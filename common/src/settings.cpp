@@ -0,0 +1,100 @@
+#include "render/settings.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace render {
+
+  namespace {
+
+    double env_double(EnvLookup const & env, char const * k, double def) {
+      if (char const * s = env(k)) {
+        return std::atof(s);
+      }
+      return def;
+    }
+
+    // Solo valores > 0; cualquier otra cosa deja el valor por defecto
+    long long env_positive(EnvLookup const & env, char const * k, long long def) {
+      if (char const * s = env(k)) {
+        long long const v = std::atoll(s);
+        return (v > 0) ? v : def;
+      }
+      return def;
+    }
+
+    vector env_vec3(EnvLookup const & env, char const * k, vector def) {
+      if (char const * s = env(k)) {
+        double x = def.x, y = def.y, z = def.z;
+        std::sscanf(s, "%lf,%lf,%lf", &x, &y, &z);
+        return {x, y, z};
+      }
+      return def;
+    }
+
+  }  // namespace
+
+  camera RenderSettings::make_camera() const {
+    return camera{width, height, vfov_deg, lookfrom,   lookat,
+                  vup,   spp,    seed,     aperture, focus_dist, sampler};
+  }
+
+  RenderSettings resolve_settings(Config const & cfg, EnvLookup const & env) {
+    RenderSettings s;
+    s.width      = cfg.width;
+    s.height     = cfg.height;
+    s.max_depth  = cfg.max_depth;
+    s.rr_depth   = cfg.rr_depth;
+    s.gamma      = cfg.gamma;
+    s.vfov_deg   = env_double(env, "RENDER_VFOV", cfg.vertical_fov_deg);
+    s.lookfrom   = env_vec3(env, "RENDER_FROM", cfg.lookfrom);
+    s.lookat     = env_vec3(env, "RENDER_AT", cfg.lookat);
+    s.vup        = env_vec3(env, "RENDER_VUP", cfg.vup);
+    s.aperture   = env_double(env, "RENDER_APERTURE", cfg.aperture);
+    s.focus_dist = env_double(env, "RENDER_FOCUS", cfg.focus_dist);
+    s.spp  = static_cast<std::uint32_t>(env_positive(env, "RENDER_SPP", cfg.samples_per_pixel));
+    s.seed = static_cast<std::uint64_t>(
+        env_positive(env, "RENDER_SEED", static_cast<long long>(cfg.seed)));
+    s.tiles.tile_size = static_cast<int>(env_positive(env, "RENDER_TILE", s.tiles.tile_size));
+    s.tiles.threads   = static_cast<unsigned>(env_positive(env, "RENDER_THREADS", 0));
+    if (char const * f = env("RENDER_PPM_FORMAT")) {
+      s.format = parse_ppm_format(f, s.format);
+    }
+    s.sampler = cfg.sampler;
+    if (char const * k = env("RENDER_SAMPLER")) {
+      s.sampler = parse_sampler(k).value_or(s.sampler);
+    }
+    if (char const * f = env("RENDER_SPP_IMAGE")) {
+      s.spp_image = f;
+    }
+
+    s.time_budget      = std::max(env_double(env, "RENDER_TIME_BUDGET", cfg.time_budget), 0.0);
+    s.preview_interval =
+        std::max(env_double(env, "RENDER_PREVIEW_EVERY", cfg.preview_interval), 0.0);
+    if (char const * f = env("RENDER_PREVIEW")) {
+      s.preview_path = f;
+    }
+    s.checkpoint_interval =
+        std::max(env_double(env, "RENDER_CHECKPOINT_EVERY", cfg.checkpoint_interval), 0.0);
+    if (char const * f = env("RENDER_CHECKPOINT")) {
+      s.checkpoint_path = f;
+    }
+    if (char const * f = env("RENDER_SCENE_CACHE")) {
+      s.scene_cache = f;
+    }
+    s.stream_rows = static_cast<int>(env_positive(env, "RENDER_STREAM_ROWS", 0));
+
+    // Hacen falta 2 muestras para estimar la varianza y el mínimo no puede pasar del máximo
+    s.adaptive_threshold = env_double(env, "RENDER_ADAPTIVE", cfg.adaptive_threshold);
+    auto const min_spp   = env_positive(env, "RENDER_MIN_SPP", cfg.min_samples);
+    s.min_spp            = std::min(std::max(static_cast<std::uint32_t>(min_spp), 2U), s.spp);
+    return s;
+  }
+
+  RenderSettings resolve_settings(Config const & cfg) {
+    return resolve_settings(cfg, [](char const * k) -> char const * { return std::getenv(k); });
+  }
+
+}  // namespace render
@@ -0,0 +1,159 @@
+#include "render/stream.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "render/spsc_queue.hpp"
+#include "render/tiles.hpp"
+
+namespace render {
+
+  namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    double seconds_between(Clock::time_point a, Clock::time_point b) {
+      return std::chrono::duration<double>(b - a).count();
+    }
+
+  }  // namespace
+
+  bool render_bands(int width, int height, BandOptions const & opts, BandRenderFn const & render,
+                    BandEmitFn const & emit, BandStats * stats) {
+    if (width <= 0 or height <= 0) {
+      return width >= 0 and height >= 0;
+    }
+    int const rows       = std::max(1, opts.band_rows);
+    auto const n_bands   = static_cast<std::size_t>((height + rows - 1) / rows);
+    auto const n_threads = static_cast<unsigned>(
+        std::min<std::size_t>(resolve_thread_count(opts.threads), n_bands));
+    std::size_t const window =
+        std::min(n_bands, std::max<std::size_t>(opts.window > 0U ? opts.window : 2U * n_threads,
+                                                n_threads));
+    std::size_t const band_bytes =
+        static_cast<std::size_t>(rows) * static_cast<std::size_t>(width) * 3U;
+
+    // Anillo: la banda b vive en el hueco b % window desde que se empieza hasta que se escribe
+    std::vector<std::uint8_t> ring(window * band_bytes);
+    std::vector<char> ready(window, 0);
+    // Bandas listas, en orden, hacia el hilo escritor (+1 para el aviso de fin)
+    constexpr std::size_t done = std::numeric_limits<std::size_t>::max();
+    SpscQueue<std::size_t> to_writer(window + 1U);
+
+    std::mutex m;
+    std::condition_variable cv;
+    std::size_t next     = 0;  // siguiente banda por empezar
+    std::size_t handed   = 0;  // bandas ya pasadas al escritor (la siguiente a pasar)
+    std::size_t written  = 0;  // bandas ya escritas: sus huecos se pueden reutilizar
+    std::size_t pending  = 0;  // terminadas y sin escribir
+    std::size_t rendered = 0;
+    std::size_t max_pend = 0;
+    bool failed          = false;
+
+    auto slot = [&](std::size_t b) {
+      return std::span{ring}.subspan((b % window) * band_bytes, band_bytes);
+    };
+    auto band_size = [&](std::size_t b) {
+      int const y0 = static_cast<int>(b) * rows;
+      return std::pair{y0, std::min(y0 + rows, height)};
+    };
+    auto band_span = [&](std::size_t b) {
+      auto const [y0, y1] = band_size(b);
+      return slot(b).first(static_cast<std::size_t>(y1 - y0) * static_cast<std::size_t>(width) *
+                           3U);
+    };
+
+    auto const t0 = Clock::now();
+    Clock::time_point render_end{};
+    double write_busy = 0.0;
+
+    // Escritor: codifica y escribe las bandas en orden mientras los demás hilos siguen
+    // renderizando las siguientes
+    std::jthread writer([&] {
+      for (;;) {
+        std::size_t const b = to_writer.pop();
+        if (b == done) {
+          return;
+        }
+        bool ok = false;
+        {
+          std::unique_lock lk(m);
+          ok = not failed;
+        }
+        if (ok) {
+          auto const w0  = Clock::now();
+          ok             = emit(band_span(b));
+          write_busy    += seconds_between(w0, Clock::now());
+        }
+        std::unique_lock lk(m);
+        --pending;
+        ++written;
+        failed = failed or not ok;
+        cv.notify_all();
+      }
+    });
+
+    auto worker = [&]() {
+      std::unique_lock lk(m);
+      for (;;) {
+        cv.wait(lk, [&] { return failed or next >= n_bands or next < written + window; });
+        if (failed or next >= n_bands) {
+          return;
+        }
+        std::size_t const b = next++;
+        lk.unlock();
+
+        auto const [y0, y1] = band_size(b);
+        render(y0, y1, band_span(b));
+
+        lk.lock();
+        ready[b % window] = 1;
+        max_pend          = std::max(max_pend, ++pending);
+        if (++rendered == n_bands) {
+          render_end = Clock::now();
+        }
+        // En orden: se pasan todas las bandas consecutivas que ya estén listas. Nunca hay más
+        // de 'window' sin escribir, así que la cola no se llena.
+        while (handed < n_bands and ready[handed % window] != 0) {
+          ready[handed % window] = 0;
+          (void) to_writer.try_push(handed++);
+        }
+      }
+    };
+
+    {
+      std::vector<std::jthread> pool;
+      pool.reserve(n_threads - 1U);
+      for (unsigned i = 1; i < n_threads; ++i) {
+        pool.emplace_back(worker);
+      }
+      worker();  // el hilo llamante también trabaja
+    }
+    {
+      // Tras todas las bandas pasadas (lo último que hace el productor bajo el lock)
+      std::lock_guard lk(m);
+      (void) to_writer.try_push(done);
+    }
+    writer.join();
+    auto const t1 = Clock::now();
+
+    if (stats) {
+      if (rendered < n_bands) {
+        render_end = t1;
+      }
+      // Lo que el escritor sigue ocupado tras la última banda es cola (no solapada); antes
+      // de eso siempre tiene trabajo o espera a la banda siguiente
+      double const tail = std::min(write_busy, seconds_between(render_end, t1));
+      *stats = BandStats{n_bands,    window,      max_pend,        ring.size(),
+                         seconds_between(t0, t1), write_busy, write_busy - tail};
+    }
+    return !failed and written == n_bands;
+  }
+
+}  // namespace render
@@ -0,0 +1,83 @@
+#include "render/tiles.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace render {
+
+  std::vector<Tile> make_tiles(int width, int height, int tile_size) {
+    std::vector<Tile> tiles;
+    if (width <= 0 or height <= 0) {
+      return tiles;
+    }
+    int const ts = std::max(1, tile_size);
+    int const nx = (width + ts - 1) / ts;
+    int const ny = (height + ts - 1) / ts;
+    tiles.reserve(static_cast<std::size_t>(nx) * static_cast<std::size_t>(ny));
+
+    for (int y0 = 0; y0 < height; y0 += ts) {
+      for (int x0 = 0; x0 < width; x0 += ts) {
+        Tile t;
+        t.x0    = x0;
+        t.y0    = y0;
+        t.x1    = std::min(x0 + ts, width);
+        t.y1    = std::min(y0 + ts, height);
+        t.index = tiles.size();
+        tiles.push_back(t);
+      }
+    }
+    return tiles;
+  }
+
+  unsigned resolve_thread_count(unsigned requested) {
+    if (requested > 0U) {
+      return requested;
+    }
+    return std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  void parallel_for(std::size_t n, unsigned threads, std::function<void(std::size_t)> const & fn) {
+    if (n == 0U) {
+      return;
+    }
+
+    // Nunca más hilos que trabajos
+    auto const n_threads =
+        static_cast<unsigned>(std::min<std::size_t>(resolve_thread_count(threads), n));
+
+    if (n_threads == 1U) {
+      for (std::size_t i = 0; i < n; ++i) {
+        fn(i);
+      }
+      return;
+    }
+
+    // Cola de trabajo: cada hilo toma el siguiente índice libre (equilibra caros/baratos)
+    std::atomic<std::size_t> next{0};
+    auto worker = [&]() {
+      for (;;) {
+        std::size_t const i = next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= n) {
+          return;
+        }
+        fn(i);
+      }
+    };
+
+    std::vector<std::jthread> pool;
+    pool.reserve(n_threads - 1U);
+    for (unsigned i = 1; i < n_threads; ++i) {
+      pool.emplace_back(worker);
+    }
+    worker();  // el hilo llamante también trabaja
+    // ~jthread hace join
+  }
+
+  void render_tiles(int width, int height, TileOptions const & opts,
+                    std::function<void(Tile const &)> const & fn) {
+    std::vector<Tile> const tiles = make_tiles(width, height, opts.tile_size);
+    parallel_for(tiles.size(), opts.threads, [&](std::size_t i) { fn(tiles[i]); });
+  }
+
+}  // namespace render
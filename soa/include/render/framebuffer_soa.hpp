@@ -0,0 +1,117 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "render/gamma.hpp"
+#include "render/image_soa.hpp"
+
+namespace render {
+
+  // Framebuffer HDR de acumulación, SoA: un plano float por canal (sumas) y otro con el nº de
+  // muestras. Permite render progresivo / adaptativo: cada pasada suma muestras y resolve()
+  // da la media.
+  struct FramebufferSOA {
+    int width{}, height{};
+    std::vector<float> R, G, B;
+    std::vector<std::uint32_t> N;
+
+    explicit FramebufferSOA(int w, int h) : width(w), height(h) {
+      std::size_t const n = static_cast<std::size_t>(w) * static_cast<std::size_t>(h);
+      R.assign(n, 0.0F);
+      G.assign(n, 0.0F);
+      B.assign(n, 0.0F);
+      N.assign(n, 0U);
+    }
+
+    [[nodiscard]] std::size_t index(int x, int y) const {
+      return static_cast<std::size_t>(y) * static_cast<std::size_t>(width) +
+             static_cast<std::size_t>(x);
+    }
+
+    // Suma de 'n' muestras de radiancia lineal (sin recortar)
+    void add(int x, int y, float r, float g, float b, std::uint32_t n = 1U) {
+      std::size_t const i  = index(x, y);
+      R[i]                += r;
+      G[i]                += g;
+      B[i]                += b;
+      N[i]                += n;
+    }
+
+    [[nodiscard]] std::uint32_t samples(int x, int y) const { return N[index(x, y)]; }
+
+    // Media acumulada (0 si el píxel no tiene muestras)
+    void mean(int x, int y, float & r, float & g, float & b) const {
+      std::size_t const i = index(x, y);
+      float const inv     = (N[i] > 0U) ? 1.0F / static_cast<float>(N[i]) : 0.0F;
+      r                   = R[i] * inv;
+      g                   = G[i] * inv;
+      b                   = B[i] * inv;
+    }
+
+    void clear() {
+      R.assign(R.size(), 0.0F);
+      G.assign(G.size(), 0.0F);
+      B.assign(B.size(), 0.0F);
+      N.assign(N.size(), 0U);
+    }
+
+    // Estado completo en bruto (los cuatro planos), para los checkpoints (render/checkpoint.hpp).
+    // 2: planos R, G, B en float y N en uint32 (numeración compartida con FramebufferAOS).
+    static constexpr std::uint32_t checkpoint_layout = 2U;
+
+    [[nodiscard]] std::array<std::span<std::byte const>, 4> bytes() const {
+      return {std::as_bytes(std::span{R}), std::as_bytes(std::span{G}),
+              std::as_bytes(std::span{B}), std::as_bytes(std::span{N})};
+    }
+
+    [[nodiscard]] std::array<std::span<std::byte>, 4> bytes() {
+      return {std::as_writable_bytes(std::span{R}), std::as_writable_bytes(std::span{G}),
+              std::as_writable_bytes(std::span{B}), std::as_writable_bytes(std::span{N})};
+    }
+
+    // Muestras de todo el buffer (con muestreo adaptativo: el coste real del render)
+    [[nodiscard]] std::uint64_t total_samples() const {
+      std::uint64_t total = 0;
+      for (std::uint32_t const n : N) {
+        total += n;
+      }
+      return total;
+    }
+
+    // Imagen de depuración en grises: muestras del píxel / max_n (blanco = max_n o más)
+    [[nodiscard]] ImageSOA samples_image(std::uint32_t max_n) const {
+      ImageSOA img(width, height);
+      for (std::size_t i = 0; i < N.size(); ++i) {
+        std::uint8_t const v = samples_level(N[i], max_n);
+        img.R[i]             = v;
+        img.G[i]             = v;
+        img.B[i]             = v;
+      }
+      return img;
+    }
+
+    // Media + gamma + cuantización plano a plano (ImageSOA::plane): los inversos de las
+    // cuentas una vez, y por canal la media del plano entero y GammaLut::resolve sobre él
+    [[nodiscard]] ImageSOA resolve(GammaLut const & lut) const {
+      ImageSOA img(width, height);
+      std::vector<float> inv(N.size());
+      for (std::size_t i = 0; i < N.size(); ++i) {
+        inv[i] = (N[i] > 0U) ? 1.0F / static_cast<float>(N[i]) : 0.0F;
+      }
+      std::array<std::vector<float> const *, 3> const sums{&R, &G, &B};
+      std::vector<float> mean(N.size());
+      for (int c = 0; c < 3; ++c) {
+        std::vector<float> const & sum = *sums[static_cast<std::size_t>(c)];
+        for (std::size_t i = 0; i < mean.size(); ++i) {
+          mean[i] = sum[i] * inv[i];
+        }
+        lut.resolve(mean, img.plane(c));
+      }
+      return img;
+    }
+  };
+
+}  // namespace render
@@ -2,8 +2,13 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <span>
+#include <string>
 #include <vector>
 
+#include "render/ppm.hpp"
+#include "render/qoi.hpp"
+
 namespace render {
 
   struct ImageSOA {
@@ -45,6 +50,26 @@ namespace render {
     void set01(int x, int y, double r, double g, double b) {
       set(x, y, clamp01_to_u8(r), clamp01_to_u8(g), clamp01_to_u8(b));
     }
+
+    // Canal c entero (0 = R, 1 = G, 2 = B): por aquí lo llena FramebufferSOA::resolve
+    std::span<uint8_t> plane(int c) { return (c == 0) ? R : (c == 1) ? G : B; }
+
+    std::span<uint8_t const> plane(int c) const { return (c == 0) ? R : (c == 1) ? G : B; }
   };
 
+  // Imagen entera en un solo write (intercala los tres planos en memoria)
+  inline bool write_ppm(std::string const & path, ImageSOA const & img,
+                        PpmFormat format = PpmFormat::P6) {
+    return write_ppm(path, img.width, img.height, img.R, img.G, img.B, format);
+  }
+
+  // Según la extensión: ".qoi" en QOI (intercalando los planos al vuelo), el resto en PPM
+  inline bool write_image(std::string const & path, ImageSOA const & img,
+                          PpmFormat format = PpmFormat::P6) {
+    if (has_qoi_extension(path)) {
+      return write_qoi(path, img.width, img.height, img.R, img.G, img.B);
+    }
+    return write_ppm(path, img, format);
+  }
+
 }  // namespace render
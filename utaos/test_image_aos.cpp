@@ -1,5 +1,37 @@
+#include "render/bvh.hpp"
+#include "render/checkpoint.hpp"
+#include "render/compiled_scene.hpp"
+#include "render/config.hpp"
+#include "render/framebuffer_aos.hpp"
+#include "render/framebuffer_soa.hpp"
 #include "render/image_aos.hpp"
+#include "render/parser.hpp"
+#include "render/progressive.hpp"
+#include "render/qoi.hpp"
+#include "render/render_image.hpp"
+#include "render/settings.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <iterator>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+  std::string tmp_file(char const * name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+  }
+
+  std::string read_all(std::string const & path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  }
+
+}  // namespace
 
 TEST(image_aos_basic, set_get_u8) {
   render::ImageAOS img(4, 3);
@@ -20,3 +52,232 @@ TEST(image_aos_basic, set01_clamps) {
   EXPECT_EQ(g, 255);
   EXPECT_EQ(b, 64);
 }
+
+TEST(image_aos_basic, write_ppm_p6_is_raw_pixels) {
+  render::ImageAOS img(2, 1);
+  img.set(0, 0, 1, 2, 3);
+  img.set(1, 0, 250, 251, 252);
+  ASSERT_TRUE(render::write_ppm("/tmp/img_aos.ppm", img));
+  std::ifstream in("/tmp/img_aos.ppm", std::ios::binary);
+  std::string const s{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  EXPECT_EQ(s, std::string("P6\n2 1\n255\n\x01\x02\x03\xfa\xfb\xfc", 17));
+}
+
+TEST(image_aos_basic, framebuffer_resolves_once_with_gamma) {
+  render::FramebufferAOS fb(2, 1);
+  fb.add(0, 0, 0.0F, 0.5F, 1.0F);
+  fb.add(1, 0, -3.0F, 0.25F, 8.0F);  // HDR: el recorte lo hace resolve
+  render::ImageAOS const img = fb.resolve(render::GammaLut{2.2});
+  std::uint8_t r, g, b;
+  img.get(0, 0, r, g, b);
+  EXPECT_EQ(r, 0);
+  EXPECT_EQ(g, 186);
+  EXPECT_EQ(b, 255);
+  img.get(1, 0, r, g, b);
+  EXPECT_EQ(r, 0);
+  EXPECT_EQ(g, render::gamma_encode_exact(0.25, 2.2));
+  EXPECT_EQ(b, 255);
+}
+
+TEST(image_aos_basic, framebuffer_accumulates_sums_and_counts) {
+  render::FramebufferAOS fb(3, 2);
+  EXPECT_EQ(fb.samples(2, 1), 0);
+  fb.add(2, 1, 0.25F, 1.0F, 0.0F);
+  fb.add(2, 1, 0.75F, 3.0F, 0.5F, 3);  // suma de 3 muestras de otra pasada
+  EXPECT_EQ(fb.samples(2, 1), 4);
+  float r{}, g{}, b{};
+  fb.mean(2, 1, r, g, b);
+  EXPECT_FLOAT_EQ(r, 0.25F);
+  EXPECT_FLOAT_EQ(g, 1.0F);
+  EXPECT_FLOAT_EQ(b, 0.125F);
+  fb.mean(0, 0, r, g, b);  // sin muestras -> negro
+  EXPECT_EQ(r, 0.0F);
+  fb.clear();
+  EXPECT_EQ(fb.samples(2, 1), 0);
+}
+
+TEST(image_aos_basic, framebuffer_samples_debug_image) {
+  render::FramebufferAOS fb(3, 1);
+  fb.add(0, 0, 0.0F, 0.0F, 0.0F, 4U);
+  fb.add(1, 0, 0.0F, 0.0F, 0.0F, 8U);
+  fb.add(2, 0, 0.0F, 0.0F, 0.0F, 16U);  // por encima del máximo -> blanco
+  EXPECT_EQ(fb.total_samples(), 28U);
+  auto const img = fb.samples_image(8U);
+  EXPECT_EQ(img.data[0].r, 128);
+  EXPECT_EQ(img.data[0].b, 128);
+  EXPECT_EQ(img.data[1].g, 255);
+  EXPECT_EQ(img.data[2].r, 255);
+}
+
+// Las dos disposiciones dan la misma imagen de muestras, también con un máximo que no es
+// potencia de dos (14: n = 7 cae justo en 127.5)
+TEST(image_aos_basic, samples_image_matches_soa) {
+  std::uint32_t const max_n = 14U;
+  render::FramebufferAOS aos(max_n + 3U, 2);
+  render::FramebufferSOA soa(max_n + 3U, 2);
+  for (int x = 0; x < aos.width; ++x) {
+    auto const n = static_cast<std::uint32_t>(x);
+    aos.add(x, 1, 0.0F, 0.0F, 0.0F, n);
+    soa.add(x, 1, 0.0F, 0.0F, 0.0F, n);
+  }
+  EXPECT_EQ(aos.total_samples(), soa.total_samples());
+  render::ImageAOS const a = aos.samples_image(max_n);
+  render::ImageSOA const s = soa.samples_image(max_n);
+  for (int y = 0; y < aos.height; ++y) {
+    for (int x = 0; x < aos.width; ++x) {
+      std::uint8_t r0, g0, b0, r1, g1, b1;
+      a.get(x, y, r0, g0, b0);
+      s.get(x, y, r1, g1, b1);
+      EXPECT_EQ(r0, r1) << x << ", " << y;
+      EXPECT_EQ(b0, b1) << x << ", " << y;
+    }
+  }
+  std::uint8_t r, g, b;
+  a.get(7, 1, r, g, b);
+  EXPECT_EQ(r, 128);
+}
+
+// Parar a mitad, guardar, cargar en un framebuffer nuevo y seguir da los mismos bits que no
+// haber parado
+TEST(image_aos_basic, framebuffer_checkpoint_resume_is_exact) {
+  auto sample = [](int x, int y, std::uint32_t i) {
+    return render::vector{0.1 * x + 0.37 * i, 0.01 * y, 1.0 / (1.0 + i)};
+  };
+  auto ignore = [](render::ProgressiveStats const &) { };
+  render::TileOptions const tiles{8, 2};
+  std::string const path =
+      (std::filesystem::temp_directory_path() / "render_aos_resume.ckpt").string();
+
+  render::FramebufferAOS once(21, 13);
+  (void) render::render_progressive(once, tiles, {0.0, 7U}, sample, ignore, ignore);
+
+  render::FramebufferAOS first(21, 13);
+  (void) render::render_progressive(first, tiles, {0.0, 3U}, sample, ignore, ignore);
+  std::string err;
+  ASSERT_TRUE(render::save_checkpoint(path, 5U, first, &err)) << err;
+
+  render::FramebufferAOS resumed(21, 13);
+  EXPECT_FALSE(render::load_checkpoint(path, 6U, resumed, &err));
+  ASSERT_TRUE(render::load_checkpoint(path, 5U, resumed, &err)) << err;
+  EXPECT_EQ(resumed.total_samples(), first.total_samples());
+  (void) render::render_progressive(resumed, tiles, {0.0, 7U}, sample, ignore, ignore);
+  for (std::size_t i = 0; i < once.data.size(); ++i) {
+    EXPECT_EQ(resumed.data[i].r, once.data[i].r);
+    EXPECT_EQ(resumed.data[i].b, once.data[i].b);
+    EXPECT_EQ(resumed.data[i].n, once.data[i].n);
+  }
+  std::filesystem::remove(path);
+}
+
+// Con extensión .qoi write_image escribe QOI (desde las filas) y si no, PPM
+TEST(image_aos_basic, write_image_by_extension) {
+  render::ImageAOS img(3, 2);
+  img.set(0, 0, 1, 2, 3);
+  img.set(2, 1, 250, 251, 252);
+  std::string const qoi = tmp_file("render_aos_img.qoi");
+  std::string const ppm = tmp_file("render_aos_img.ppm");
+  ASSERT_TRUE(render::write_image(qoi, img));
+  ASSERT_TRUE(render::write_image(ppm, img));
+  EXPECT_EQ(read_all(ppm).substr(0, 2), "P6");
+
+  std::string const text = read_all(qoi);
+  std::vector<std::uint8_t> const bytes(text.begin(), text.end());
+  auto const back = render::decode_qoi(bytes);
+  ASSERT_TRUE(back.has_value());
+  ASSERT_EQ(back->rgb.size(), 18U);
+  for (int y = 0; y < 2; ++y) {
+    for (int x = 0; x < 3; ++x) {
+      std::uint8_t r, g, b;
+      img.get(x, y, r, g, b);
+      auto const i = static_cast<std::size_t>(3 * (y * 3 + x));
+      EXPECT_EQ(back->rgb[i], r);
+      EXPECT_EQ(back->rgb[i + 1], g);
+      EXPECT_EQ(back->rgb[i + 2], b);
+    }
+  }
+  std::filesystem::remove(qoi);
+  std::filesystem::remove(ppm);
+}
+
+// Acceso directo por filas (el que usa FramebufferAOS::resolve)
+TEST(image_aos_basic, row_is_one_row_of_interleaved_pixels) {
+  render::ImageAOS img(3, 2);
+  std::span<std::uint8_t> const row = img.row(1);
+  ASSERT_EQ(row.size(), 9U);
+  row[3] = 10;
+  row[4] = 20;
+  row[5] = 30;
+  std::uint8_t r, g, b;
+  img.get(1, 1, r, g, b);
+  EXPECT_EQ(r, 10);
+  EXPECT_EQ(g, 20);
+  EXPECT_EQ(b, 30);
+  EXPECT_EQ(std::as_const(img).row(1).data(), row.data());
+}
+
+static_assert(render::Image<render::ImageAOS>);
+static_assert(render::RowImage<render::ImageAOS>);
+static_assert(render::FramebufferFor<render::FramebufferAOS, render::ImageAOS>);
+
+// El kernel común instanciado con esta disposición: con pasadas o de una vez, todas las
+// muestras acaban en el framebuffer y la imagen devuelta es su resolución
+TEST(image_aos_basic, render_image_fills_framebuffer) {
+  std::string err;
+  auto const scn = render::try_parse_scene_text("matte red color 0.8 0.2 0.2\n"
+                                                "sphere a 0 0 -1 0.5 red\n",
+                                                "scene", &err);
+  ASSERT_TRUE(scn.has_value()) << err;
+  render::CompiledScene const cs = render::CompiledScene::compile(*scn);
+  render::Bvh const bvh          = render::Bvh::build(cs);
+  render::Config cfg;
+  cfg.width             = 12;
+  cfg.height            = 7;
+  cfg.samples_per_pixel = 3;
+  render::RenderSettings const settings =
+      render::resolve_settings(cfg, [](char const *) -> char const * { return nullptr; });
+  render::camera const cam = settings.make_camera();
+  render::RenderJob const job{cs, bvh, cam, settings};
+
+  int checkpoints = 0;
+  auto ignore     = [](render::ProgressiveStats const &) { };
+  auto count      = [&](render::ProgressiveStats const &) { ++checkpoints; };
+  for (bool const progressive : {false, true}) {
+    render::FramebufferAOS fb(12, 7);
+    render::ImageAOS const img =
+        render::render_image<render::ImageAOS>(fb, job, progressive, ignore, count);
+    EXPECT_EQ(fb.total_samples(), 12 * 7 * 3);
+    ASSERT_EQ(img.width, 12);
+    ASSERT_EQ(img.height, 7);
+    render::ImageAOS const ref = fb.resolve(render::GammaLut{settings.gamma});
+    for (int y = 0; y < 7; ++y) {
+      for (int x = 0; x < 12; ++x) {
+        std::uint8_t r0, g0, b0, r1, g1, b1;
+        img.get(x, y, r0, g0, b0);
+        ref.get(x, y, r1, g1, b1);
+        EXPECT_EQ(r0, r1);
+        EXPECT_EQ(g0, g1);
+        EXPECT_EQ(b0, b1);
+      }
+    }
+    if (progressive) {
+      continue;
+    }
+
+    // Por bandas, sin framebuffer: el mismo fichero
+    std::string const whole  = tmp_file("render_aos_whole.ppm");
+    std::string const banded = tmp_file("render_aos_banded.ppm");
+    ASSERT_TRUE(render::write_ppm(whole, img, settings.format));
+    render::RenderSettings streamed = settings;
+    streamed.stream_rows            = 3;
+    render::BandStats bands;
+    double samples{};
+    ASSERT_TRUE(render::render_streamed({cs, bvh, cam, streamed}, banded, &bands, &samples));
+    EXPECT_EQ(bands.bands, 3U);
+    EXPECT_EQ(samples, 12 * 7 * 3);
+    EXPECT_EQ(read_all(banded), read_all(whole));
+    std::filesystem::remove(whole);
+    std::filesystem::remove(banded);
+  }
+  // Sin plazo no hay checkpoint final
+  EXPECT_EQ(checkpoints, 0);
+}
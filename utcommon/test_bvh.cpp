@@ -0,0 +1,86 @@
+#include "render/bvh.hpp"
+#include "render/compiled_scene.hpp"
+#include "render/rng.hpp"
+#include "render/scene.hpp"
+#include <gtest/gtest.h>
+
+namespace {
+
+  // Escena aleatoria reproducible con esferas y cilindros en un cubo [-10, 10]^3
+  render::Scene random_scene(std::size_t n_sph, std::size_t n_cyl, std::uint64_t seed) {
+    render::counter_rng rng{seed, 0, 0, 0};
+    auto u = [&](double lo, double hi) { return lo + (hi - lo) * rng.next01(); };
+
+    render::Scene scn;
+    for (std::size_t i = 0; i < n_sph; ++i) {
+      render::Sphere s;
+      s.center = {u(-10, 10), u(-10, 10), u(-10, 10)};
+      s.radius = u(0.1, 1.0);
+      scn.spheres.push_back(s);
+    }
+    for (std::size_t i = 0; i < n_cyl; ++i) {
+      render::Cylinder c;
+      c.base   = {u(-10, 10), u(-10, 10), u(-10, 10)};
+      c.axis   = render::vector{u(-1, 1), u(-1, 1), u(-1, 1)}.normalized();
+      c.height = u(0.2, 2.0);
+      c.radius = u(0.1, 0.8);
+      scn.cylinders.push_back(c);
+    }
+    return scn;
+  }
+
+}  // namespace
+
+TEST(Bvh, EmptySceneNeverHits) {
+  auto const scn = render::CompiledScene::compile(render::Scene{});
+  auto const bvh = render::Bvh::build(scn);
+  EXPECT_EQ(bvh.node_count(), 0U);
+  render::Hit h;
+  EXPECT_FALSE(bvh.closest_hit(scn, render::ray{{0, 0, 0}, {0, 0, -1}}, 1e-6, 1e9, &h));
+}
+
+TEST(Bvh, CylinderBoundsContainCaps) {
+  render::Cylinder c;
+  c.base   = {1, 2, 3};
+  c.axis   = {0, 1, 0};
+  c.height = 2.0;
+  c.radius = 0.5;
+  auto const b = render::bounds_of(c);
+  EXPECT_NEAR(b.lo.x, 0.5, 1e-12);
+  EXPECT_NEAR(b.hi.x, 1.5, 1e-12);
+  EXPECT_NEAR(b.lo.y, 2.0, 1e-12);  // eje Y: sin extensión radial en y
+  EXPECT_NEAR(b.hi.y, 4.0, 1e-12);
+  EXPECT_NEAR(b.lo.z, 2.5, 1e-12);
+  EXPECT_NEAR(b.hi.z, 3.5, 1e-12);
+}
+
+TEST(Bvh, MatchesLinearScan) {
+  auto const scn = render::CompiledScene::compile(random_scene(500, 200, 11ULL));
+  auto const bvh = render::Bvh::build(scn);
+  EXPECT_EQ(bvh.prim_count(), 700U);
+
+  render::counter_rng rng{3ULL, 1, 2, 3};
+  auto u    = [&](double lo, double hi) { return lo + (hi - lo) * rng.next01(); };
+  int found = 0;
+  for (int i = 0; i < 2'000; ++i) {
+    render::ray const r{
+      {u(-15, 15), u(-15, 15), u(-15, 15)},
+      render::vector{u(-1, 1), u(-1, 1), u(-1, 1)}
+      .normalized()
+    };
+    render::Hit a, b;
+    bool const ha = render::closest_hit_linear(scn, r, 1e-6, 1e9, &a);
+    bool const hb = bvh.closest_hit(scn, r, 1e-6, 1e9, &b);
+    ASSERT_EQ(ha, hb) << "ray " << i;
+    if (ha) {
+      ++found;
+      EXPECT_EQ(a.t, b.t);
+      EXPECT_EQ(a.kind, b.kind);
+      EXPECT_EQ(a.index, b.index);
+      EXPECT_EQ(a.normal.x, b.normal.x);
+      EXPECT_EQ(a.normal.y, b.normal.y);
+      EXPECT_EQ(a.normal.z, b.normal.z);
+    }
+  }
+  EXPECT_GT(found, 100);  // el test solo vale si hay bastantes impactos
+}
@@ -198,3 +198,42 @@ TEST(Camera, CornerRays_ExecuteBranches) {
   (void) cam.get_ray(0, 0, 0);
   (void) cam.get_ray(63, 47, 0);
 }
+
+// get_ray no tiene estado: la misma muestra da el mismo rayo sin importar el orden de llamadas.
+TEST(Camera, GetRay_IsOrderIndependent) {
+  render::camera const cam{
+    64, 48, 40.0, {0, 0, 1},
+       {0, 0, 0},
+       {0, 1, 0},
+       4U, 99ULL, 0.2, 1.0
+  };
+  auto const a0 = cam.get_ray(5, 6, 3);
+  (void) cam.get_ray(1, 1, 0);
+  (void) cam.get_ray(5, 6, 2);
+  auto const a1 = cam.get_ray(5, 6, 3);
+  EXPECT_EQ(a0.origin.x, a1.origin.x);
+  EXPECT_EQ(a0.origin.y, a1.origin.y);
+  EXPECT_EQ(a0.direction.x, a1.direction.x);
+  EXPECT_EQ(a0.direction.y, a1.direction.y);
+  EXPECT_EQ(a0.direction.z, a1.direction.z);
+}
+
+TEST(Camera, GetRay_DependsOnSeedAndPixel) {
+  render::camera const c1{
+    64, 48, 40.0, {0, 0, 1},
+       {0, 0, 0},
+       {0, 1, 0},
+       1U, 1ULL
+  };
+  render::camera const c2{
+    64, 48, 40.0, {0, 0, 1},
+       {0, 0, 0},
+       {0, 1, 0},
+       1U, 2ULL
+  };
+  EXPECT_NE(c1.get_ray(8, 8, 0).direction.x, c2.get_ray(8, 8, 0).direction.x);
+  // Mismo píxel desplazado: el jitter no debe repetirse entre píxeles vecinos
+  auto const d0 = c1.get_ray(8, 8, 0).direction - c1.get_ray(9, 8, 0).direction;
+  auto const d1 = c1.get_ray(9, 8, 0).direction - c1.get_ray(10, 8, 0).direction;
+  EXPECT_NE(d0.x, d1.x);
+}
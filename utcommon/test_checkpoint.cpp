@@ -0,0 +1,128 @@
+#include "render/checkpoint.hpp"
+#include "render/config.hpp"
+#include "render/hash.hpp"
+#include "render/settings.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+
+  std::string tmp_path(char const * name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+  }
+
+  // Dos "planos" como los de un framebuffer SoA
+  struct Planes {
+    std::vector<float> sums;
+    std::vector<std::uint32_t> counts;
+
+    std::array<std::span<std::byte const>, 2> bytes() const {
+      return {std::as_bytes(std::span{sums}), std::as_bytes(std::span{counts})};
+    }
+
+    std::array<std::span<std::byte>, 2> bytes() {
+      return {std::as_writable_bytes(std::span{sums}), std::as_writable_bytes(std::span{counts})};
+    }
+  };
+
+  render::RenderSettings settings_for(render::Config const & cfg) {
+    return render::resolve_settings(cfg, [](char const *) -> char const * { return nullptr; });
+  }
+
+}  // namespace
+
+TEST(Checkpoint, RoundTripsEveryByte) {
+  std::string const path = tmp_path("render_ckpt_roundtrip.ckpt");
+  render::CheckpointKey const key{7U, 0x1234'5678'9ABC'DEF0ULL, 3, 2};
+  Planes const a{
+    {0.5F, -1.25F, 3.0e-8F, 1e30F, 0.0F, 7.0F},
+    {1U, 2U, 3U, 4U, 5U, 0xFFFF'FFFFU}
+  };
+  std::string err;
+  ASSERT_TRUE(render::write_checkpoint(path, key, a.bytes(), &err)) << err;
+  EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+  EXPECT_EQ(std::filesystem::file_size(path), sizeof(render::CheckpointHeader) + 6U * 8U);
+
+  Planes b{std::vector<float>(6), std::vector<std::uint32_t>(6)};
+  ASSERT_TRUE(render::read_checkpoint(path, key, b.bytes(), &err)) << err;
+  EXPECT_EQ(b.sums, a.sums);
+  EXPECT_EQ(b.counts, a.counts);
+  std::filesystem::remove(path);
+}
+
+TEST(Checkpoint, RejectsMismatchesAndBrokenFiles) {
+  std::string const path = tmp_path("render_ckpt_bad.ckpt");
+  render::CheckpointKey const key{1U, 99U, 2, 2};
+  Planes const a{std::vector<float>(4, 1.0F), std::vector<std::uint32_t>(4, 3U)};
+  std::string err;
+  ASSERT_TRUE(render::write_checkpoint(path, key, a.bytes(), &err)) << err;
+
+  Planes b{std::vector<float>(4), std::vector<std::uint32_t>(4)};
+  for (auto other : {
+         render::CheckpointKey{2U, 99U, 2, 2},
+         render::CheckpointKey{1U, 98U, 2, 2},
+         render::CheckpointKey{1U, 99U, 4, 1}
+  }) {
+    EXPECT_FALSE(render::read_checkpoint(path, other, b.bytes(), &err));
+    EXPECT_NE(err.find("does not match"), std::string::npos) << err;
+  }
+
+  // Cortado a mitad de los datos
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 5U);
+  EXPECT_FALSE(render::read_checkpoint(path, key, b.bytes(), &err));
+  EXPECT_NE(err.find("is truncated"), std::string::npos) << err;
+
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << "P3\n2 2\n255\n";
+  }
+  EXPECT_FALSE(render::read_checkpoint(path, key, b.bytes(), &err));
+  EXPECT_NE(err.find("is not a checkpoint"), std::string::npos) << err;
+  std::filesystem::remove(path);
+
+  EXPECT_FALSE(render::read_checkpoint(path, key, b.bytes(), &err));
+  EXPECT_NE(err.find("cannot open checkpoint"), std::string::npos) << err;
+}
+
+// La huella cambia con lo que cambia las muestras y no con lo que solo cambia la salida
+TEST(Checkpoint, FingerprintCoversSampleInputsOnly) {
+  render::Config cfg;
+  auto const base = render::checkpoint_fingerprint(settings_for(cfg), 1U);
+  EXPECT_EQ(render::checkpoint_fingerprint(settings_for(cfg), 1U), base);
+  EXPECT_NE(render::checkpoint_fingerprint(settings_for(cfg), 2U), base);
+
+  auto changed = [&](auto && edit) {
+    render::Config c = cfg;
+    edit(c);
+    return render::checkpoint_fingerprint(settings_for(c), 1U) != base;
+  };
+  EXPECT_TRUE(changed([](render::Config & c) { c.samples_per_pixel = 8; }));
+  EXPECT_TRUE(changed([](render::Config & c) { c.seed = 43; }));
+  EXPECT_TRUE(changed([](render::Config & c) { c.sampler = render::SamplerKind::R2; }));
+  EXPECT_TRUE(changed([](render::Config & c) { c.lookfrom.y = 0.25; }));
+  EXPECT_TRUE(changed([](render::Config & c) { c.max_depth = 9; }));
+  EXPECT_FALSE(changed([](render::Config & c) { c.gamma = 1.0; }));
+  EXPECT_FALSE(changed([](render::Config & c) { c.time_budget = 3.0; }));
+}
+
+TEST(Hash, FileHashFollowsContent) {
+  std::string const path = tmp_path("render_hash_file.txt");
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << "sphere: 0 0 0 1 m\n";
+  }
+  auto const h = render::hash_file(path);
+  ASSERT_TRUE(h.has_value());
+  EXPECT_EQ(*h, render::fnv1a64("sphere: 0 0 0 1 m\n"));
+  EXPECT_NE(*h, render::fnv1a64("sphere: 0 0 0 2 m\n"));
+  EXPECT_EQ(render::fnv1a64(""), render::fnv1a_basis);
+  std::filesystem::remove(path);
+  EXPECT_FALSE(render::hash_file(path).has_value());
+}
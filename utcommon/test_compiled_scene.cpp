@@ -0,0 +1,128 @@
+#include "render/compiled_scene.hpp"
+#include "render/hits.hpp"
+#include "render/scene.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+  render::Scene small_scene() {
+    render::Scene scn;
+    render::Material m;
+    m.name = "red";
+    scn.materials.push_back(m);
+    m.name = "blue";
+    scn.materials.push_back(m);
+
+    render::Sphere s;
+    s.center = {0, 0, -3};
+    s.radius = 0.5;
+    s.mat    = 1;  // "blue"
+    scn.spheres.push_back(s);
+    s.center = {1, 1, -4};
+    s.radius = 0.25;
+    s.mat    = render::no_material;  // legacy sin material
+    scn.spheres.push_back(s);
+
+    render::Cylinder c;
+    c.base   = {0, -1, -2};
+    c.axis   = {0, 2, 0};  // sin normalizar
+    c.height = 1.0;
+    c.radius = 0.3;
+    c.mat    = 0;  // "red"
+    scn.cylinders.push_back(c);
+    return scn;
+  }
+
+  bool aligned64(void const * p) {
+    return reinterpret_cast<std::uintptr_t>(p) % render::CompiledScene::alignment == 0;
+  }
+
+}  // namespace
+
+TEST(CompiledScene, PrecomputesSphereData) {
+  auto const cs = render::CompiledScene::compile(small_scene());
+  auto const & s = cs.spheres();
+  ASSERT_EQ(s.size(), 2U);
+  EXPECT_EQ(s.r2[0], 0.25);
+  EXPECT_EQ(s.inv_r[0], 2.0);
+  EXPECT_EQ(s.mat[0], 1U);
+  EXPECT_EQ(s.mat[1], render::no_material);
+}
+
+TEST(CompiledScene, PrecomputesCylinderCaps) {
+  auto const cs = render::CompiledScene::compile(small_scene());
+  auto const & c = cs.cylinders();
+  ASSERT_EQ(c.size(), 1U);
+  EXPECT_DOUBLE_EQ(c.axy[0], 1.0);  // eje normalizado
+  EXPECT_DOUBLE_EQ(c.p1y[0], 0.0);  // -1 + 1 * (0,1,0)
+  EXPECT_DOUBLE_EQ(c.r2[0], 0.09);
+  EXPECT_EQ(c.mat[0], 0U);
+}
+
+TEST(CompiledScene, ArraysAre64ByteAligned) {
+  auto const cs = render::CompiledScene::compile(small_scene());
+  EXPECT_TRUE(aligned64(cs.spheres().cx.data()));
+  EXPECT_TRUE(aligned64(cs.spheres().inv_r.data()));
+  EXPECT_TRUE(aligned64(cs.spheres().mat.data()));
+  EXPECT_TRUE(aligned64(cs.cylinders().p1z.data()));
+  EXPECT_TRUE(aligned64(cs.cylinders().mat.data()));
+  EXPECT_EQ(cs.bytes() % render::CompiledScene::alignment, 0U);
+}
+
+// El bloque es compartido (copias, caché proyectada): desde fuera solo se puede leer
+static_assert(std::is_same_v<decltype(render::SphereArrays{}.r2)::element_type, double const>);
+static_assert(
+    std::is_same_v<decltype(render::CylinderArrays{}.mat)::element_type, std::uint32_t const>);
+static_assert(std::is_same_v<decltype(std::declval<render::CompiledScene const &>().materials()),
+                             std::span<render::MaterialPre const>>);
+
+TEST(CompiledScene, EmptySceneHasNoStorage) {
+  auto const cs = render::CompiledScene::compile(render::Scene{});
+  EXPECT_EQ(cs.bytes(), 0U);
+  EXPECT_EQ(cs.spheres().size(), 0U);
+  EXPECT_EQ(cs.cylinders().size(), 0U);
+}
+
+// Las variantes precalculadas deben dar exactamente lo mismo que las originales
+TEST(CompiledScene, PrecomputedHitsMatchOriginalBitForBit) {
+  auto const scn = small_scene();
+  auto const cs  = render::CompiledScene::compile(scn);
+  render::ray const rays[] = {
+    {{0, 0, 0},         {0, 0, -1}                    },
+    {{0.1, 0.2, 0},     render::vector{0, -0.3, -1}.normalized()},
+    {{0, -0.5, 0},      render::vector{0.05, 0, -1}.normalized()},
+    {{0, -3, -2},       {0, 1, 0}                     },
+  };
+  for (auto const & r : rays) {
+    for (std::size_t i = 0; i < scn.spheres.size(); ++i) {
+      double t1{}, t2{};
+      render::vector n1, n2;
+      bool const h1 = render::hit_sphere(r, scn.spheres[i].center, scn.spheres[i].radius, 1e-6,
+                                         1e9, &t1, &n1);
+      bool const h2 = render::hit_sphere_pre(r, cs.spheres().center(i), cs.spheres().r2[i],
+                                             cs.spheres().inv_r[i], 1e-6, 1e9, &t2, &n2);
+      ASSERT_EQ(h1, h2);
+      if (h1) {
+        EXPECT_EQ(t1, t2);
+        EXPECT_EQ(n1.x, n2.x);
+        EXPECT_EQ(n1.y, n2.y);
+        EXPECT_EQ(n1.z, n2.z);
+      }
+    }
+    auto const & c = scn.cylinders[0];
+    double t1{}, t2{};
+    render::vector n1, n2;
+    bool const h1 =
+        render::hit_cylinder(r, c.base, c.axis, c.height, c.radius, 1e-6, 1e9, &t1, &n1);
+    bool const h2 = render::hit_cylinder_pre(r, cs.cylinders().pre(0), 1e-6, 1e9, &t2, &n2);
+    ASSERT_EQ(h1, h2);
+    if (h1) {
+      EXPECT_EQ(t1, t2);
+      EXPECT_EQ(n1.y, n2.y);
+    }
+  }
+}
@@ -41,3 +41,63 @@ TEST(ConfigParse, NewKeysHappy) {
   EXPECT_DOUBLE_EQ(c->lookfrom.z, 3.0);
   EXPECT_DOUBLE_EQ(c->gamma, 2.2);
 }
+
+TEST(ConfigParse, RouletteDepth) {
+  std::string err;
+  auto c = try_parse_config(write_cfg("max_depth 8\nrr_depth 2\n"), &err);
+  ASSERT_TRUE(c.has_value()) << err;
+  EXPECT_EQ(c->max_depth, 8);
+  EXPECT_EQ(c->rr_depth, 2);
+
+  c = try_parse_config(write_cfg("roulette_depth 0\n"), &err);
+  ASSERT_TRUE(c.has_value()) << err;
+  EXPECT_EQ(c->rr_depth, 0);
+
+  EXPECT_FALSE(try_parse_config(write_cfg("rr_depth -1\n"), &err).has_value());
+  EXPECT_NE(err.find("invalid value for 'rr_depth'"), std::string::npos) << err;
+  EXPECT_FALSE(try_parse_config(write_cfg("rr_depth x\n"), &err).has_value());
+  EXPECT_NE(err.find("invalid format for 'rr_depth'"), std::string::npos) << err;
+}
+
+TEST(ConfigParse, AdaptiveSampling) {
+  std::string err;
+  auto c = try_parse_config(write_cfg("max_spp 128\nmin_spp 8\nadaptive_threshold 0.03\n"), &err);
+  ASSERT_TRUE(c.has_value()) << err;
+  EXPECT_EQ(c->samples_per_pixel, 128U);
+  EXPECT_EQ(c->min_samples, 8U);
+  EXPECT_DOUBLE_EQ(c->adaptive_threshold, 0.03);
+
+  EXPECT_FALSE(try_parse_config(write_cfg("min_samples 0\n"), &err).has_value());
+  EXPECT_NE(err.find("min_samples must be > 0"), std::string::npos) << err;
+  EXPECT_FALSE(try_parse_config(write_cfg("adaptive_threshold -0.1\n"), &err).has_value());
+  EXPECT_NE(err.find("invalid value for 'adaptive_threshold'"), std::string::npos) << err;
+}
+
+TEST(ConfigParse, Sampler) {
+  std::string err;
+  auto c = try_parse_config(write_cfg("sampler r2\n"), &err);
+  ASSERT_TRUE(c.has_value()) << err;
+  EXPECT_EQ(c->sampler, SamplerKind::R2);
+  EXPECT_EQ(Config{}.sampler, SamplerKind::Sobol);
+
+  EXPECT_FALSE(try_parse_config(write_cfg("sampler halton\n"), &err).has_value());
+  EXPECT_NE(err.find("invalid value for 'sampler'"), std::string::npos) << err;
+}
+
+TEST(ConfigParse, ProgressiveKeys) {
+  std::string err;
+  auto c = try_parse_config(
+      write_cfg("time_budget 2.5\npreview_every 0.5\ncheckpoint_interval 60\n"), &err);
+  ASSERT_TRUE(c.has_value()) << err;
+  EXPECT_DOUBLE_EQ(c->time_budget, 2.5);
+  EXPECT_DOUBLE_EQ(c->preview_interval, 0.5);
+  EXPECT_DOUBLE_EQ(c->checkpoint_interval, 60.0);
+  EXPECT_EQ(Config{}.time_budget, 0.0);
+
+  EXPECT_FALSE(try_parse_config(write_cfg("time_budget -1\n"), &err).has_value());
+  EXPECT_NE(err.find("invalid value for 'time_budget'"), std::string::npos) << err;
+  EXPECT_FALSE(try_parse_config(write_cfg("preview_interval soon\n"), &err).has_value());
+  EXPECT_NE(err.find("invalid format for 'preview_interval'"), std::string::npos) << err;
+  EXPECT_FALSE(try_parse_config(write_cfg("checkpoint_every -5\n"), &err).has_value());
+  EXPECT_NE(err.find("invalid value for 'checkpoint_interval'"), std::string::npos) << err;
+}
@@ -0,0 +1,94 @@
+#include "render/gamma.hpp"
+#include "render/rng.hpp"
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+
+namespace {
+
+  // Diferencia máxima (en niveles) entre la tabla y la referencia exacta
+  int max_error_near_thresholds(render::GammaLut const & lut) {
+    int worst = 0;
+    for (int k = 0; k <= 256; ++k) {
+      // Barrido fino alrededor de cada posible umbral: k/255 en el espacio codificado
+      double const center = std::pow(std::min(k / 255.0, 1.0), lut.gamma());
+      auto const bits     = std::bit_cast<std::uint32_t>(static_cast<float>(center));
+      for (std::uint32_t d = 0; d < 64; ++d) {
+        for (std::uint32_t const b : {bits - 32 + d, bits + d}) {
+          float const v = std::bit_cast<float>(b);
+          int const err = std::abs(int{lut(v)} - int{render::gamma_encode_exact(v, lut.gamma())});
+          worst         = std::max(worst, err);
+        }
+      }
+    }
+    return worst;
+  }
+
+}  // namespace
+
+TEST(GammaLut, ExactAroundEveryLevelBoundary) {
+  for (double const g : {2.2, 2.0, 1.0, 0.45, 3.0}) {
+    render::GammaLut const lut{g};
+    EXPECT_EQ(max_error_near_thresholds(lut), 0) << "gamma " << g;
+  }
+}
+
+TEST(GammaLut, ExactOnRandomValues) {
+  render::GammaLut const lut{2.2};
+  render::counter_rng rng{4ULL, 0, 0, 0};
+  int worst = 0;
+  for (int i = 0; i < 1'000'000; ++i) {
+    // Mitad uniformes en [0, 1.2], mitad muy oscuros (donde la curva es más empinada)
+    double const u = rng.next01();
+    float const v  = (i % 2 == 0) ? static_cast<float>(1.2 * u) : static_cast<float>(u * u * u);
+    worst          = std::max(worst, std::abs(int{lut(v)} - int{render::gamma_encode_exact(v, 2.2)}));
+  }
+  EXPECT_EQ(worst, 0);
+}
+
+TEST(GammaLut, ClampsOutOfRangeAndNan) {
+  render::GammaLut const lut{2.2};
+  EXPECT_EQ(lut(-1.0F), 0);
+  EXPECT_EQ(lut(0.0F), 0);
+  EXPECT_EQ(lut(std::numeric_limits<float>::quiet_NaN()), 0);
+  EXPECT_EQ(lut(std::numeric_limits<float>::denorm_min()), 0);
+  EXPECT_EQ(lut(1.0F), 255);
+  EXPECT_EQ(lut(7.5F), 255);
+  EXPECT_EQ(lut(std::numeric_limits<float>::infinity()), 255);
+  EXPECT_EQ(render::GammaLut{-1.0}.gamma(), 2.2);  // igual que write_ppm_gamma
+}
+
+TEST(GammaLut, ResolveMapsEveryElement) {
+  render::GammaLut const lut{2.2};
+  std::vector<float> const in{0.0F, 0.25F, 0.5F, 1.0F, 2.0F};
+  std::vector<std::uint8_t> out(in.size(), 7);
+  lut.resolve(in, out);
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    EXPECT_EQ(out[i], render::gamma_encode_exact(in[i], 2.2));
+  }
+  EXPECT_EQ(out[2], 186);  // 0.5^(1/2.2) * 255 = 186.1
+}
+
+// Redondeo al más cercano con las mitades hacia arriba, también cuando n * 255 / max_n cae
+// justo en .5 (max_n = 14, n = 7), que es donde una versión en float se queda corta
+TEST(SamplesLevel, RoundsHalfUpInIntegers) {
+  EXPECT_EQ(render::samples_level(7U, 14U), 128);
+  EXPECT_EQ(render::samples_level(14U, 28U), 128);
+  EXPECT_EQ(render::samples_level(0U, 14U), 0);
+  EXPECT_EQ(render::samples_level(20U, 14U), 255);
+  EXPECT_EQ(render::samples_level(5U, 0U), 0);
+  EXPECT_EQ(render::samples_level(std::numeric_limits<std::uint32_t>::max(),
+                                  std::numeric_limits<std::uint32_t>::max()),
+            255);
+  int wrong = 0;
+  for (std::uint32_t max_n = 1; max_n <= 600; ++max_n) {
+    for (std::uint32_t n = 0; n <= max_n; ++n) {
+      auto const ref = static_cast<int>(std::floor(255.0L * n / max_n + 0.5L));
+      wrong         += static_cast<int>(render::samples_level(n, max_n) != ref);
+    }
+  }
+  EXPECT_EQ(wrong, 0);
+}
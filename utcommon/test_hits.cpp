@@ -1,7 +1,14 @@
+#include "render/compiled_scene.hpp"
 #include "render/hits.hpp"
+#include "render/hits_wide.hpp"
 #include "render/ray.hpp"
+#include "render/rng.hpp"
+#include "render/scene.hpp"
 #include "render/vector.hpp"
+#include <algorithm>
+#include <cstdint>
 #include <gtest/gtest.h>
+#include <vector>
 
 namespace {
 
@@ -9,6 +16,96 @@ namespace {
     return std::abs(a - b) < eps;
   }
 
+  // Esferas aleatorias (nº no múltiplo del ancho SIMD) y rayos que las atraviesan
+  render::Scene random_spheres(std::size_t n, std::uint64_t seed) {
+    render::counter_rng rng{seed, 0, 0, 0};
+    auto u = [&](double lo, double hi) { return lo + (hi - lo) * rng.next01(); };
+    render::Scene scn;
+    for (std::size_t i = 0; i < n; ++i) {
+      render::Sphere s;
+      s.center = {u(-4, 4), u(-4, 4), u(-4, 4)};
+      s.radius = u(0.2, 1.5);
+      scn.spheres.push_back(s);
+    }
+    return scn;
+  }
+
+  render::ray random_ray(render::counter_rng & rng) {
+    auto u = [&](double lo, double hi) { return lo + (hi - lo) * rng.next01(); };
+    return {
+      {u(-6, 6), u(-6, 6), u(-6, 6)},
+      render::vector{u(-1, 1), u(-1, 1), u(-1, 1)}
+      .normalized()
+    };
+  }
+
+  // Cilindros aleatorios (eje sin normalizar a propósito) entre las esferas
+  render::Scene random_cylinders(std::size_t n, std::uint64_t seed) {
+    render::counter_rng rng{seed, 0, 0, 0};
+    auto u = [&](double lo, double hi) { return lo + (hi - lo) * rng.next01(); };
+    render::Scene scn;
+    for (std::size_t i = 0; i < n; ++i) {
+      render::Cylinder c;
+      c.base   = {u(-4, 4), u(-4, 4), u(-4, 4)};
+      c.axis   = {u(-2, 2), u(-2, 2), u(-2, 2)};
+      c.height = u(0.3, 3.0);
+      c.radius = u(0.2, 1.2);
+      scn.cylinders.push_back(c);
+    }
+    return scn;
+  }
+
+  struct SeqHit {
+    bool hit{false};
+    double t{};
+    render::vector n;
+    std::uint32_t index{};
+  };
+
+  // Referencia: hit_sphere en orden, reduciendo t_max con cada impacto
+  SeqHit sequential(render::Scene const & scn, std::vector<std::uint32_t> const & ids,
+                    render::ray const & r, double t_min, double t_max) {
+    SeqHit out;
+    for (std::uint32_t const i : ids) {
+      double t{};
+      render::vector n;
+      auto const & s = scn.spheres[i];
+      if (render::hit_sphere(r, s.center, s.radius, t_min, t_max, &t, &n)) {
+        out   = {true, t, n, i};
+        t_max = t;
+      }
+    }
+    return out;
+  }
+
+  // Referencia: hit_cylinder en orden, reduciendo t_max con cada impacto
+  SeqHit sequential_cyl(render::Scene const & scn, std::vector<std::uint32_t> const & ids,
+                        render::ray const & r, double t_min, double t_max) {
+    SeqHit out;
+    for (std::uint32_t const i : ids) {
+      double t{};
+      render::vector n;
+      auto const & c = scn.cylinders[i];
+      if (render::hit_cylinder(r, c.base, c.axis, c.height, c.radius, t_min, t_max, &t, &n)) {
+        out   = {true, t, n, i};
+        t_max = t;
+      }
+    }
+    return out;
+  }
+
+  void expect_same(SeqHit const & ref, bool hit, double t, render::vector const & n,
+                   std::uint32_t index) {
+    ASSERT_EQ(ref.hit, hit);
+    if (hit) {
+      EXPECT_EQ(ref.t, t);
+      EXPECT_EQ(ref.n.x, n.x);
+      EXPECT_EQ(ref.n.y, n.y);
+      EXPECT_EQ(ref.n.z, n.z);
+      EXPECT_EQ(ref.index, index);
+    }
+  }
+
 }  // namespace
 
 //
@@ -226,3 +323,148 @@ TEST(Hits, CylinderLateral_TowardsX) {
   EXPECT_NEAR(n.y, 0.0, 1e-3);
   EXPECT_NEAR(n.z, 0.0, 1e-3);
 }
+
+// --- Kernel SIMD de esferas: bit a bit igual que hit_sphere en secuencia ---
+TEST(hits_spheres_wide, range_matches_sequential_hit_sphere) {
+  auto const scn = random_spheres(37, 5ULL);
+  auto const cs  = render::CompiledScene::compile(scn);
+  std::vector<std::uint32_t> all(scn.spheres.size());
+  for (std::uint32_t i = 0; i < all.size(); ++i) {
+    all[i] = i;
+  }
+  render::counter_rng rng{8ULL, 0, 0, 0};
+  int hits = 0;
+  for (int i = 0; i < 2'000; ++i) {
+    render::ray const r = random_ray(rng);
+    double t{};
+    render::vector n;
+    std::uint32_t idx{};
+    bool const h = render::hit_spheres_wide(cs.spheres(), 0, all.size(), r, 1e-3, 1e9, &t, &n,
+                                            &idx);
+    expect_same(sequential(scn, all, r, 1e-3, 1e9), h, t, n, idx);
+    hits += h ? 1 : 0;
+  }
+  EXPECT_GT(hits, 500);
+}
+
+TEST(hits_spheres_wide, ids_and_subrange_match_sequential) {
+  auto const scn = random_spheres(23, 6ULL);
+  auto const cs  = render::CompiledScene::compile(scn);
+  std::vector<std::uint32_t> const ids{17, 3, 3, 22, 9, 0, 11};  // desordenados y repetidos
+  std::vector<std::uint32_t> const sub{5, 6, 7, 8, 9, 10, 11, 12, 13};
+  render::counter_rng rng{9ULL, 0, 0, 0};
+  for (int i = 0; i < 1'000; ++i) {
+    render::ray const r = random_ray(rng);
+    double t{};
+    render::vector n;
+    std::uint32_t idx{};
+    bool h = render::hit_spheres_wide(cs.spheres(), ids, r, 1e-3, 1e9, &t, &n, &idx);
+    expect_same(sequential(scn, ids, r, 1e-3, 1e9), h, t, n, idx);
+    h = render::hit_spheres_wide(cs.spheres(), 5, 14, r, 1e-3, 1e9, &t, &n, &idx);
+    expect_same(sequential(scn, sub, r, 1e-3, 1e9), h, t, n, idx);
+  }
+}
+
+TEST(hits_spheres_wide, tie_keeps_last_and_tmin_selects_far_root) {
+  render::Scene scn;
+  render::Sphere s;
+  s.center = {0, 0, -5};
+  s.radius = 1.0;
+  scn.spheres.assign(5, s);  // cinco esferas iguales: gana la última
+  auto const cs = render::CompiledScene::compile(scn);
+  render::ray const r({0, 0, 0}, {0, 0, -1});
+  double t{};
+  render::vector n;
+  std::uint32_t idx{};
+  ASSERT_TRUE(render::hit_spheres_wide(cs.spheres(), 0, 5, r, 1e-3, 1e9, &t, &n, &idx));
+  EXPECT_EQ(idx, 4U);
+  EXPECT_TRUE(approx(t, 4.0));
+  ASSERT_TRUE(render::hit_spheres_wide(cs.spheres(), 0, 5, r, 5.0, 1e9, &t, &n, &idx));
+  EXPECT_TRUE(approx(t, 6.0));
+  EXPECT_TRUE(approx(n.z, -1.0));
+  EXPECT_FALSE(render::hit_spheres_wide(cs.spheres(), 0, 5, r, 1e-3, 3.0, &t, &n, &idx));
+  EXPECT_FALSE(render::hit_spheres_wide(cs.spheres(), 2, 2, r, 1e-3, 1e9, &t, &n, &idx));
+}
+
+// --- Kernel SIMD de cilindros: bit a bit igual que hit_cylinder en secuencia ---
+TEST(hits_cylinders_wide, matches_sequential_hit_cylinder) {
+  auto const scn = random_cylinders(29, 12ULL);
+  auto const cs  = render::CompiledScene::compile(scn);
+  std::vector<std::uint32_t> all(scn.cylinders.size());
+  for (std::uint32_t i = 0; i < all.size(); ++i) {
+    all[i] = i;
+  }
+  std::vector<std::uint32_t> const ids{28, 4, 4, 13, 0, 7};
+  render::counter_rng rng{13ULL, 0, 0, 0};
+  int hits = 0;
+  for (int i = 0; i < 3'000; ++i) {
+    render::ray const r = random_ray(rng);
+    double t{};
+    render::vector n;
+    std::uint32_t idx{};
+    bool h = render::hit_cylinders_wide(cs.cylinders(), 0, all.size(), r, 1e-3, 1e9, &t, &n,
+                                        &idx);
+    expect_same(sequential_cyl(scn, all, r, 1e-3, 1e9), h, t, n, idx);
+    hits += h ? 1 : 0;
+    h = render::hit_cylinders_wide(cs.cylinders(), ids, r, 1e-3, 1e9, &t, &n, &idx);
+    expect_same(sequential_cyl(scn, ids, r, 1e-3, 1e9), h, t, n, idx);
+  }
+  EXPECT_GT(hits, 500);
+}
+
+TEST(hits_cylinders_wide, caps_and_lateral_match_scalar) {
+  render::Scene scn;
+  render::Cylinder c;
+  c.base   = {0, 0, 0};
+  c.axis   = {0, 0, 1};
+  c.height = 4.0;
+  c.radius = 1.0;
+  scn.cylinders.push_back(c);
+  auto const cs = render::CompiledScene::compile(scn);
+  std::vector<std::uint32_t> const one{0};
+
+  render::ray const rays[] = {
+    {{0.2, 0.1, -3}, {0, 0, 1}         }, // tapa inferior, paralelo al eje
+    {{0.2, 0.1, 9},  {0, 0, -1}        }, // tapa superior
+    {{2, 0, 2},      {-1, 0, 0}        }, // lateral
+    {{0.5, 0, 2},    {1, 0, 0}         }, // desde dentro
+    {{3, 0, 2},      {0, 0, 1}         }, // paralelo y fuera: falla
+    {{0, 0, 2},      {0, 0.6, 0.8}     }, // desde dentro hacia la tapa superior
+  };
+  for (auto const & r : rays) {
+    for (double const t_min : {1e-3, 2.5}) {
+      double t{};
+      render::vector n;
+      std::uint32_t idx{};
+      bool const h =
+          render::hit_cylinders_wide(cs.cylinders(), 0, 1, r, t_min, 1e9, &t, &n, &idx);
+      expect_same(sequential_cyl(scn, one, r, t_min, 1e9), h, t, n, idx);
+    }
+  }
+}
+
+TEST(hits_cylinders_wide, ties_follow_scalar_order) {
+  render::Scene scn;
+  render::Cylinder c;
+  c.base   = {0, 0, 0};
+  c.axis   = {0, 0, 1};
+  c.height = 4.0;
+  c.radius = 1.0;
+  scn.cylinders.assign(5, c);
+  auto const cs = render::CompiledScene::compile(scn);
+  double t{};
+  render::vector n;
+  std::uint32_t idx{};
+
+  // Lateral: cada cilindro igual sustituye al anterior (t <= mejor) -> gana el último
+  render::ray const side({3, 0, 2}, {-1, 0, 0});
+  ASSERT_TRUE(render::hit_cylinders_wide(cs.cylinders(), 0, 5, side, 1e-3, 1e9, &t, &n, &idx));
+  EXPECT_EQ(idx, 4U);
+  EXPECT_TRUE(approx(t, 2.0));
+
+  // Tapa: exige t < mejor -> se queda el primero
+  render::ray const cap({0.1, 0, -2}, {0, 0, 1});
+  ASSERT_TRUE(render::hit_cylinders_wide(cs.cylinders(), 0, 5, cap, 1e-3, 1e9, &t, &n, &idx));
+  EXPECT_EQ(idx, 0U);
+  EXPECT_TRUE(approx(n.z, -1.0));
+}
@@ -0,0 +1,165 @@
+#include "render/bvh.hpp"
+#include "render/compiled_scene.hpp"
+#include "render/kernel.hpp"
+#include "render/material.hpp"
+#include "render/rng.hpp"
+#include "render/sampler.hpp"
+#include "render/scene.hpp"
+#include <gtest/gtest.h>
+
+namespace {
+
+  render::Scene one_sphere(render::MaterialKind kind, double radius, double ior = 1.5) {
+    render::Scene scn;
+    render::Material m;
+    m.name  = "m";
+    m.kind  = kind;
+    m.color = {0.5, 0.5, 0.5};
+    m.ior   = ior;
+    scn.materials.push_back(m);
+    render::Sphere s;
+    s.center = {0, 0, 0};
+    s.radius = radius;
+    s.mat    = 0;
+    scn.spheres.push_back(s);
+    return scn;
+  }
+
+}  // namespace
+
+TEST(CompiledScene, MaterialsAreResolvedByIndex) {
+  render::Scene scn = one_sphere(render::MaterialKind::Metal, 1.0);
+  scn.materials[0].fuzz = 0.25;
+  render::Sphere legacy;
+  legacy.radius = 1.0;
+  scn.spheres.push_back(legacy);
+  auto const cs = render::CompiledScene::compile(scn);
+
+  ASSERT_EQ(cs.materials().size(), 1U);
+  auto const & m = cs.material(cs.spheres().mat[0]);
+  EXPECT_EQ(m.kind, render::MaterialKind::Metal);
+  EXPECT_EQ(m.fuzz, 0.25);
+  EXPECT_EQ(m.albedo.x, 0.5);
+  EXPECT_EQ(&cs.material(cs.spheres().mat[1]), &render::default_material);
+}
+
+TEST(Scatter, MatteStaysInNormalHemisphere) {
+  render::MaterialPre const m{render::MaterialKind::Matte, {0.3, 0.4, 0.5}, 0.0, 1.5};
+  render::vector const n{0, 1, 0};
+  for (std::uint32_t i = 0; i < 1'000; ++i) {
+    auto const xi = render::sample_2d(render::SamplerKind::Sobol, {1ULL, 0, 0, 1'000}, i, 0);
+    render::Scatter sc;
+    ASSERT_TRUE(render::scatter(m, render::ray{{0, 1, 0}, {0, -1, 0}}, {0, 0, 0}, n, xi, sc));
+    EXPECT_GE(sc.scattered.direction.dot(n), 0.0);
+    EXPECT_NEAR(sc.scattered.direction.magnitude(), 1.0, 1e-12);
+    EXPECT_EQ(sc.attenuation.y, 0.4);
+  }
+}
+
+TEST(Scatter, PolishedMetalIsAMirror) {
+  render::MaterialPre const m{render::MaterialKind::Metal, {1, 1, 1}, 0.0, 1.5};
+  render::Scatter sc;
+  render::vector const d = render::vector{1, -1, 0}.normalized();
+  ASSERT_TRUE(
+      render::scatter(m, render::ray{{0, 0, 0}, d}, {0, 0, 0}, {0, 1, 0}, {0.3, 0.7}, sc));
+  EXPECT_NEAR(sc.scattered.direction.x, d.x, 1e-15);
+  EXPECT_NEAR(sc.scattered.direction.y, -d.y, 1e-15);
+}
+
+TEST(Scatter, HeadOnRayCrossesGlassWithIorOne) {
+  render::MaterialPre const m{render::MaterialKind::Refractive, {1, 1, 1}, 0.0, 1.0};
+  render::Scatter sc;
+  ASSERT_TRUE(
+      render::scatter(m, render::ray{{0, 0, 2}, {0, 0, -1}}, {0, 0, 1}, {0, 0, 1}, {0.3, 0.7}, sc));
+  EXPECT_NEAR(sc.scattered.direction.z, -1.0, 1e-15);
+}
+
+TEST(TracePath, MissReturnsSkyInOneSegment) {
+  auto const cs  = render::CompiledScene::compile(render::Scene{});
+  auto const bvh = render::Bvh::build(cs);
+  render::counter_rng rng{1ULL, 0, 0, 0};
+  render::ray const r{
+    {0, 0, 0},
+    render::vector{0, 1, 1}
+    .normalized()
+  };
+  auto const p = render::trace_path(r, cs, bvh, 5, 5, rng);
+  EXPECT_EQ(p.segments, 1U);
+  EXPECT_EQ(p.color.x, render::sky(r).x);
+  EXPECT_EQ(p.color.z, render::sky(r).z);
+}
+
+// Desde dentro de una esfera mate nunca se llega al cielo: todo camino agota max_depth
+TEST(TracePath, ClosedMatteRoomIsBlack) {
+  auto const cs  = render::CompiledScene::compile(one_sphere(render::MaterialKind::Matte, 10.0));
+  auto const bvh = render::Bvh::build(cs);
+  for (std::uint32_t i = 0; i < 100; ++i) {
+    render::counter_rng rng{7ULL, i, 0, 0};
+    auto const p = render::trace_path(render::ray{{0, 0, 0}, {0, 0, -1}}, cs, bvh, 4, 4, rng);
+    EXPECT_EQ(p.segments, 4U);
+    EXPECT_EQ(p.color.x, 0.0);
+  }
+}
+
+// Vidrio con ior 1 y rayo por el centro: lo atraviesa y sale al cielo sin atenuar
+TEST(TracePath, ClearGlassShowsTheSky) {
+  auto const cs =
+      render::CompiledScene::compile(one_sphere(render::MaterialKind::Refractive, 1.0, 1.0));
+  auto const bvh = render::Bvh::build(cs);
+  render::counter_rng rng{7ULL, 0, 0, 0};
+  render::ray const r{
+    {0, 0, 5},
+    {0, 0, -1}
+  };
+  auto const p = render::trace_path(r, cs, bvh, 8, 8, rng);
+  EXPECT_EQ(p.segments, 3U);
+  EXPECT_NEAR(p.color.x, render::sky(r).x, 1e-12);
+  EXPECT_NEAR(p.color.z, render::sky(r).z, 1e-12);
+}
+
+// La ruleta corta caminos pero no cambia la media: suelo mate y cielo, muchas muestras
+TEST(TracePath, RussianRouletteIsUnbiased) {
+  render::Scene scn = one_sphere(render::MaterialKind::Matte, 1000.0);
+  scn.spheres[0].center = {0, -1000, 0};
+  scn.materials[0].color = {0.8, 0.8, 0.8};
+  auto const cs  = render::CompiledScene::compile(scn);
+  auto const bvh = render::Bvh::build(cs);
+  render::ray const r{
+    {0, 1, 0},
+    render::vector{0, -1, 0.3}
+    .normalized()
+  };
+
+  constexpr std::uint32_t n = 200'000;
+  double fixed = 0.0, roulette = 0.0;
+  std::uint64_t seg_fixed = 0, seg_roulette = 0;
+  for (std::uint32_t i = 0; i < n; ++i) {
+    render::counter_rng a{3ULL, i, 0, 0};
+    render::counter_rng b{4ULL, i, 0, 0};
+    auto const pf = render::trace_path(r, cs, bvh, 12, 12, a);
+    auto const pr = render::trace_path(r, cs, bvh, 12, 1, b);
+    fixed += pf.color.y;
+    roulette += pr.color.y;
+    seg_fixed += pf.segments;
+    seg_roulette += pr.segments;
+  }
+  EXPECT_NEAR(roulette / n, fixed / n, 0.01 * fixed / n);
+  EXPECT_LT(seg_roulette, seg_fixed);
+}
+
+// Con rr_depth 0 la ruleta empieza en el primer rebote y una habitación cerrada ya no llega
+// siempre a max_depth
+TEST(TracePath, RussianRouletteShortensClosedRoom) {
+  auto const cs  = render::CompiledScene::compile(one_sphere(render::MaterialKind::Matte, 10.0));
+  auto const bvh = render::Bvh::build(cs);
+  std::uint64_t segments = 0;
+  for (std::uint32_t i = 0; i < 1'000; ++i) {
+    render::counter_rng rng{7ULL, i, 0, 0};
+    render::ray const r{
+      {0, 0,  0},
+      {0, 0, -1}
+    };
+    segments += render::trace_path(r, cs, bvh, 64, 0, rng).segments;
+  }
+  EXPECT_LT(segments, 1'000U * 8U);  // albedo 0.5 -> ~2 segmentos de media
+}
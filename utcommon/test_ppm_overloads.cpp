@@ -1,6 +1,12 @@
 #include "render/ppm.hpp"
+#include <cmath>
+#include <cstdint>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <iterator>
+#include <sstream>
 #include <string>
+#include <vector>
 
 using namespace render;
 
@@ -21,3 +27,111 @@ TEST(PPM, RejectZeroDims) {
   auto sampler = [](int, int, double & r, double & g, double & b) { r = g = b = 0.0; };
   EXPECT_FALSE(write_ppm_gamma("out/build/coverage/zero.ppm", 0, 0, sampler));
 }
+
+namespace {
+
+  std::string slurp(std::string const & path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  }
+
+}  // namespace
+
+// Como las versiones originales: una dimensión negativa con la otra positiva deja solo la
+// cabecera y cuenta como escrito (los mains devuelven 0)
+TEST(PPM, SamplerOverloadsKeepHeaderOnlyForNegativeDims) {
+  auto sampler = [](int, int, double & r, double & g, double & b) { r = g = b = 0.5; };
+  auto read    = [](char const * path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  };
+  EXPECT_TRUE(write_ppm_gamma("/tmp/neg_legacy.ppm", -3, 2, sampler));
+  EXPECT_EQ(read("/tmp/neg_legacy.ppm"), "P3\n-3 2\n255\n");
+  EXPECT_TRUE(write_ppm_gamma("/tmp/neg_gamma.ppm", 2, -1, 2.2, sampler));
+  EXPECT_EQ(read("/tmp/neg_gamma.ppm"), "P3\n2 -1\n255\n");
+  EXPECT_TRUE(write_ppm_gamma("/tmp/neg_p6.ppm", -1, 4, 2.2, sampler, PpmFormat::P6));
+  EXPECT_EQ(read("/tmp/neg_p6.ppm"), "P6\n-1 4\n255\n");
+  // Las de imagen ya cuantizada sí lo rechazan
+  EXPECT_FALSE(write_ppm("/tmp/neg_bulk.ppm", -3, 2, std::vector<std::uint8_t>{}, PpmFormat::P3));
+}
+
+TEST(PPM, P6BulkWritesHeaderAndRawBytes) {
+  std::vector<std::uint8_t> const rgb{0, 10, 255, 1, 2, 3, 128, 64, 32, 9, 9, 9};
+  ASSERT_TRUE(write_ppm("/tmp/ok_p6.ppm", 2, 2, rgb, PpmFormat::P6));
+  std::string const expected = std::string("P6\n2 2\n255\n") +
+                               std::string(reinterpret_cast<char const *>(rgb.data()), rgb.size());
+  EXPECT_EQ(slurp("/tmp/ok_p6.ppm"), expected);
+}
+
+// El volcado en bloque P3 es byte a byte el del sampler con gamma (ruta histórica)
+TEST(PPM, P3BulkMatchesSamplerPath) {
+  int const W = 5, H = 3;
+  auto sampler = [](int x, int y, double & r, double & g, double & b) {
+    r = x / 4.0;
+    g = y / 2.0;
+    b = 0.3;
+  };
+  ASSERT_TRUE(write_ppm_gamma("/tmp/ok_p3_sampler.ppm", W, H, 2.2, sampler));
+
+  auto const lut = gamma_table_u8(1.0);  // identidad
+  std::vector<std::uint8_t> R, G, B, rgb;
+  for (int y = 0; y < H; ++y) {
+    for (int x = 0; x < W; ++x) {
+      double r{}, g{}, b{};
+      sampler(x, y, r, g, b);
+      auto const q = [](double v) {
+        return static_cast<std::uint8_t>(std::lround(std::pow(v, 1.0 / 2.2) * 255.0));
+      };
+      R.push_back(lut[q(r)]);
+      G.push_back(lut[q(g)]);
+      B.push_back(lut[q(b)]);
+      rgb.insert(rgb.end(), {R.back(), G.back(), B.back()});
+    }
+  }
+  ASSERT_TRUE(write_ppm("/tmp/ok_p3_bulk.ppm", W, H, rgb, PpmFormat::P3));
+  ASSERT_TRUE(write_ppm("/tmp/ok_p3_planes.ppm", W, H, R, G, B, PpmFormat::P3));
+  std::string const ref = slurp("/tmp/ok_p3_sampler.ppm");
+  EXPECT_EQ(ref.substr(0, 11), "P3\n5 3\n255\n");
+  EXPECT_EQ(slurp("/tmp/ok_p3_bulk.ppm"), ref);
+  EXPECT_EQ(slurp("/tmp/ok_p3_planes.ppm"), ref);
+}
+
+TEST(PPM, BulkRejectsSizeMismatch) {
+  std::vector<std::uint8_t> const rgb(11, 0);
+  EXPECT_FALSE(write_ppm("/tmp/bad.ppm", 2, 2, rgb, PpmFormat::P6));
+  std::vector<std::uint8_t> const plane(4, 0), shorter(3, 0);
+  EXPECT_FALSE(write_ppm("/tmp/bad.ppm", 2, 2, plane, plane, shorter, PpmFormat::P6));
+  EXPECT_FALSE(write_ppm("/this/dir/should/not/exist/out.ppm", 2, 2, plane, plane, plane));
+}
+
+TEST(PPM, GammaTableMatchesSamplerRounding) {
+  auto const lut = gamma_table_u8(2.2);
+  EXPECT_EQ(lut[0], 0);
+  EXPECT_EQ(lut[255], 255);
+  EXPECT_EQ(lut[64], static_cast<std::uint8_t>(std::lround(std::pow(64 / 255.0, 1 / 2.2) * 255)));
+  EXPECT_EQ(parse_ppm_format("P6", PpmFormat::P3), PpmFormat::P6);
+  EXPECT_EQ(parse_ppm_format("p3", PpmFormat::P6), PpmFormat::P3);
+  EXPECT_EQ(parse_ppm_format("png", PpmFormat::P3), PpmFormat::P3);
+}
+
+// El codificador P3 por tabla y en paralelo da el texto de siempre ("R G B\n" con ostream),
+// con cualquier nº de hilos y con trozos que acaban en valores de 1, 2 o 3 dígitos
+TEST(PPM, EncodeP3MatchesStreamFormatting) {
+  std::size_t const n = 3 * (std::size_t{1} << 15) + 77;  // varios trozos y uno incompleto
+  std::vector<std::uint8_t> R(n), G(n), B(n), rgb;
+  rgb.reserve(3 * n);
+  std::ostringstream ref;
+  for (std::size_t i = 0; i < n; ++i) {
+    R[i] = static_cast<std::uint8_t>(i * 7);
+    G[i] = static_cast<std::uint8_t>(i / 3);
+    B[i] = static_cast<std::uint8_t>((i % 5 == 0) ? 5 : i * 13);
+    rgb.insert(rgb.end(), {R[i], G[i], B[i]});
+    ref << int{R[i]} << ' ' << int{G[i]} << ' ' << int{B[i]} << '\n';
+  }
+  for (unsigned const threads : {1U, 2U, 5U}) {
+    EXPECT_EQ(encode_p3(rgb, threads), ref.str()) << threads;
+    EXPECT_EQ(encode_p3(R, G, B, threads), ref.str()) << threads;
+  }
+  EXPECT_EQ(encode_p3(std::vector<std::uint8_t>{0, 9, 10, 99, 100, 255}), "0 9 10\n99 100 255\n");
+  EXPECT_TRUE(encode_p3(std::vector<std::uint8_t>{}).empty());
+}
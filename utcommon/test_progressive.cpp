@@ -0,0 +1,161 @@
+#include "render/compiled_scene.hpp"
+#include "render/config.hpp"
+#include "render/kernel.hpp"
+#include "render/progressive.hpp"
+#include "render/scene.hpp"
+#include "render/settings.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+  // Framebuffer mínimo con la interfaz que usa render_progressive (suma en double para poder
+  // comparar bit a bit con trace_pixel)
+  struct TestFramebuffer {
+    int width{}, height{};
+    std::vector<render::vector> sum;
+    std::vector<std::uint32_t> n;
+
+    TestFramebuffer(int w, int h)
+        : width(w), height(h), sum(static_cast<std::size_t>(w * h)),
+          n(static_cast<std::size_t>(w * h), 0U) { }
+
+    [[nodiscard]] std::size_t idx(int x, int y) const {
+      return static_cast<std::size_t>(y * width + x);
+    }
+
+    void add(int x, int y, float r, float g, float b) {
+      sum[idx(x, y)] = sum[idx(x, y)] + render::vector{r, g, b};
+      ++n[idx(x, y)];
+    }
+
+    [[nodiscard]] std::uint32_t samples(int x, int y) const { return n[idx(x, y)]; }
+  };
+
+  // Muestra determinista que depende del píxel y del índice
+  render::vector fake_sample(int x, int y, std::uint32_t i) {
+    return {static_cast<double>(x) * 0.25, static_cast<double>(y) * 0.5,
+            static_cast<double>(i) + 1.0};
+  }
+
+  void ignore(render::ProgressiveStats const &) { }
+
+  render::TileOptions small_tiles() {
+    render::TileOptions t;
+    t.tile_size = 8;
+    t.threads   = 3;
+    return t;
+  }
+
+}  // namespace
+
+TEST(Progressive, ReachesTargetWithExactlyTargetSamples) {
+  TestFramebuffer fb{19, 11};
+  auto const st = render::render_progressive(fb, small_tiles(), {0.0, 5U, 0.0}, fake_sample,
+                                             ignore, ignore);
+  EXPECT_EQ(st.passes, 5U);
+  EXPECT_EQ(st.samples, 19U * 11U * 5U);
+  EXPECT_FALSE(st.deadline_hit);
+  for (int y = 0; y < fb.height; ++y) {
+    for (int x = 0; x < fb.width; ++x) {
+      ASSERT_EQ(fb.samples(x, y), 5U);
+      EXPECT_EQ(fb.sum[fb.idx(x, y)].z, 1.0 + 2.0 + 3.0 + 4.0 + 5.0);
+    }
+  }
+}
+
+// Un framebuffer a medias se continúa por la muestra siguiente: parar y seguir da lo mismo
+// que hacerlo de una vez
+TEST(Progressive, ContinuesPartialFramebufferExactly) {
+  TestFramebuffer once{13, 7}, split{13, 7};
+  (void) render::render_progressive(once, small_tiles(), {0.0, 6U, 0.0}, fake_sample,
+                                    ignore, ignore);
+  (void) render::render_progressive(split, small_tiles(), {0.0, 2U, 0.0}, fake_sample,
+                                    ignore, ignore);
+  auto const st = render::render_progressive(split, small_tiles(), {0.0, 6U, 0.0}, fake_sample,
+                                             ignore, ignore);
+  EXPECT_EQ(st.passes, 4U);
+  EXPECT_EQ(split.n, once.n);
+  for (std::size_t i = 0; i < once.sum.size(); ++i) {
+    EXPECT_EQ(split.sum[i].x, once.sum[i].x);
+    EXPECT_EQ(split.sum[i].z, once.sum[i].z);
+  }
+}
+
+// Con el plazo vencido se para, y todo lo trazado está en el framebuffer
+TEST(Progressive, ExpiredBudgetKeepsEverySampleTraced) {
+  TestFramebuffer fb{16, 16};
+  auto const st = render::render_progressive(fb, small_tiles(), {1e-9, 1000U, 0.0}, fake_sample,
+                                             ignore, ignore);
+  EXPECT_TRUE(st.deadline_hit);
+  EXPECT_LT(st.samples, 16U * 16U * 1000U);
+  std::uint64_t in_fb = 0;
+  for (std::uint32_t const n : fb.n) {
+    in_fb += n;
+  }
+  EXPECT_EQ(in_fb, st.samples);
+}
+
+TEST(Progressive, PreviewAndCheckpointBetweenPasses) {
+  TestFramebuffer fb{8, 8};
+  std::uint32_t previews = 0, checkpoints = 0, last_pass = 0;
+  auto const st = render::render_progressive(
+      fb, small_tiles(), {0.0, 4U, 1e-9, 1e-9}, fake_sample,
+      [&](render::ProgressiveStats const & s) {
+        ++previews;
+        EXPECT_GT(s.passes, last_pass);
+        last_pass = s.passes;
+      },
+      [&](render::ProgressiveStats const & s) {
+        ++checkpoints;
+        EXPECT_EQ(s.passes, last_pass);  // después del preview de la misma pasada
+        EXPECT_EQ(s.samples, 64U * s.passes);
+      });
+  EXPECT_EQ(st.passes, 4U);
+  EXPECT_EQ(previews, 4U);
+  EXPECT_EQ(checkpoints, 4U);
+}
+
+// Las pasadas de 1 spp con trace_sample suman las mismas muestras que trace_pixel fijo (salvo
+// el redondeo a float de cada muestra en add())
+TEST(Progressive, MatchesFixedKernel) {
+  render::Scene scn;
+  render::Material m;
+  m.name = "m";
+  scn.materials.push_back(m);
+  render::Sphere sp;
+  sp.radius = 1.0;
+  sp.mat    = 0;
+  scn.spheres.push_back(sp);
+  auto const cs  = render::CompiledScene::compile(scn);
+  auto const bvh = render::Bvh::build(cs);
+
+  render::Config cfg;
+  cfg.width             = 24;
+  cfg.height            = 16;
+  cfg.lookfrom          = {0, 0, 3};
+  cfg.samples_per_pixel = 4;
+  auto const s          = render::resolve_settings(cfg, [](char const *) -> char const * {
+    return nullptr;
+  });
+  auto const cam        = s.make_camera();
+
+  TestFramebuffer fb{24, 16};
+  (void) render::render_progressive(
+      fb, small_tiles(), {0.0, s.spp, 0.0},
+      [&](int x, int y, std::uint32_t i) {
+        return render::trace_sample<render::Lens::Pinhole>(cam, cs, bvh, s, x, y, i);
+      },
+      ignore, ignore);
+  for (int y = 0; y < 16; y += 3) {
+    for (int x = 0; x < 24; x += 5) {
+      render::vector fixed;
+      (void) render::trace_pixel<render::Lens::Pinhole, render::SampleMode::Fixed>(cam, cs, bvh,
+                                                                                  s, x, y, fixed);
+      EXPECT_NEAR(fb.sum[fb.idx(x, y)].x, fixed.x, 1e-5);
+      EXPECT_NEAR(fb.sum[fb.idx(x, y)].z, fixed.z, 1e-5);
+    }
+  }
+}
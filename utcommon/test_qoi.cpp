@@ -0,0 +1,145 @@
+#include "render/qoi.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+
+  std::string tmp_path(char const * name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+  }
+
+  std::vector<std::uint8_t> read_bytes(std::string const & path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  }
+
+  // Mezcla de todo lo que el codificador distingue: zonas planas largas (RUN de más de 62),
+  // degradados suaves (DIFF, LUMA), colores que vuelven (INDEX) y ruido (RGB)
+  std::vector<std::uint8_t> test_image(int w, int h) {
+    std::vector<std::uint8_t> rgb;
+    std::uint32_t state = 12345U;
+    for (int y = 0; y < h; ++y) {
+      for (int x = 0; x < w; ++x) {
+        state = state * 1664525U + 1013904223U;
+        std::uint8_t r{}, g{}, b{};
+        if (y < h / 4) {
+          r = 40, g = 80, b = 120;
+        } else if (y < h / 2) {
+          r = static_cast<std::uint8_t>(x), g = static_cast<std::uint8_t>(x + y / 3);
+          b = static_cast<std::uint8_t>(2 * y);
+        } else if (y < 3 * h / 4) {
+          r = static_cast<std::uint8_t>((x / 3 % 4) * 60), g = r, b = 7;
+        } else {
+          r = static_cast<std::uint8_t>(state >> 24), g = static_cast<std::uint8_t>(state >> 16);
+          b = static_cast<std::uint8_t>(state >> 8);
+        }
+        rgb.insert(rgb.end(), {r, g, b});
+      }
+    }
+    return rgb;
+  }
+
+}  // namespace
+
+// Un código de cada tipo, comprobado a mano contra la especificación
+TEST(Qoi, EncodesEachOpAsSpecified) {
+  std::vector<std::uint8_t> const rgb{0, 0, 0, 1, 1, 0, 0, 0, 0, 1, 1, 0, 200, 10, 30, 210, 20, 36};
+  std::vector<std::uint8_t> const expected{
+      'q',  'o',  'i',  'f', 0,  0,  0, 6, 0, 0, 0, 1, 3, 0,  // cabecera
+      0xc0,                                                   // RUN 1: igual al inicial
+      0x7e,                                                   // DIFF +1 +1 0
+      0x56,                                                   // DIFF -1 -1 0
+      0x3d,                                                   // INDEX 61
+      0xfe, 200,  10,   30,                                   // RGB
+      0xaa, 0x84,                                             // LUMA dg=10, dr-dg=0, db-dg=-4
+      0,    0,    0,    0,   0,  0,  0, 1                     // fin
+  };
+  EXPECT_EQ(render::encode_qoi(6, 1, rgb), expected);
+
+  auto const back = render::decode_qoi(expected);
+  ASSERT_TRUE(back.has_value());
+  EXPECT_EQ(back->width, 6);
+  EXPECT_EQ(back->height, 1);
+  EXPECT_EQ(back->rgb, rgb);
+}
+
+TEST(Qoi, RoundTripsFromInterleavedAndPlanes) {
+  int const W = 97, H = 64;
+  std::vector<std::uint8_t> const rgb = test_image(W, H);
+  std::vector<std::uint8_t> R, G, B;
+  for (std::size_t i = 0; i < rgb.size(); i += 3) {
+    R.push_back(rgb[i]);
+    G.push_back(rgb[i + 1]);
+    B.push_back(rgb[i + 2]);
+  }
+
+  std::vector<std::uint8_t> const qoi = render::encode_qoi(W, H, rgb);
+  EXPECT_EQ(render::encode_qoi(W, H, R, G, B), qoi);
+  EXPECT_LT(qoi.size(), rgb.size() * 3 / 4);  // una cuarta parte es ruido
+
+  auto const back = render::decode_qoi(qoi);
+  ASSERT_TRUE(back.has_value());
+  EXPECT_EQ(back->width, W);
+  EXPECT_EQ(back->height, H);
+  EXPECT_EQ(back->rgb, rgb);
+
+  std::string const path = tmp_path("render_roundtrip.qoi");
+  ASSERT_TRUE(render::write_qoi(path, W, H, R, G, B));
+  EXPECT_EQ(read_bytes(path), qoi);
+  EXPECT_FALSE(render::write_qoi(path, W, H, std::span{rgb}.first(rgb.size() - 3)));
+  std::filesystem::remove(path);
+}
+
+// Por bandas el fichero es el mismo: el estado del codificador pasa de una banda a la otra
+TEST(Qoi, StreamWriterMatchesWholeImage) {
+  int const W = 40, H = 30;
+  std::vector<std::uint8_t> const rgb = test_image(W, H);
+  std::span<std::uint8_t const> const all{rgb};
+  std::size_t const row  = 3U * W;
+  std::string const path = tmp_path("render_stream.qoi");
+
+  render::QoiStreamWriter out(path, W, H);
+  ASSERT_TRUE(out.ok());
+  EXPECT_TRUE(out.write_rows(all.first(7 * row)));
+  EXPECT_TRUE(out.write_rows(all.subspan(7 * row, 16 * row)));
+  EXPECT_TRUE(out.write_rows(all.subspan(23 * row)));
+  EXPECT_TRUE(out.finish());
+  EXPECT_EQ(read_bytes(path), render::encode_qoi(W, H, rgb));
+
+  render::QoiStreamWriter short_file(path, W, H);
+  EXPECT_TRUE(short_file.write_rows(all.first(row)));
+  EXPECT_FALSE(short_file.write_rows(all.first(row / 2)));
+  EXPECT_FALSE(short_file.finish());
+  std::filesystem::remove(path);
+}
+
+TEST(Qoi, DecoderRejectsBrokenFiles) {
+  std::vector<std::uint8_t> const good = render::encode_qoi(16, 16, test_image(16, 16));
+  ASSERT_TRUE(render::decode_qoi(good).has_value());
+
+  auto broken = [&](std::size_t at, std::uint8_t v) {
+    std::vector<std::uint8_t> bad = good;
+    bad[at]                       = v;
+    return render::decode_qoi(bad).has_value();
+  };
+  EXPECT_FALSE(broken(0, 'Q'));              // firma
+  EXPECT_FALSE(broken(7, 0));                // ancho 0
+  EXPECT_FALSE(broken(12, 2));               // canales
+  EXPECT_FALSE(broken(good.size() - 1, 0));  // marcador de fin
+  EXPECT_FALSE(render::decode_qoi(std::span{good}.first(good.size() - 20)).has_value());
+  EXPECT_FALSE(render::decode_qoi(std::span{good}.first(10)).has_value());
+}
+
+TEST(Qoi, ExtensionSelectsFormat) {
+  EXPECT_TRUE(render::has_qoi_extension("out.qoi"));
+  EXPECT_TRUE(render::has_qoi_extension("/tmp/a.b/OUT.QOI"));
+  EXPECT_FALSE(render::has_qoi_extension("out.ppm"));
+  EXPECT_FALSE(render::has_qoi_extension("qoi"));
+  EXPECT_FALSE(render::has_qoi_extension("out.qoi.ppm"));
+}
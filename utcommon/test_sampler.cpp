@@ -0,0 +1,188 @@
+#include "render/camera.hpp"
+#include "render/rng.hpp"
+#include "render/sampler.hpp"
+#include <array>
+#include <cmath>
+#include <gtest/gtest.h>
+
+namespace {
+
+  constexpr std::array kinds{render::SamplerKind::Random, render::SamplerKind::Stratified,
+                             render::SamplerKind::Sobol, render::SamplerKind::R2};
+
+  // Nº de puntos en cada celda de una rejilla nx * ny
+  template <std::size_t N>
+  std::array<int, N> histogram(render::SamplerKind kind, render::PixelKey const & k,
+                               std::uint32_t n, std::uint32_t nx, std::uint32_t ny,
+                               std::uint32_t dim) {
+    std::array<int, N> cells{};
+    for (std::uint32_t i = 0; i < n; ++i) {
+      auto const s  = render::sample_2d(kind, k, i, dim);
+      auto const cx = static_cast<std::uint32_t>(s.u * nx);
+      auto const cy = static_cast<std::uint32_t>(s.v * ny);
+      ++cells[cy * nx + cx];
+    }
+    return cells;
+  }
+
+}  // namespace
+
+TEST(Sampler, AllKindsStayInUnitSquare) {
+  for (auto const kind : kinds) {
+    for (std::uint32_t p = 0; p < 8; ++p) {
+      render::PixelKey const k{9ULL, p, 2 * p, render::strata_grid(16)};
+      for (std::uint32_t i = 0; i < 64; ++i) {
+        for (std::uint32_t dim : {render::dim_pixel, render::dim_lens}) {
+          auto const s = render::sample_2d(kind, k, i, dim);
+          ASSERT_GE(s.u, 0.0);
+          ASSERT_LT(s.u, 1.0);
+          ASSERT_GE(s.v, 0.0);
+          ASSERT_LT(s.v, 1.0);
+        }
+      }
+    }
+  }
+}
+
+// Con Random el jitter es exactamente el de antes (dos primeros valores del counter_rng)
+TEST(Sampler, RandomKeepsCounterRngStream) {
+  render::PixelKey const k{42ULL, 3, 4, render::strata_grid(8)};
+  render::counter_rng rng{42ULL, 3, 4, 5};
+  auto const s = render::sample_2d(render::SamplerKind::Random, k, 5, render::dim_pixel);
+  EXPECT_EQ(s.u, rng.next01());
+  EXPECT_EQ(s.v, rng.next01());
+}
+
+TEST(Sampler, StratifiedFillsEveryCellOnce) {
+  for (std::uint32_t p = 0; p < 16; ++p) {
+    render::PixelKey const k{1ULL, p, 0, render::strata_grid(16)};
+    auto const cells = histogram<16>(render::SamplerKind::Stratified, k, 16, 4, 4, p % 2);
+    for (int c : cells) {
+      EXPECT_EQ(c, 1);
+    }
+  }
+}
+
+// nx = ceil(sqrt(spp)) sin bucle por muestra, también cerca del límite de 32 bits
+TEST(Sampler, StrataGridIsComputedOnce) {
+  for (std::uint32_t spp = 1; spp <= 20'000; ++spp) {
+    std::uint32_t nx = 1;
+    while (nx * nx < spp) {
+      ++nx;
+    }
+    auto const g = render::strata_grid(spp);
+    ASSERT_EQ(g.nx, nx) << spp;
+    ASSERT_EQ(g.ny, (spp + nx - 1U) / nx) << spp;
+  }
+  EXPECT_EQ(render::strata_grid(0).nx, 1U);
+  EXPECT_EQ(render::strata_grid(65'535U * 65'535U).nx, 65'535U);
+  EXPECT_EQ(render::strata_grid(65'535U * 65'535U + 1U).nx, 65'536U);
+  auto const top = render::strata_grid(0xFFFF'FFFFU);
+  EXPECT_EQ(top.nx, 65'536U);
+  EXPECT_EQ(top.ny, 65'535U);  // 65536 * 65536 no cabe en 32 bits
+
+  render::camera const cam{64, 48, 40.0, {0, 0, 5}, {0, 0, 0}, {0, 1, 0}, 12, 3ULL};
+  EXPECT_EQ(cam.strata().nx, 4U);
+  EXPECT_EQ(cam.strata().ny, 3U);
+  render::PixelKey const k{2ULL, 5, 6, cam.strata()};
+  auto const cells = histogram<12>(render::SamplerKind::Stratified, k, 12, 4, 3, 0);
+  for (int c : cells) {
+    EXPECT_EQ(c, 1);
+  }
+}
+
+// Owen conserva la (0,m,2)-red: 16 puntos, un punto en cada intervalo elemental de área 1/16
+TEST(Sampler, SobolPrefixesAreNets) {
+  for (std::uint32_t p = 0; p < 16; ++p) {
+    render::PixelKey const k{5ULL, p, 7, render::strata_grid(16)};
+    for (auto const & [nx, ny] : {std::pair{16U, 1U}, {8U, 2U}, {4U, 4U}, {2U, 8U}, {1U, 16U}}) {
+      auto const cells = histogram<16>(render::SamplerKind::Sobol, k, 16, nx, ny, p % 2);
+      for (int c : cells) {
+        EXPECT_EQ(c, 1) << nx << "x" << ny;
+      }
+    }
+  }
+}
+
+// Píxeles distintos no comparten la secuencia
+TEST(Sampler, SequencesAreDecorrelatedAcrossPixels) {
+  for (auto const kind : kinds) {
+    render::StrataGrid const g = render::strata_grid(16);
+    auto const a = render::sample_2d(kind, {1ULL, 0, 0, g}, 3, render::dim_pixel);
+    auto const b = render::sample_2d(kind, {1ULL, 1, 0, g}, 3, render::dim_pixel);
+    auto const c = render::sample_2d(kind, {1ULL, 0, 0, g}, 3, render::dim_lens);
+    EXPECT_NE(a.u, b.u);
+    EXPECT_NE(a.u, c.u);
+  }
+}
+
+// Error medio de integración de una función suave con 16 muestras: las secuencias de baja
+// discrepancia tienen que ganar con holgura al ruido blanco
+TEST(Sampler, LowDiscrepancyBeatsWhiteNoise) {
+  auto rms_error = [](render::SamplerKind kind) {
+    double err2 = 0.0;
+    for (std::uint32_t p = 0; p < 256; ++p) {
+      render::PixelKey const k{11ULL, p, 0, render::strata_grid(16)};
+      double sum = 0.0;
+      for (std::uint32_t i = 0; i < 16; ++i) {
+        auto const s = render::sample_2d(kind, k, i, render::dim_pixel);
+        sum += std::sin(3.0 * s.u) * std::exp(s.v);  // integral conocida
+      }
+      double const exact = (1.0 - std::cos(3.0)) / 3.0 * (std::exp(1.0) - 1.0);
+      double const e     = sum / 16.0 - exact;
+      err2 += e * e;
+    }
+    return std::sqrt(err2 / 256.0);
+  };
+  double const white = rms_error(render::SamplerKind::Random);
+  EXPECT_LT(rms_error(render::SamplerKind::Stratified), 0.5 * white);
+  EXPECT_LT(rms_error(render::SamplerKind::Sobol), 0.5 * white);
+  EXPECT_LT(rms_error(render::SamplerKind::R2), 0.5 * white);
+}
+
+TEST(Sampler, ConcentricDiskIsInsideAndAreaPreserving) {
+  double r2_sum = 0.0;
+  int const n   = 64;
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      render::Sample2D const s{(i + 0.5) / n, (j + 0.5) / n};
+      auto const d     = render::concentric_disk(s);
+      double const r2  = d.u * d.u + d.v * d.v;
+      ASSERT_LE(r2, 1.0 + 1e-12);
+      r2_sum += r2;
+    }
+  }
+  EXPECT_NEAR(r2_sum / (n * n), 0.5, 1e-3);  // uniforme en el disco: E[r²] = 1/2
+  auto const c = render::concentric_disk({0.5, 0.5});
+  EXPECT_EQ(c.u, 0.0);
+  EXPECT_EQ(c.v, 0.0);
+}
+
+TEST(Sampler, ParseNames) {
+  EXPECT_EQ(render::parse_sampler("Sobol"), render::SamplerKind::Sobol);
+  EXPECT_EQ(render::parse_sampler("r2"), render::SamplerKind::R2);
+  EXPECT_EQ(render::parse_sampler("stratified"), render::SamplerKind::Stratified);
+  EXPECT_EQ(render::parse_sampler("random"), render::SamplerKind::Random);
+  EXPECT_FALSE(render::parse_sampler("halton").has_value());
+  for (auto const kind : kinds) {
+    EXPECT_EQ(render::parse_sampler(render::sampler_name(kind)), kind);
+  }
+}
+
+// La cámara con lente usa el sampler en las dos dimensiones y sigue sin estado
+TEST(Sampler, CameraLensSamplesAreDeterministic) {
+  for (auto const kind : kinds) {
+    render::camera const cam{
+      64, 48, 40.0, {0, 0, 5},
+        {0, 0, 0},
+        {0, 1, 0},
+        16, 3ULL, 0.5, 5.0, kind
+    };
+    EXPECT_EQ(cam.sampler(), kind);
+    auto const a = cam.get_ray(10, 12, 7);
+    auto const b = cam.get_ray(10, 12, 7);
+    EXPECT_EQ(a.origin.x, b.origin.x);
+    EXPECT_EQ(a.direction.y, b.direction.y);
+    EXPECT_LE((a.origin - render::vector{0, 0, 5}).magnitude(), 0.25 + 1e-12);
+  }
+}
@@ -0,0 +1,198 @@
+#include "render/bvh.hpp"
+#include "render/compiled_scene.hpp"
+#include "render/hash.hpp"
+#include "render/parser.hpp"
+#include "render/scene_cache.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+
+  std::string tmp_path(char const * name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+  }
+
+  std::string write_text(char const * name, std::string const & text) {
+    std::string const path = tmp_path(name);
+    std::ofstream(path, std::ios::binary) << text;
+    return path;
+  }
+
+  std::string const scene_text = "matte red color 0.8 0.2 0.2\n"
+                                 "metal steel color 0.8 0.8 0.9 fuzz 0.2\n"
+                                 "refractive glass ior 1.5\n"
+                                 "sphere a 0 -100.5 -1 100 red\n"
+                                 "sphere b 0 0 -1 0.5 glass\n"
+                                 "sphere 1 0 -1 0.5\n"
+                                 "cylinder c -1 -0.5 -1 0 1 0 1 0.25 steel\n"
+                                 "cylinder d 2 0 -3 1 1 0 0.5 0.5 red\n";
+
+  render::CompiledScene compile_text() {
+    std::string err;
+    auto const scn = render::try_parse_scene_text(scene_text, "scene", &err);
+    EXPECT_TRUE(scn.has_value()) << err;
+    return render::CompiledScene::compile(*scn);
+  }
+
+  bool same_bytes(std::span<std::byte const> a, std::span<std::byte const> b) {
+    return a.size() == b.size() and std::equal(a.begin(), a.end(), b.begin());
+  }
+
+}  // namespace
+
+TEST(SceneCache, RoundTripIsByteIdenticalAndZeroCopy) {
+  std::string const path         = tmp_path("render_scene_cache.rsc");
+  render::CompiledScene const cs = compile_text();
+  render::Bvh const bvh          = render::Bvh::build(cs);
+  std::string err;
+  ASSERT_TRUE(render::write_scene_cache(path, 42U, cs, &bvh, &err)) << err;
+  EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+
+  auto const loaded = render::load_scene_cache(path, 42U, &err);
+  ASSERT_TRUE(loaded.has_value()) << err;
+  EXPECT_TRUE(same_bytes(loaded->scene.data(), cs.data()));
+  EXPECT_NE(loaded->scene.data().data(), cs.data().data());
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(loaded->scene.data().data()) %
+                render::CompiledScene::alignment,
+            0U);
+  EXPECT_EQ(loaded->scene.spheres().size(), 3U);
+  EXPECT_EQ(loaded->scene.cylinders().size(), 2U);
+  ASSERT_EQ(loaded->scene.materials().size(), 3U);
+  EXPECT_EQ(loaded->scene.spheres().mat[2], render::no_material);
+  EXPECT_EQ(loaded->scene.cylinders().mat[0], 1U);
+
+  ASSERT_TRUE(loaded->bvh.has_value());
+  EXPECT_TRUE(same_bytes(loaded->bvh->node_bytes(), bvh.node_bytes()));
+  EXPECT_TRUE(std::ranges::equal(loaded->bvh->prim_ids(), bvh.prim_ids()));
+
+  // La copia de la escena sigue siendo válida aunque desaparezcan el original y el fichero
+  render::CompiledScene const copy = loaded->scene;
+  std::filesystem::remove(path);
+  EXPECT_EQ(copy.spheres().radius[1], 0.5);
+}
+
+TEST(SceneCache, WithoutBvh) {
+  std::string const path         = tmp_path("render_scene_cache_nobvh.rsc");
+  render::CompiledScene const cs = compile_text();
+  std::string err;
+  ASSERT_TRUE(render::write_scene_cache(path, 1U, cs, nullptr, &err)) << err;
+  auto const loaded = render::load_scene_cache(path, 1U, &err);
+  ASSERT_TRUE(loaded.has_value()) << err;
+  EXPECT_FALSE(loaded->bvh.has_value());
+  EXPECT_TRUE(same_bytes(loaded->scene.data(), cs.data()));
+  std::filesystem::remove(path);
+}
+
+TEST(SceneCache, RejectsStaleAndBrokenFiles) {
+  std::string const path         = tmp_path("render_scene_cache_bad.rsc");
+  render::CompiledScene const cs = compile_text();
+  render::Bvh const bvh          = render::Bvh::build(cs);
+  std::string err;
+  ASSERT_TRUE(render::write_scene_cache(path, 7U, cs, &bvh, &err)) << err;
+
+  EXPECT_FALSE(render::load_scene_cache(path, 8U, &err));
+  EXPECT_EQ(err, "Error: scene cache '" + path + "' is stale");
+
+  auto const size = std::filesystem::file_size(path);
+  std::filesystem::resize_file(path, size - 4U);
+  EXPECT_FALSE(render::load_scene_cache(path, 7U, &err));
+  EXPECT_EQ(err, "Error: scene cache '" + path + "' is truncated");
+
+  // Índice de primitiva fuera de rango en el BVH
+  ASSERT_TRUE(render::write_scene_cache(path, 7U, cs, &bvh, &err)) << err;
+  {
+    std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+    f.seekp(static_cast<std::streamoff>(size - 4U));
+    std::uint32_t const bad = 1000U;
+    f.write(reinterpret_cast<char const *>(&bad), sizeof bad);
+  }
+  EXPECT_FALSE(render::load_scene_cache(path, 7U, &err));
+  EXPECT_EQ(err, "Error: scene cache '" + path + "' is corrupt");
+
+  write_text("render_scene_cache_bad.rsc", scene_text);
+  EXPECT_FALSE(render::load_scene_cache(path, 7U, &err));
+  EXPECT_EQ(err, "Error: '" + path + "' is not a scene cache");
+
+  EXPECT_FALSE(render::load_scene_cache(tmp_path("render_no_such.rsc"), 7U, &err));
+  std::filesystem::remove(path);
+}
+
+// Dos nodos interiores con los mismos hijos: en rango y poco profundo, pero no es un árbol
+TEST(SceneCache, BvhFromBytesRejectsSharedChildren) {
+  render::Bvh const bvh = render::Bvh::build(compile_text());
+  std::vector<std::byte> nodes(5U * render::Bvh::node_size);
+  // Caja de la raíz construida; first, count y spheres van justo detrás
+  auto set = [&](std::size_t i, std::uint32_t first, std::uint32_t count, std::uint32_t sph) {
+    std::array<std::uint32_t, 3> const f{first, count, sph};
+    std::byte * const node = nodes.data() + i * render::Bvh::node_size;
+    std::memcpy(node, bvh.node_bytes().data(), render::Bvh::node_size);
+    std::memcpy(node + sizeof(render::Aabb), f.data(), sizeof f);
+  };
+  std::array<std::uint32_t, 5> const ids{0U, 1U, 2U, 0U, 1U};  // 3 esferas, 2 cilindros
+  set(0, 1U, 0U, 0U);
+  set(1, 3U, 0U, 0U);
+  set(2, 3U, 0U, 0U);
+  set(3, 0U, 3U, 3U);
+  set(4, 3U, 2U, 0U);
+  EXPECT_FALSE(render::Bvh::from_bytes(nodes, ids, 3U, 2U).has_value());
+
+  // El mismo árbol con el nodo 2 como hoja sí se acepta
+  set(2, 0U, 1U, 1U);
+  EXPECT_TRUE(render::Bvh::from_bytes(nodes, ids, 3U, 2U).has_value());
+}
+
+TEST(SceneCache, LoadSceneWritesThenReusesThenRefreshes) {
+  std::string const src   = write_text("render_cached_scene.txt", scene_text);
+  std::string const cache = tmp_path("render_cached_scene.rsc");
+  std::filesystem::remove(cache);
+
+  std::string err, note;
+  auto const first = render::load_scene(src, cache, false, &err, &note);
+  ASSERT_TRUE(first.has_value()) << err;
+  EXPECT_FALSE(first->from_cache);
+  EXPECT_EQ(note, "scene cache: wrote '" + cache + "'");
+  EXPECT_EQ(first->source_hash, render::hash_file(src));
+
+  auto const second = render::load_scene(src, cache, false, &err, &note);
+  ASSERT_TRUE(second.has_value()) << err;
+  EXPECT_TRUE(second->from_cache);
+  EXPECT_EQ(note, "scene cache: loaded '" + cache + "'");
+  EXPECT_TRUE(same_bytes(second->scene.data(), first->scene.data()));
+  EXPECT_EQ(second->bvh.node_count(), first->bvh.node_count());
+
+  // El texto cambia: la caché no vale y se reescribe
+  write_text("render_cached_scene.txt", scene_text + "sphere e 5 5 5 1 red\n");
+  auto const third = render::load_scene(src, cache, false, &err, &note);
+  ASSERT_TRUE(third.has_value()) << err;
+  EXPECT_FALSE(third->from_cache);
+  EXPECT_EQ(third->scene.spheres().size(), 4U);
+  EXPECT_TRUE(render::load_scene(src, cache, false, &err, &note)->from_cache);
+
+  // Un error del parser sigue siendo un error
+  write_text("render_cached_scene.txt", "sphere x 0 0 0 1 red\n");
+  EXPECT_FALSE(render::load_scene(src, cache, false, &err, &note).has_value());
+  EXPECT_EQ(err, "Error: object declared before materials in " + src + ":1");
+
+  // Sin ruta de caché no se escribe nada
+  std::filesystem::remove(cache);
+  write_text("render_cached_scene.txt", scene_text);
+  note.clear();
+  auto const plain = render::load_scene(src, "", false, &err, &note);
+  ASSERT_TRUE(plain.has_value()) << err;
+  EXPECT_FALSE(plain->from_cache);
+  EXPECT_EQ(plain->source_hash, 0U);  // nadie lo necesita: no se calcula
+  EXPECT_TRUE(note.empty());
+  EXPECT_FALSE(std::filesystem::exists(cache));
+  EXPECT_EQ(render::load_scene(src, "", true, &err, &note)->source_hash, render::hash_file(src));
+  EXPECT_FALSE(render::load_scene(tmp_path("render_no_such.txt"), "", true, &err, &note));
+  EXPECT_EQ(err, "Error: cannot open file '" + tmp_path("render_no_such.txt") + "'");
+  std::filesystem::remove(src);
+}
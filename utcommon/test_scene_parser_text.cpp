@@ -0,0 +1,252 @@
+#include "render/mapped_file.hpp"
+#include "render/parser.hpp"
+#include "render/scene.hpp"
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+  std::string write_scene(std::string const & text,
+                          char const * name = "render_scene_text.txt") {
+    auto const p = std::filesystem::temp_directory_path() / name;
+    std::ofstream f(p, std::ios::binary);
+    f << text;
+    return p.string();
+  }
+
+  void expect_same_vec(render::Vec3 const & a, render::Vec3 const & b) {
+    EXPECT_EQ(a.x, b.x);
+    EXPECT_EQ(a.y, b.y);
+    EXPECT_EQ(a.z, b.z);
+  }
+
+  // El parser de render (mmap + string_view) y el de referencia (streams) dan lo mismo:
+  // la misma escena o el mismo mensaje de error. Con threads > 0 se prueba el paralelo
+  // troceando siempre, por pequeño que sea el texto.
+  void expect_same_as_stream(std::string const & text, unsigned threads = 0) {
+    SCOPED_TRACE(text.substr(0, 200));
+    std::string const path = write_scene(text);
+    std::string err_fast, err_ref;
+    auto const fast = (threads == 0U)
+                        ? render::try_parse_scene(path, &err_fast)
+                        : render::try_parse_scene_text_parallel(text, path, &err_fast, threads, 0);
+    auto const ref  = render::try_parse_scene_stream(path, &err_ref);
+    ASSERT_EQ(fast.has_value(), ref.has_value()) << err_fast << " | " << err_ref;
+    EXPECT_EQ(err_fast, err_ref);
+    if (!ref) {
+      return;
+    }
+    ASSERT_EQ(fast->materials.size(), ref->materials.size());
+    for (std::size_t i = 0; i < ref->materials.size(); ++i) {
+      EXPECT_EQ(fast->materials[i].name, ref->materials[i].name);
+      EXPECT_EQ(fast->materials[i].kind, ref->materials[i].kind);
+      expect_same_vec(fast->materials[i].color, ref->materials[i].color);
+      EXPECT_EQ(fast->materials[i].fuzz, ref->materials[i].fuzz);
+      EXPECT_EQ(fast->materials[i].ior, ref->materials[i].ior);
+    }
+    ASSERT_EQ(fast->spheres.size(), ref->spheres.size());
+    for (std::size_t i = 0; i < ref->spheres.size(); ++i) {
+      EXPECT_EQ(fast->sphere_name(i), ref->sphere_name(i));
+      expect_same_vec(fast->spheres[i].center, ref->spheres[i].center);
+      EXPECT_EQ(fast->spheres[i].radius, ref->spheres[i].radius);
+      EXPECT_EQ(fast->spheres[i].mat, ref->spheres[i].mat);
+    }
+    ASSERT_EQ(fast->cylinders.size(), ref->cylinders.size());
+    for (std::size_t i = 0; i < ref->cylinders.size(); ++i) {
+      EXPECT_EQ(fast->cylinder_name(i), ref->cylinder_name(i));
+      expect_same_vec(fast->cylinders[i].base, ref->cylinders[i].base);
+      expect_same_vec(fast->cylinders[i].axis, ref->cylinders[i].axis);
+      EXPECT_EQ(fast->cylinders[i].height, ref->cylinders[i].height);
+      EXPECT_EQ(fast->cylinders[i].radius, ref->cylinders[i].radius);
+      EXPECT_EQ(fast->cylinders[i].mat, ref->cylinders[i].mat);
+    }
+  }
+
+  std::string const materials = "matte red color 0.8 0.2 0.2\n"
+                                "metal steel color=0.8,0.8,0.9 fuzz=0.2\n"
+                                "refractive glass ior 1.5\n";
+
+}  // namespace
+
+TEST(SceneParserText, ValidScenesMatchStreamParser) {
+  expect_same_as_stream("");
+  expect_same_as_stream("\n\n# solo comentarios\n   \n");
+  expect_same_as_stream("\xEF\xBB\xBF" + materials + "sphere a 0 0 -1 0.5 red\n");
+  expect_same_as_stream(materials +
+                        "sphere a center=0,1,2 radius=0.5 mat=steel\n"
+                        "sphere b +1 -2.5e1 .5 1. glass   # comentario\n"
+                        "\tsphere 0 0 0 1\r\n"
+                        "cylinder c 0 0 0 0 3 0 2 0.25 red\n"
+                        "cylinder d 1e-400 0 0 0 0 -1 1 1 steel");
+  expect_same_as_stream("material matte m color 1,0.5,0\n"
+                        "material metal n color 0.1 0.2 0.3 fuzz 1\n"
+                        "matte o color 0.5 0.5 0.5color\n"  // 'color' pegado: clave desconocida
+                        "sphere s 0 0 0 1 m\n");
+}
+
+TEST(SceneParserText, ErrorsMatchStreamParser) {
+  for (std::string const & bad : std::vector<std::string>{
+         "sphere a 0 0 0 1 red\n",
+         materials + "sphere a 0 0 0 1 red\nmatte late\n",
+         "matte\n",
+         "material matte\n",
+         "material plastic p\n",
+         "matte m\nmatte m\n",
+         "matte m color 1 2\n",
+         "matte m color\n",
+         "matte m color=1,2\n",
+         "matte m fuzz=0.1\n",
+         "metal m fuzz\n",
+         "metal m fuzz 1.5\n",
+         "metal m fuzz=x\n",
+         "metal m fuzz 0.5x\n",
+         "refractive g ior 1\n",
+         "refractive g ior=abc\n",
+         "refractive g color 1 1 1\n",
+         materials + "sphere\n",
+         materials + "sphere a center=0,0 radius=1 mat=red\n",
+         materials + "sphere a center=0,0,0 radius=0 mat=red\n",
+         materials + "sphere a center=0,0,0 radius=1 mat=blue\n",
+         materials + "sphere a center=0,0,0 radius=1\n",
+         materials + "sphere a center=0,0,0 radius=1 mat=red size=2\n",
+         materials + "sphere a 0 0 0 1 red\nsphere a 0 0 0 1 red\n",
+         materials + "sphere a 0 0 0 1 red extra\n",
+         materials + "sphere a 0 0 0 -1 red\n",
+         materials + "sphere a 0 0 zero 1 red\n",
+         materials + "sphere a 0 0 0 1e999 red\n",
+         materials + "sphere a 0 0 0 1e red\n",
+         materials + "sphere a 0 0 0 1\n",
+         materials + "sphere a 0 0 0 1 blue\n",
+         materials + "sphere 0 0\n",
+         materials + "sphere 0 0 0 -2\n",
+         materials + "cylinder\n",
+         materials + "cylinder c 0 0 0 0 1 0 1\n",
+         materials + "cylinder c 0 0 0 0 1 0 0 1 red\n",
+         materials + "cylinder c 0 0 0 0 0 0 1 1 red\n",
+         materials + "cylinder c 0 0 0 0 1 0 1 1\n",
+         materials + "cylinder c 0 0 0 0 1 0 1 1 blue\n",
+         materials + "cylinder c 0 0 0 0 1 0 1 1 red more\n",
+         materials + "cylinder c 0 0 0 0 1 0 1 1 red\ncylinder c 0 0 0 0 1 0 1 1 red\n",
+         materials + "cone k 0 0 0\n",
+       }) {
+    expect_same_as_stream(bad);
+    expect_same_as_stream(bad, 4);
+  }
+}
+
+namespace {
+
+  // Escena grande con esferas (las dos sintaxis y la antigua sin nombre), cilindros,
+  // comentarios y líneas en blanco, para que los trozos corten en sitios variados
+  std::string big_scene(int objects) {
+    std::string text = materials;
+    for (int i = 0; i < objects; ++i) {
+      std::string const n = std::to_string(i);
+      switch (i % 5) {
+        case 0:
+          text += "sphere s" + n + " " + n + " 0 -1 0.5 red\n";
+          break;
+        case 1:
+          text += "sphere t" + n + " center=0," + n + ",2 radius=0.25 mat=glass # c\n";
+          break;
+        case 2:
+          text += "sphere 0 0 " + n + " 1\n";
+          break;
+        case 3:
+          text += "cylinder c" + n + " 0 0 0 0 1 0 " + n + ".5 0.25 steel\n";
+          break;
+        default:
+          text += "\n# comentario " + n + "\n";
+          break;
+      }
+    }
+    return text;
+  }
+
+}  // namespace
+
+TEST(SceneParserText, ParallelMatchesStreamParser) {
+  std::string const text = big_scene(2000);
+  for (unsigned const threads : {2U, 3U, 8U}) {
+    expect_same_as_stream(text, threads);
+  }
+  // Por debajo del umbral es el secuencial tal cual
+  std::string err;
+  auto const scn = render::try_parse_scene_text_parallel(text, "big", &err, 8);
+  ASSERT_TRUE(scn.has_value()) << err;
+  EXPECT_EQ(scn->spheres.size(), 1200U);
+  EXPECT_EQ(scn->cylinders.size(), 400U);
+}
+
+TEST(SceneParserText, ParallelReportsFirstError) {
+  std::string const text = big_scene(2000);
+  for (std::string const & bad : std::vector<std::string>{
+         text + "sphere late 0 0 0 -1 red\n",                     // error en el último trozo
+         text + "matte late\n",                                   // material tras los objetos
+         text + "sphere s0 0 0 0 1 red\n",                        // repetido con el primero
+         text + "cylinder c1998 0 0 0 0 1 0 1 1 red\n",           // repetido entre trozos
+         text + "sphere u 0 0 0 1 blue\n" + text.substr(materials.size()),  // dos errores
+         big_scene(1000) + "sphere x 0 0 0 1 red extra\n" + big_scene(1000),
+       }) {
+    expect_same_as_stream(bad, 4);
+  }
+}
+
+TEST(SceneParserText, NamesAreInternedHandles) {
+  std::string err;
+  auto const scn = render::try_parse_scene_text(materials +
+                                                    "sphere a 0 0 -1 0.5 glass\n"
+                                                    "sphere 1 2 3 4\n"
+                                                    "cylinder a 0 0 0 0 1 0 1 1 steel\n",
+                                                "scene", &err);
+  ASSERT_TRUE(scn.has_value()) << err;
+  ASSERT_EQ(scn->spheres.size(), 2U);
+  EXPECT_EQ(scn->spheres[0].mat, 2U);
+  EXPECT_EQ(scn->spheres[1].mat, render::no_material);
+  EXPECT_EQ(scn->cylinders[0].mat, 1U);
+  EXPECT_EQ(scn->material_name(scn->spheres[0].mat), "glass");
+  EXPECT_EQ(scn->material_name(render::no_material), "");
+
+  // Solo los objetos con nombre ocupan la tabla; el de la esfera legacy sale de su línea
+  EXPECT_EQ(scn->names.size(), 2U);
+  EXPECT_EQ(scn->sphere_name(0), "a");
+  EXPECT_EQ(scn->sphere_name(1), "__legacy5");
+  EXPECT_EQ(scn->cylinder_name(0), "a");
+}
+
+TEST(SceneParserText, NameTableAppend) {
+  render::NameTable a, b;
+  EXPECT_EQ(a.add("uno"), 0U);
+  EXPECT_EQ(a.add(""), 1U);
+  EXPECT_EQ(b.add("dos"), 0U);
+  EXPECT_EQ(b.add("tres"), 1U);
+  EXPECT_EQ(a.append(b), 2U);
+  ASSERT_EQ(a.size(), 4U);
+  EXPECT_EQ(a[0], "uno");
+  EXPECT_EQ(a[1], "");
+  EXPECT_EQ(a[2], "dos");
+  EXPECT_EQ(a[3], "tres");
+}
+
+TEST(SceneParserText, MissingFileMessage) {
+  std::string err;
+  EXPECT_FALSE(render::try_parse_scene("/nonexistent/dir/scene.txt", &err));
+  EXPECT_EQ(err, "Error: cannot open file '/nonexistent/dir/scene.txt'");
+}
+
+TEST(SceneParserText, MappedFileViewsTheBytes) {
+  std::string const path = write_scene("matte m\n");
+  auto const f           = render::MappedFile::open(path);
+  ASSERT_TRUE(f.has_value());
+  EXPECT_TRUE(f->mapped());
+  EXPECT_EQ(f->text(), "matte m\n");
+
+  auto const empty = render::MappedFile::open(write_scene("", "render_scene_empty.txt"));
+  ASSERT_TRUE(empty.has_value());
+  EXPECT_EQ(empty->size(), 0U);
+  EXPECT_FALSE(render::MappedFile::open("/nonexistent/file").has_value());
+}
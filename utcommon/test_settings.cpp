@@ -0,0 +1,277 @@
+#include "render/compiled_scene.hpp"
+#include "render/config.hpp"
+#include "render/kernel.hpp"
+#include "render/rng.hpp"
+#include "render/scene.hpp"
+#include "render/settings.hpp"
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+
+namespace {
+
+  // Entorno falso para los tests
+  render::EnvLookup fake_env(std::map<std::string, std::string> const & vars) {
+    return [vars](char const * k) -> char const * {
+      auto it = vars.find(k);
+      return (it == vars.end()) ? nullptr : it->second.c_str();
+    };
+  }
+
+  render::Config sample_config() {
+    render::Config cfg;
+    cfg.width             = 64;
+    cfg.height            = 32;
+    cfg.vertical_fov_deg  = 50.0;
+    cfg.lookfrom          = {1, 2, 3};
+    cfg.samples_per_pixel = 3;
+    cfg.seed              = 77;
+    cfg.gamma             = 1.8;
+    cfg.max_depth         = 7;
+    cfg.rr_depth          = 2;
+    return cfg;
+  }
+
+}  // namespace
+
+TEST(RenderSettings, ComesFromConfigWithoutEnv) {
+  auto const s = render::resolve_settings(sample_config(), fake_env({}));
+  EXPECT_EQ(s.width, 64U);
+  EXPECT_EQ(s.height, 32U);
+  EXPECT_EQ(s.vfov_deg, 50.0);
+  EXPECT_EQ(s.lookfrom.z, 3.0);
+  EXPECT_EQ(s.spp, 3U);
+  EXPECT_EQ(s.seed, 77U);
+  EXPECT_EQ(s.gamma, 1.8);
+  EXPECT_EQ(s.max_depth, 7);
+  EXPECT_EQ(s.rr_depth, 2);
+  EXPECT_EQ(s.tiles.tile_size, 32);
+  EXPECT_EQ(s.tiles.threads, 0U);
+  EXPECT_EQ(s.format, render::PpmFormat::P3);
+  EXPECT_EQ(s.lens(), render::Lens::Pinhole);
+}
+
+TEST(RenderSettings, EnvOverridesConfig) {
+  auto const s = render::resolve_settings(sample_config(), fake_env({
+                                                                {"RENDER_VFOV", "30"},
+                                                                {"RENDER_FROM", "4,5,6"},
+                                                                {"RENDER_SPP", "1"},
+                                                                {"RENDER_SEED", "9"},
+                                                                {"RENDER_APERTURE", "0.1"},
+                                                                {"RENDER_TILE", "16"},
+                                                                {"RENDER_THREADS", "3"},
+                                                                {"RENDER_PPM_FORMAT", "P6"},
+                                                                {"RENDER_SAMPLER", "r2"},
+  }));
+  EXPECT_EQ(s.vfov_deg, 30.0);
+  EXPECT_EQ(s.lookfrom.x, 4.0);
+  EXPECT_EQ(s.lookfrom.z, 6.0);
+  EXPECT_EQ(s.spp, 1U);
+  EXPECT_EQ(s.seed, 9U);
+  EXPECT_EQ(s.tiles.tile_size, 16);
+  EXPECT_EQ(s.tiles.threads, 3U);
+  EXPECT_EQ(s.format, render::PpmFormat::P6);
+  EXPECT_EQ(s.sampler, render::SamplerKind::R2);
+  EXPECT_EQ(s.lens(), render::Lens::Thin);
+}
+
+TEST(RenderSettings, NonPositiveIntegersAreIgnored) {
+  auto const s = render::resolve_settings(sample_config(),
+                                          fake_env({
+                                              {"RENDER_SPP",         "0" },
+                                              {"RENDER_TILE",        "-4"},
+                                              {"RENDER_SEED",        "abc"},
+                                              {"RENDER_STREAM_ROWS", "-1"}
+  }));
+  EXPECT_EQ(s.spp, 3U);
+  EXPECT_EQ(s.tiles.tile_size, 32);
+  EXPECT_EQ(s.seed, 77U);
+  EXPECT_EQ(s.stream_rows, 0);
+}
+
+TEST(RenderSettings, AdaptiveBounds) {
+  auto cfg               = sample_config();
+  cfg.samples_per_pixel  = 64;
+  cfg.adaptive_threshold = 0.05;
+  cfg.min_samples        = 1;  // sin 2 muestras no hay varianza
+  auto s                 = render::resolve_settings(cfg, fake_env({}));
+  EXPECT_EQ(s.min_spp, 2U);
+  EXPECT_TRUE(s.adaptive());
+
+  s = render::resolve_settings(cfg, fake_env({
+                                        {"RENDER_MIN_SPP",   "100"         },
+                                        {"RENDER_SPP_IMAGE", "/tmp/spp.ppm"}
+  }));
+  EXPECT_EQ(s.min_spp, 64U);  // recortado al máximo
+  EXPECT_FALSE(s.adaptive());  // min == max: no hay nada que decidir
+  EXPECT_EQ(s.spp_image, "/tmp/spp.ppm");
+
+  s = render::resolve_settings(cfg, fake_env({
+                                        {"RENDER_ADAPTIVE", "0"}
+  }));
+  EXPECT_FALSE(s.adaptive());
+}
+
+TEST(RenderSettings, Progressive) {
+  auto cfg = sample_config();
+  EXPECT_FALSE(render::resolve_settings(cfg, fake_env({})).progressive());
+  cfg.time_budget = 1.5;
+  auto s          = render::resolve_settings(cfg, fake_env({}));
+  EXPECT_TRUE(s.progressive());
+  EXPECT_EQ(s.time_budget, 1.5);
+  EXPECT_TRUE(s.preview_path.empty());
+
+  s = render::resolve_settings(sample_config(), fake_env({
+                                                    {"RENDER_PREVIEW_EVERY", "0.25"        },
+                                                    {"RENDER_PREVIEW",       "/tmp/prev.ppm"}
+  }));
+  EXPECT_TRUE(s.progressive());
+  EXPECT_EQ(s.preview_interval, 0.25);
+  EXPECT_EQ(s.preview_path, "/tmp/prev.ppm");
+
+  s = render::resolve_settings(sample_config(), fake_env({
+                                                    {"RENDER_CHECKPOINT_EVERY", "30"       },
+                                                    {"RENDER_CHECKPOINT",       "/tmp/r.ck"}
+  }));
+  EXPECT_TRUE(s.progressive());
+  EXPECT_EQ(s.checkpoint_interval, 30.0);
+  EXPECT_EQ(s.checkpoint_path, "/tmp/r.ck");
+  EXPECT_TRUE(s.scene_cache.empty());
+
+  s = render::resolve_settings(sample_config(), fake_env({
+                                                    {"RENDER_SCENE_CACHE", "/tmp/s.rsc"},
+                                                    {"RENDER_STREAM_ROWS", "8"         }
+  }));
+  EXPECT_FALSE(s.progressive());
+  EXPECT_EQ(s.scene_cache, "/tmp/s.rsc");
+  EXPECT_EQ(s.stream_rows, 8);
+}
+
+// Las especializaciones del kernel dan lo mismo que la versión genérica
+TEST(RenderKernel, SpecializationsMatchGenericPath) {
+  render::Scene scn;
+  render::Sphere sp;
+  sp.center = {0, 0, 0};
+  sp.radius = 1.0;
+  scn.spheres.push_back(sp);
+  auto const cs  = render::CompiledScene::compile(scn);
+  auto const bvh = render::Bvh::build(cs);
+
+  for (double const aperture : {0.0, 0.2}) {
+    auto cfg     = sample_config();
+    cfg.lookfrom = {0, 0, 5};
+    cfg.aperture = aperture;
+    cfg.focus_dist = 5.0;
+    auto const s   = render::resolve_settings(cfg, fake_env({}));
+    auto const cam = s.make_camera();
+    for (int y = 0; y < 32; y += 5) {
+      for (int x = 0; x < 64; x += 7) {
+        render::vector many, one;
+        std::uint32_t n1 = 0, n2 = 0;
+        render::with_kernel(s, [&]<class K>(K) {
+          n1 = render::trace_pixel<K::lens, render::SampleMode::Fixed>(cam, cs, bvh, s, x, y, many);
+          n2 = render::trace_pixel<K::lens, render::SampleMode::One>(cam, cs, bvh, s, x, y, one);
+        });
+        EXPECT_EQ(n1, 3U);
+        EXPECT_EQ(n2, 1U);
+
+        // Referencia: get_ray genérico y suma a mano
+        auto const px = static_cast<std::uint32_t>(x);
+        auto const py = static_cast<std::uint32_t>(y);
+        auto path     = [&](std::uint32_t i) {
+          render::PathSampler const ps{
+            render::counter_rng{s.seed ^ render::path_stream, px, py, i},
+            s.sampler, render::PixelKey{s.seed, px, py, cam.strata()},
+            i
+          };
+          render::ray const r = cam.get_ray(px, py, i);
+          return render::trace_path(r, cs, bvh, s.max_depth, s.rr_depth, ps).color;
+        };
+        render::vector ref;
+        for (std::uint32_t i = 0; i < 3; ++i) {
+          ref = ref + path(i);
+        }
+        EXPECT_EQ(many.x, ref.x);
+        EXPECT_EQ(many.y, ref.y);
+        EXPECT_EQ(many.z, ref.z);
+        auto const first = path(0);
+        EXPECT_EQ(one.x, first.x);
+        EXPECT_EQ(one.z, first.z);
+      }
+    }
+  }
+}
+
+namespace {
+
+  struct AdaptiveFixture {
+    render::CompiledScene cs;
+    render::Bvh bvh;
+    render::RenderSettings s;
+    render::camera cam;
+
+    explicit AdaptiveFixture(render::Scene const & scn)
+        : cs(render::CompiledScene::compile(scn)), bvh(render::Bvh::build(cs)),
+          s(make_settings()), cam(s.make_camera()) { }
+
+    static render::RenderSettings make_settings() {
+      auto cfg               = sample_config();
+      cfg.lookfrom           = {0, 0, 3};
+      cfg.samples_per_pixel  = 64;
+      cfg.min_samples        = 4;
+      cfg.adaptive_threshold = 0.02;
+      return render::resolve_settings(cfg, fake_env({}));
+    }
+  };
+
+}  // namespace
+
+// Cielo sin nada: el ruido es casi nulo y todos los píxeles paran en el mínimo
+TEST(RenderKernel, AdaptiveStopsAtMinimumOnFlatSky) {
+  AdaptiveFixture const f{render::Scene{}};
+  for (int x = 0; x < 64; x += 9) {
+    render::vector sum;
+    auto const n = render::trace_pixel<render::Lens::Pinhole, render::SampleMode::Adaptive>(
+        f.cam, f.cs, f.bvh, f.s, x, 10, sum);
+    EXPECT_EQ(n, f.s.min_spp);
+  }
+}
+
+// Las n muestras del adaptativo son las n primeras del modo fijo; un umbral imposible
+// gasta el máximo
+TEST(RenderKernel, AdaptiveUsesPrefixOfFixedSamples) {
+  render::Scene scn;
+  render::Material m;
+  m.name = "m";
+  scn.materials.push_back(m);
+  render::Sphere sp;
+  sp.radius = 1.0;
+  sp.mat    = 0;
+  scn.spheres.push_back(sp);
+  AdaptiveFixture f{scn};
+
+  bool some_early = false;
+  for (int x = 20; x < 44; x += 3) {
+    render::vector adaptive, fixed;
+    auto const n = render::trace_pixel<render::Lens::Pinhole, render::SampleMode::Adaptive>(
+        f.cam, f.cs, f.bvh, f.s, x, 16, adaptive);
+    ASSERT_GE(n, f.s.min_spp);
+    ASSERT_LE(n, f.s.spp);
+    some_early = some_early or (n < f.s.spp);
+
+    auto s = f.s;
+    s.spp  = n;
+    (void) render::trace_pixel<render::Lens::Pinhole, render::SampleMode::Fixed>(
+        f.cam, f.cs, f.bvh, s, x, 16, fixed);
+    EXPECT_EQ(adaptive.x, fixed.x);
+    EXPECT_EQ(adaptive.y, fixed.y);
+    EXPECT_EQ(adaptive.z, fixed.z);
+  }
+  EXPECT_TRUE(some_early);
+
+  f.s.adaptive_threshold = 1e-12;
+  render::vector sum;
+  EXPECT_EQ((render::trace_pixel<render::Lens::Pinhole, render::SampleMode::Adaptive>(
+                f.cam, f.cs, f.bvh, f.s, 32, 16, sum)),
+            f.s.spp);
+}
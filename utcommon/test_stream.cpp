@@ -0,0 +1,184 @@
+#include "render/ppm.hpp"
+#include "render/spsc_queue.hpp"
+#include "render/stream.hpp"
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+  std::string tmp_path(char const * name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+  }
+
+  std::string read_all(std::string const & path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  }
+
+  // Byte de prueba del canal c del píxel (x, y)
+  std::uint8_t value(int x, int y, int c) {
+    return static_cast<std::uint8_t>(31 * y + 7 * x + c);
+  }
+
+  void fill(int width, int y0, int y1, std::span<std::uint8_t> rgb) {
+    std::size_t i = 0;
+    for (int y = y0; y < y1; ++y) {
+      for (int x = 0; x < width; ++x) {
+        for (int c = 0; c < 3; ++c) {
+          rgb[i++] = value(x, y, c);
+        }
+      }
+    }
+  }
+
+}  // namespace
+
+// Las bandas terminan desordenadas (las primeras son las más lentas) pero llegan en orden, y
+// nunca hay más de 'window' en vuelo
+TEST(RenderBands, EmitsInOrderWithBoundedWindow) {
+  int const W = 5, H = 37;
+  std::vector<std::uint8_t> got;
+  render::BandStats stats;
+  bool const ok = render::render_bands(
+      W, H, {4, 4, 3},
+      [&](int y0, int y1, std::span<std::uint8_t> rgb) {
+        ASSERT_EQ(rgb.size(), static_cast<std::size_t>((y1 - y0) * W * 3));
+        std::this_thread::sleep_for(std::chrono::microseconds(2000 / (1 + y0)));
+        fill(W, y0, y1, rgb);
+      },
+      [&](std::span<std::uint8_t const> rgb) {
+        got.insert(got.end(), rgb.begin(), rgb.end());
+        return true;
+      },
+      &stats);
+  ASSERT_TRUE(ok);
+
+  std::vector<std::uint8_t> expected(static_cast<std::size_t>(W * H * 3));
+  fill(W, 0, H, expected);
+  EXPECT_EQ(got, expected);
+  EXPECT_EQ(stats.bands, 10U);
+  EXPECT_EQ(stats.window, 4U);  // nunca menos que hilos
+  EXPECT_LE(stats.max_pending, stats.window);
+  EXPECT_EQ(stats.buffer_bytes, 4U * 4U * W * 3U);
+}
+
+TEST(RenderBands, SingleThreadAndDegenerateSizes) {
+  std::size_t calls = 0;
+  render::BandStats stats;
+  EXPECT_TRUE(render::render_bands(
+      3, 2, {16, 1, 0}, [&](int y0, int y1, std::span<std::uint8_t> rgb) { fill(3, y0, y1, rgb); },
+      [&](std::span<std::uint8_t const> rgb) {
+        ++calls;
+        return rgb.size() == 18U;
+      },
+      &stats));
+  EXPECT_EQ(calls, 1U);
+  EXPECT_EQ(stats.max_pending, 1U);
+
+  auto never = [](int, int, std::span<std::uint8_t>) { FAIL(); };
+  auto sink  = [](std::span<std::uint8_t const>) { return true; };
+  EXPECT_TRUE(render::render_bands(0, 0, {}, never, sink));
+  EXPECT_FALSE(render::render_bands(-1, 4, {}, never, sink));
+}
+
+// La escritura de una banda va en su propio hilo, a la vez que el render de las siguientes
+TEST(RenderBands, WriterOverlapsRendering) {
+  render::BandStats stats;
+  ASSERT_TRUE(render::render_bands(
+      2, 8, {1, 1, 4},
+      [](int, int, std::span<std::uint8_t>) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(3));
+      },
+      [](std::span<std::uint8_t const>) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return true;
+      },
+      &stats));
+  EXPECT_GE(stats.write_seconds, 0.008);
+  EXPECT_GT(stats.write_overlap, 0.0);
+  EXPECT_LE(stats.write_overlap, stats.write_seconds);
+  // Un solo hilo de render y aun así el total no es la suma de render + escritura
+  EXPECT_LT(stats.seconds, 0.024 + stats.write_seconds);
+}
+
+TEST(RenderBands, StopsWhenEmitFails) {
+  std::size_t emitted = 0;
+  bool const ok       = render::render_bands(
+      4, 100, {2, 3, 0}, [](int y0, int y1, std::span<std::uint8_t> rgb) { fill(4, y0, y1, rgb); },
+      [&](std::span<std::uint8_t const>) { return ++emitted < 3U; });
+  EXPECT_FALSE(ok);
+  EXPECT_EQ(emitted, 3U);
+}
+
+// Fila a fila o a trozos, el fichero es el de write_ppm con la imagen completa
+TEST(PpmStreamWriter, MatchesWholeImageWrite) {
+  int const W = 4, H = 6;
+  std::vector<std::uint8_t> rgb(static_cast<std::size_t>(W * H * 3));
+  fill(W, 0, H, rgb);
+  std::string const whole    = tmp_path("render_stream_whole.ppm");
+  std::string const streamed = tmp_path("render_stream_rows.ppm");
+  std::span<std::uint8_t const> const all{rgb};
+  std::size_t const row = 3U * W;
+
+  for (auto const format : {render::PpmFormat::P3, render::PpmFormat::P6}) {
+    ASSERT_TRUE(render::write_ppm(whole, W, H, all, format));
+    render::PpmStreamWriter out(streamed, W, H, format);
+    ASSERT_TRUE(out.ok());
+    EXPECT_TRUE(out.write_rows(all.first(row)));
+    EXPECT_TRUE(out.write_rows(all.subspan(row, 3 * row)));
+    EXPECT_TRUE(out.write_rows(all.subspan(4 * row)));
+    EXPECT_TRUE(out.finish());
+    EXPECT_EQ(read_all(streamed), read_all(whole));
+  }
+
+  // Filas incompletas, de más o de menos
+  render::PpmStreamWriter partial(streamed, W, H, render::PpmFormat::P6);
+  EXPECT_FALSE(partial.write_rows(all.first(row - 1)));
+  EXPECT_FALSE(partial.ok());
+  render::PpmStreamWriter too_many(streamed, W, 1, render::PpmFormat::P6);
+  EXPECT_FALSE(too_many.write_rows(all.first(2 * row)));
+  render::PpmStreamWriter short_file(streamed, W, H, render::PpmFormat::P6);
+  EXPECT_TRUE(short_file.write_rows(all.first(row)));
+  EXPECT_FALSE(short_file.finish());
+
+  EXPECT_FALSE(render::PpmStreamWriter("/nonexistent/dir/x.ppm", W, H, render::PpmFormat::P6)
+                   .ok());
+  std::filesystem::remove(whole);
+  std::filesystem::remove(streamed);
+}
+
+TEST(SpscQueue, FifoAcrossThreads) {
+  render::SpscQueue<std::size_t> q(5);
+  EXPECT_EQ(q.capacity(), 8U);
+  EXPECT_FALSE(q.try_pop().has_value());
+  for (std::size_t i = 0; i < 8; ++i) {
+    EXPECT_TRUE(q.try_push(i));
+  }
+  EXPECT_FALSE(q.try_push(8));
+  EXPECT_EQ(q.try_pop(), 0U);
+  EXPECT_EQ(q.pop(), 1U);
+  while (q.try_pop()) {
+  }
+
+  std::size_t constexpr n = 100'000;
+  std::jthread producer([&] {
+    for (std::size_t i = 0; i < n; ++i) {
+      while (!q.try_push(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+  std::size_t in_order = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    in_order += static_cast<std::size_t>(q.pop() == i);
+  }
+  EXPECT_EQ(in_order, n);
+}
@@ -0,0 +1,77 @@
+#include "render/camera.hpp"
+#include "render/tiles.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+  // "Render" sintético: cada píxel guarda la dirección de su primer rayo de cámara.
+  std::vector<double> fake_render(int W, int H, render::TileOptions const & opts) {
+    render::camera const cam{
+      static_cast<std::uint32_t>(W),
+      static_cast<std::uint32_t>(H),
+      40.0,
+      {0, 0, 1},
+      {0, 0, 0},
+      {0, 1, 0},
+      1U,
+      7ULL
+    };
+    std::vector<double> out(static_cast<std::size_t>(W) * static_cast<std::size_t>(H), -1.0);
+    render::render_tiles(W, H, opts, [&](render::Tile const & t) {
+      for (int y = t.y0; y < t.y1; ++y) {
+        for (int x = t.x0; x < t.x1; ++x) {
+          render::ray r =
+              cam.get_ray(static_cast<std::uint32_t>(x), static_cast<std::uint32_t>(y), 0);
+          out[static_cast<std::size_t>(y * W + x)] = r.direction.x + r.direction.y;
+        }
+      }
+    });
+    return out;
+  }
+
+}  // namespace
+
+TEST(Tiles, CoverImageExactlyOnce) {
+  int const W = 70, H = 33;
+  auto tiles  = render::make_tiles(W, H, 16);
+  ASSERT_EQ(tiles.size(), 5U * 3U);  // ceil(70/16) x ceil(33/16)
+
+  std::vector<int> hits(static_cast<std::size_t>(W * H), 0);
+  for (std::size_t i = 0; i < tiles.size(); ++i) {
+    auto const & t = tiles[i];
+    EXPECT_EQ(t.index, i);
+    EXPECT_LE(t.x1 - t.x0, 16);
+    EXPECT_LE(t.y1 - t.y0, 16);
+    for (int y = t.y0; y < t.y1; ++y) {
+      for (int x = t.x0; x < t.x1; ++x) {
+        ++hits[static_cast<std::size_t>(y * W + x)];
+      }
+    }
+  }
+  for (int h : hits) {
+    EXPECT_EQ(h, 1);
+  }
+}
+
+TEST(Tiles, EmptyImageHasNoTiles) {
+  EXPECT_TRUE(render::make_tiles(0, 10, 8).empty());
+  EXPECT_TRUE(render::make_tiles(10, 0, 8).empty());
+}
+
+TEST(Tiles, ThreadCountResolution) {
+  EXPECT_EQ(render::resolve_thread_count(3U), 3U);
+  EXPECT_GE(render::resolve_thread_count(0U), 1U);
+}
+
+TEST(Tiles, SameImageForAnyThreadCount) {
+  auto const ref = fake_render(61, 47, render::TileOptions{8, 1U});
+  for (unsigned n : {2U, 4U, 7U}) {
+    auto const got = fake_render(61, 47, render::TileOptions{8, n});
+    ASSERT_EQ(got.size(), ref.size());
+    for (std::size_t i = 0; i < ref.size(); ++i) {
+      ASSERT_EQ(got[i], ref[i]) << "threads=" << n << " i=" << i;
+    }
+  }
+}
@@ -1,5 +1,36 @@
+#include "render/bvh.hpp"
+#include "render/checkpoint.hpp"
+#include "render/compiled_scene.hpp"
+#include "render/config.hpp"
+#include "render/framebuffer_soa.hpp"
 #include "render/image_soa.hpp"
+#include "render/parser.hpp"
+#include "render/progressive.hpp"
+#include "render/qoi.hpp"
+#include "render/render_image.hpp"
+#include "render/settings.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <iterator>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+  std::string tmp_file(char const * name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+  }
+
+  std::string read_all(std::string const & path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  }
+
+}  // namespace
 
 TEST(image_soa_basic, set_get_u8) {
   render::ImageSOA img(4, 3);
@@ -20,3 +51,203 @@ TEST(image_soa_basic, set01_clamps) {
   EXPECT_EQ(g, 128);
   EXPECT_EQ(b, 255);
 }
+
+TEST(image_soa_basic, write_ppm_interleaves_planes) {
+  render::ImageSOA img(2, 1);
+  img.set(0, 0, 1, 2, 3);
+  img.set(1, 0, 250, 251, 252);
+  ASSERT_TRUE(render::write_ppm("/tmp/img_soa.ppm", img));
+  std::ifstream in("/tmp/img_soa.ppm", std::ios::binary);
+  std::string const s{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  EXPECT_EQ(s, std::string("P6\n2 1\n255\n\x01\x02\x03\xfa\xfb\xfc", 17));
+}
+
+TEST(image_soa_basic, framebuffer_resolves_once_with_gamma) {
+  render::FramebufferSOA fb(2, 1);
+  fb.add(0, 0, 0.0F, 0.5F, 1.0F);
+  fb.add(1, 0, -3.0F, 0.25F, 8.0F);  // HDR: el recorte lo hace resolve
+  render::ImageSOA const img = fb.resolve(render::GammaLut{2.2});
+  std::uint8_t r, g, b;
+  img.get(0, 0, r, g, b);
+  EXPECT_EQ(r, 0);
+  EXPECT_EQ(g, 186);
+  EXPECT_EQ(b, 255);
+  img.get(1, 0, r, g, b);
+  EXPECT_EQ(r, 0);
+  EXPECT_EQ(g, render::gamma_encode_exact(0.25, 2.2));
+  EXPECT_EQ(b, 255);
+}
+
+TEST(image_soa_basic, framebuffer_accumulates_sums_and_counts) {
+  render::FramebufferSOA fb(3, 2);
+  EXPECT_EQ(fb.samples(2, 1), 0);
+  fb.add(2, 1, 0.25F, 1.0F, 0.0F);
+  fb.add(2, 1, 0.75F, 3.0F, 0.5F, 3);  // suma de 3 muestras de otra pasada
+  EXPECT_EQ(fb.samples(2, 1), 4);
+  float r{}, g{}, b{};
+  fb.mean(2, 1, r, g, b);
+  EXPECT_FLOAT_EQ(r, 0.25F);
+  EXPECT_FLOAT_EQ(g, 1.0F);
+  EXPECT_FLOAT_EQ(b, 0.125F);
+  fb.mean(0, 0, r, g, b);  // sin muestras -> negro
+  EXPECT_EQ(r, 0.0F);
+  fb.clear();
+  EXPECT_EQ(fb.samples(2, 1), 0);
+}
+
+TEST(image_soa_basic, framebuffer_samples_debug_image) {
+  render::FramebufferSOA fb(3, 1);
+  fb.add(0, 0, 0.0F, 0.0F, 0.0F, 4U);
+  fb.add(1, 0, 0.0F, 0.0F, 0.0F, 8U);
+  fb.add(2, 0, 0.0F, 0.0F, 0.0F, 16U);  // por encima del máximo -> blanco
+  EXPECT_EQ(fb.total_samples(), 28U);
+  auto const img = fb.samples_image(8U);
+  EXPECT_EQ(img.R[0], 128);
+  EXPECT_EQ(img.B[0], 128);
+  EXPECT_EQ(img.G[1], 255);
+  EXPECT_EQ(img.R[2], 255);
+}
+
+// Parar a mitad, guardar, cargar en un framebuffer nuevo y seguir da los mismos bits que no
+// haber parado
+TEST(image_soa_basic, framebuffer_checkpoint_resume_is_exact) {
+  auto sample = [](int x, int y, std::uint32_t i) {
+    return render::vector{0.1 * x + 0.37 * i, 0.01 * y, 1.0 / (1.0 + i)};
+  };
+  auto ignore = [](render::ProgressiveStats const &) { };
+  render::TileOptions const tiles{8, 2};
+  std::string const path =
+      (std::filesystem::temp_directory_path() / "render_soa_resume.ckpt").string();
+
+  render::FramebufferSOA once(21, 13);
+  (void) render::render_progressive(once, tiles, {0.0, 7U}, sample, ignore, ignore);
+
+  render::FramebufferSOA first(21, 13);
+  (void) render::render_progressive(first, tiles, {0.0, 3U}, sample, ignore, ignore);
+  std::string err;
+  ASSERT_TRUE(render::save_checkpoint(path, 5U, first, &err)) << err;
+
+  render::FramebufferSOA resumed(21, 13);
+  EXPECT_FALSE(render::load_checkpoint(path, 6U, resumed, &err));
+  ASSERT_TRUE(render::load_checkpoint(path, 5U, resumed, &err)) << err;
+  EXPECT_EQ(resumed.total_samples(), first.total_samples());
+  (void) render::render_progressive(resumed, tiles, {0.0, 7U}, sample, ignore, ignore);
+  EXPECT_EQ(resumed.R, once.R);
+  EXPECT_EQ(resumed.G, once.G);
+  EXPECT_EQ(resumed.B, once.B);
+  EXPECT_EQ(resumed.N, once.N);
+  std::filesystem::remove(path);
+}
+
+// Con extensión .qoi write_image escribe QOI (intercalando los planos) y si no, PPM
+TEST(image_soa_basic, write_image_by_extension) {
+  render::ImageSOA img(3, 2);
+  img.set(0, 0, 1, 2, 3);
+  img.set(2, 1, 250, 251, 252);
+  std::string const qoi = tmp_file("render_soa_img.qoi");
+  std::string const ppm = tmp_file("render_soa_img.ppm");
+  ASSERT_TRUE(render::write_image(qoi, img));
+  ASSERT_TRUE(render::write_image(ppm, img));
+  EXPECT_EQ(read_all(ppm).substr(0, 2), "P6");
+
+  std::string const text = read_all(qoi);
+  std::vector<std::uint8_t> const bytes(text.begin(), text.end());
+  auto const back = render::decode_qoi(bytes);
+  ASSERT_TRUE(back.has_value());
+  ASSERT_EQ(back->rgb.size(), 18U);
+  for (int y = 0; y < 2; ++y) {
+    for (int x = 0; x < 3; ++x) {
+      std::uint8_t r, g, b;
+      img.get(x, y, r, g, b);
+      auto const i = static_cast<std::size_t>(3 * (y * 3 + x));
+      EXPECT_EQ(back->rgb[i], r);
+      EXPECT_EQ(back->rgb[i + 1], g);
+      EXPECT_EQ(back->rgb[i + 2], b);
+    }
+  }
+  std::filesystem::remove(qoi);
+  std::filesystem::remove(ppm);
+}
+
+// Acceso directo por planos (el que usa FramebufferSOA::resolve)
+TEST(image_soa_basic, plane_is_one_whole_channel) {
+  render::ImageSOA img(3, 2);
+  for (int c = 0; c < 3; ++c) {
+    std::span<std::uint8_t> const plane = img.plane(c);
+    ASSERT_EQ(plane.size(), 6U);
+    plane[4] = static_cast<std::uint8_t>(10 * (c + 1));
+  }
+  std::uint8_t r, g, b;
+  img.get(1, 1, r, g, b);
+  EXPECT_EQ(r, 10);
+  EXPECT_EQ(g, 20);
+  EXPECT_EQ(b, 30);
+  EXPECT_EQ(std::as_const(img).plane(2).data(), img.B.data());
+}
+
+static_assert(render::Image<render::ImageSOA>);
+static_assert(render::PlanarImage<render::ImageSOA>);
+static_assert(render::FramebufferFor<render::FramebufferSOA, render::ImageSOA>);
+
+// El kernel común instanciado con esta disposición: con pasadas o de una vez, todas las
+// muestras acaban en el framebuffer y la imagen devuelta es su resolución
+TEST(image_soa_basic, render_image_fills_framebuffer) {
+  std::string err;
+  auto const scn = render::try_parse_scene_text("matte red color 0.8 0.2 0.2\n"
+                                                "sphere a 0 0 -1 0.5 red\n",
+                                                "scene", &err);
+  ASSERT_TRUE(scn.has_value()) << err;
+  render::CompiledScene const cs = render::CompiledScene::compile(*scn);
+  render::Bvh const bvh          = render::Bvh::build(cs);
+  render::Config cfg;
+  cfg.width             = 12;
+  cfg.height            = 7;
+  cfg.samples_per_pixel = 3;
+  render::RenderSettings const settings =
+      render::resolve_settings(cfg, [](char const *) -> char const * { return nullptr; });
+  render::camera const cam = settings.make_camera();
+  render::RenderJob const job{cs, bvh, cam, settings};
+
+  int checkpoints = 0;
+  auto ignore     = [](render::ProgressiveStats const &) { };
+  auto count      = [&](render::ProgressiveStats const &) { ++checkpoints; };
+  for (bool const progressive : {false, true}) {
+    render::FramebufferSOA fb(12, 7);
+    render::ImageSOA const img =
+        render::render_image<render::ImageSOA>(fb, job, progressive, ignore, count);
+    EXPECT_EQ(fb.total_samples(), 12 * 7 * 3);
+    ASSERT_EQ(img.width, 12);
+    ASSERT_EQ(img.height, 7);
+    render::ImageSOA const ref = fb.resolve(render::GammaLut{settings.gamma});
+    for (int y = 0; y < 7; ++y) {
+      for (int x = 0; x < 12; ++x) {
+        std::uint8_t r0, g0, b0, r1, g1, b1;
+        img.get(x, y, r0, g0, b0);
+        ref.get(x, y, r1, g1, b1);
+        EXPECT_EQ(r0, r1);
+        EXPECT_EQ(g0, g1);
+        EXPECT_EQ(b0, b1);
+      }
+    }
+    if (progressive) {
+      continue;
+    }
+
+    // Por bandas, sin framebuffer: el mismo fichero
+    std::string const whole  = tmp_file("render_soa_whole.ppm");
+    std::string const banded = tmp_file("render_soa_banded.ppm");
+    ASSERT_TRUE(render::write_ppm(whole, img, settings.format));
+    render::RenderSettings streamed = settings;
+    streamed.stream_rows            = 3;
+    render::BandStats bands;
+    double samples{};
+    ASSERT_TRUE(render::render_streamed({cs, bvh, cam, streamed}, banded, &bands, &samples));
+    EXPECT_EQ(bands.bands, 3U);
+    EXPECT_EQ(samples, 12 * 7 * 3);
+    EXPECT_EQ(read_all(banded), read_all(whole));
+    std::filesystem::remove(whole);
+    std::filesystem::remove(banded);
+  }
+  // Sin plazo no hay checkpoint final
+  EXPECT_EQ(checkpoints, 0);
+}